@@ -0,0 +1,139 @@
+#include "core/ImageFilters.h"
+#include "core/PixelKernels.h"
+#include "core/TemplateMatcher.h"
+#include <QString>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <vector>
+
+/**
+ * QtDemoBench - 核心模块基准测试
+ *
+ * 用法：QtDemoBench [kernels|correlation|filters ...]，不带参数时运行全部
+ *   kernels      PixelKernels各内核在每个受支持SIMD后端上的吞吐量
+ *   correlation  1280x720全图模板搜索在空间域与频域下的耗时，以及Automatic的选择
+ *   filters      1920x1080上各滤镜原逐像素实现与扫描线实现的耗时（单线程与全部核心）
+ *
+ * 结果只打印到标准输出，数值与机器相关，不作为测试的判定条件。
+ */
+namespace {
+
+// ========== 像素内核 ==========
+
+void printKernels()
+{
+    std::printf("== PixelKernels (Mpixel/s, row length 64) ==\n");
+
+    // 按内核分行、按后端分列
+    const std::vector<PixelKernels::BenchmarkResult> results = PixelKernels::runBenchmark();
+    std::vector<PixelKernels::Backend> backends;
+    std::vector<QString> kernels;
+    std::map<std::pair<QString, int>, double> throughput;
+    for (const PixelKernels::BenchmarkResult& result : results) {
+        if (std::find(backends.begin(), backends.end(), result.backend) == backends.end()) {
+            backends.push_back(result.backend);
+        }
+        if (std::find(kernels.begin(), kernels.end(), result.kernel) == kernels.end()) {
+            kernels.push_back(result.kernel);
+        }
+        throughput[{result.kernel, static_cast<int>(result.backend)}] = result.pixelsPerSecond;
+    }
+
+    std::printf("%-18s", "kernel");
+    for (PixelKernels::Backend backend : backends) {
+        std::printf("%10s", PixelKernels::backendName(backend).toUtf8().constData());
+    }
+    std::printf("\n");
+    for (const QString& kernel : kernels) {
+        std::printf("%-18s", kernel.toUtf8().constData());
+        for (PixelKernels::Backend backend : backends) {
+            std::printf("%10.0f", throughput[{kernel, static_cast<int>(backend)}] / 1e6);
+        }
+        std::printf("\n");
+    }
+    std::printf("active backend: %s\n\n", PixelKernels::backendName(PixelKernels::activeBackend()).toUtf8().constData());
+}
+
+// ========== 互相关 ==========
+
+void printCorrelation()
+{
+    const QSize sourceSize(1280, 720);
+    std::printf("== TemplateMatcher correlation (%dx%d, full search, ms) ==\n", sourceSize.width(), sourceSize.height());
+    std::printf("%-10s%12s%12s%12s\n", "template", "spatial", "frequency", "automatic");
+
+    const std::vector<QSize> templateSizes = {QSize(8, 8), QSize(16, 16), QSize(32, 32), QSize(64, 64),
+                                              QSize(96, 96), QSize(128, 128), QSize(192, 192)};
+    for (const TemplateMatcher::CorrelationBenchmark& result :
+         TemplateMatcher::benchmarkCorrelation(sourceSize, templateSizes)) {
+        const QString size = QString("%1x%2").arg(result.templateSize.width()).arg(result.templateSize.height());
+        std::printf("%-10s%12.1f%12.1f%12s\n", size.toUtf8().constData(), result.spatialMs, result.frequencyMs,
+                    result.automaticUsesFrequency ? "frequency" : "spatial");
+    }
+    std::printf("\n");
+}
+
+// ========== 滤镜 ==========
+
+void printFilters()
+{
+    const QSize size(1920, 1080);
+    std::vector<int> threadCounts = {1};
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    if (cores > 1) {
+        threadCounts.push_back(cores);
+    }
+    for (int threads : threadCounts) {
+        std::printf("== ImageFilters (%dx%d, %d thread%s, ms) ==\n", size.width(), size.height(), threads,
+                    threads > 1 ? "s" : "");
+        std::printf("%-14s%12s%12s%10s%10s\n", "filter", "legacy", "scanline", "speedup", "maxdiff");
+        for (const ImageFilters::FilterBenchmark& result : ImageFilters::benchmarkFilters(size, threads)) {
+            const double speedup = result.scanlineMilliseconds > 0.0
+                                  ? result.legacyMilliseconds / result.scanlineMilliseconds : 0.0;
+            std::printf("%-14s%12.1f%12.2f%9.1fx%10d\n", result.filter.toUtf8().constData(), result.legacyMilliseconds,
+                        result.scanlineMilliseconds, speedup, result.maxDifference);
+        }
+        std::printf("\n");
+    }
+}
+
+struct Table {
+    const char* name;
+    void (*print)();
+};
+
+const Table Tables[] = {
+    {"kernels", printKernels},
+    {"correlation", printCorrelation},
+    {"filters", printFilters},
+};
+
+}
+
+int main(int argc, char** argv)
+{
+    int printed = 0;
+    for (const Table& table : Tables) {
+        bool selected = argc <= 1;
+        for (int i = 1; i < argc; ++i) {
+            selected = selected || std::strcmp(argv[i], table.name) == 0;
+        }
+        if (selected) {
+            table.print();
+            ++printed;
+        }
+    }
+
+    if (printed == 0) {
+        std::printf("usage: QtDemoBench [");
+        for (size_t i = 0; i < sizeof(Tables) / sizeof(Tables[0]); ++i) {
+            std::printf("%s%s", i > 0 ? "|" : "", Tables[i].name);
+        }
+        std::printf("] ...\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+#ifndef ANALYSISSCHEDULER_H
+#define ANALYSISSCHEDULER_H
+
+#include <QObject>
+#include <QImage>
+#include <QRect>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "core/Frame.h"
+#include "core/ImageProcessor.h"
+#include "core/TemplateSet.h"
+
+/**
+ * AnalysisScheduler - 最新帧优先的分析调度器
+ *
+ * 分析比截图慢时丢弃过时的帧，而不是排队等待：
+ * 1. 每个分析任务（模板集、OCR区域、颜色检查等）有一个单帧信箱
+ * 2. 提交新帧时，信箱中尚未开始分析的帧被替换并计为丢弃；任务空闲时立即开始分析信箱中的帧
+ * 3. 分析在ImageProcessor的线程池中执行，每个任务同一时间只分析一帧，结果回调在调度器所在线程执行
+ *
+ * 因此每个任务最多积压一帧，从提交到得到结果的时间不超过两次分析的耗时，与分析本身多慢无关。
+ * 调度器的方法只能在其所在线程调用。
+ *
+ * 使用示例：
+ *   AnalysisScheduler scheduler(&processor);
+ *   scheduler.addTemplateJob("buttons", templates, [](quint64 frame, const auto& results) { ... });
+ *   scheduler.addTextJob("title", QRect(0, 0, 400, 40), "chi_sim", [](quint64 frame, auto result, const QString& text) { ... });
+ *   // 每次截图后
+ *   scheduler.submitFrame(image);
+ */
+class AnalysisScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 任务统计（延迟为从submitFrame或截图到结果回调的时间）
+    struct Statistics {
+        quint64 framesSubmitted = 0;
+        quint64 framesAnalyzed = 0;
+        quint64 framesDropped = 0;       // 在信箱中被新帧替换的帧
+        double lastLatencyMs = 0.0;
+        double averageLatencyMs = 0.0;
+        double maxLatencyMs = 0.0;
+        int queueDepth = 0;              // 信箱中等待分析的帧数（每个任务0或1）
+        int inFlight = 0;                // 正在分析的帧数（每个任务0或1）
+    };
+
+    // 通用分析：在工作线程中分析帧，返回的函数在调度器线程中执行（用于报告结果）
+    using Analysis = std::function<std::function<void()>(const QImage& frame, quint64 frameNumber)>;
+
+    using TemplateCallback = std::function<void(quint64 frameNumber, const std::vector<TemplateSet::MatchResult>& results)>;
+    using TextCallback = std::function<void(quint64 frameNumber, ImageProcessor::ProcessResult result, const QString& text)>;
+    using ColorCallback = std::function<void(quint64 frameNumber, ImageProcessor::ProcessResult result,
+                                             const std::vector<ImageProcessor::ColorBlob>& blobs)>;
+
+    explicit AnalysisScheduler(ImageProcessor* processor, QObject* parent = nullptr);
+    ~AnalysisScheduler();
+
+    // ========== 任务管理 ==========
+    // 任务名已存在时返回false
+    bool addJob(const QString& jobId, Analysis analysis, TaskPriority priority = TaskPriority::Normal);
+
+    // 模板集匹配：任务持有templates的副本（matchAll会更新副本中的上次命中位置，每个任务同一时间只分析一帧），
+    // 之后对templates的修改不影响任务，需要更换模板时移除后重新添加任务
+    bool addTemplateJob(const QString& jobId, const TemplateSet& templates, TemplateCallback callback,
+                        TaskPriority priority = TaskPriority::Normal);
+
+    // 识别帧中region区域的文字，空矩形表示整帧
+    bool addTextJob(const QString& jobId, const QRect& region, const QString& language, TextCallback callback,
+                    TaskPriority priority = TaskPriority::Normal);
+
+    // 查找颜色区域
+    bool addColorJob(const QString& jobId, const ImageProcessor::ColorRange& range,
+                     const ImageProcessor::ColorBlobOptions& options, ColorCallback callback,
+                     TaskPriority priority = TaskPriority::Normal);
+
+    // 移除任务：等待中的帧被丢弃，正在分析的帧不再回调
+    bool removeJob(const QString& jobId);
+    void clear();
+
+    bool contains(const QString& jobId) const;
+    QStringList jobIds() const;
+
+    // ========== 帧提交 ==========
+    // 把帧放入所有任务的信箱，返回帧序号（从1开始）
+    quint64 submitFrame(const QImage& frame);
+    // 共享帧：各任务分析帧的QImage视图，不复制像素；延迟从截图时间（frame.timestamp()）算起
+    quint64 submitFrame(const Frame& frame);
+
+    // ========== 统计 ==========
+    Statistics statistics(const QString& jobId) const;
+    Statistics totalStatistics() const;     // 所有任务之和，延迟取所有任务中的平均与最大值
+    int queueDepth() const;                 // 所有任务等待分析的帧数
+    void resetStatistics();
+
+signals:
+    // 一个任务完成一帧的分析（在结果回调之后发出）
+    void analysisCompleted(const QString& jobId, quint64 frameNumber, double latencyMs);
+
+private:
+    struct Job {
+        QString id;
+        Analysis analysis;
+        TaskPriority priority = TaskPriority::Normal;
+        CancellationToken token;
+        bool removed = false;
+
+        // 信箱
+        bool hasPending = false;
+        QImage pendingFrame;
+        quint64 pendingNumber = 0;
+        qint64 pendingSubmitted = 0;     // 提交时间（Frame::currentTimestamp，纳秒）
+
+        bool running = false;
+        double totalLatencyMs = 0.0;
+        Statistics statistics;
+    };
+
+    std::shared_ptr<Job> findJob(const QString& jobId) const;
+    quint64 submitImage(const QImage& frame, qint64 submitted);
+    void startJob(const std::shared_ptr<Job>& job);
+    void finishJob(const std::shared_ptr<Job>& job, const std::function<void()>& report,
+                   quint64 frameNumber, qint64 submitted);
+
+    ImageProcessor* processor;
+    std::vector<std::shared_ptr<Job>> jobs;   // 注册顺序，提交帧时按此顺序启动任务
+    quint64 frameCounter = 0;
+};
+
+#endif // ANALYSISSCHEDULER_H
@@ -0,0 +1,41 @@
+#ifndef CAPTURESOURCE_H
+#define CAPTURESOURCE_H
+
+#include <QSize>
+#include <QString>
+#include "core/Frame.h"
+#include "core/FramePool.h"
+
+/**
+ * CaptureSource - 截图后端接口
+ *
+ * WindowCapture与分析代码只通过此接口获取帧，不关心帧来自哪里：
+ * - GdiCaptureSource：PrintWindow/BitBlt截取窗口（Windows）
+ * - ReplayCaptureSource：按指定帧率回放图像序列或录制的帧文件（任意平台，用于基准测试与回归测试）
+ *
+ * 同一个后端对象只在一个线程中使用。
+ */
+class CaptureSource
+{
+public:
+    virtual ~CaptureSource() = default;
+
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+    virtual bool isRunning() const = 0;
+
+    // 获取下一帧；未运行、截图失败或还没有新帧时返回空帧
+    virtual Frame nextFrame() = 0;
+
+    // 当前帧尺寸与像素格式（尺寸未知时为空）
+    virtual QSize frameSize() const = 0;
+    virtual Frame::PixelFormat pixelFormat() const = 0;
+
+    // 后端名称，用于日志
+    virtual QString name() const = 0;
+
+    // 后端使用的帧缓冲池的统计，不使用缓冲池的后端返回全零
+    virtual FramePool::Statistics framePoolStatistics() const { return FramePool::Statistics(); }
+};
+
+#endif // CAPTURESOURCE_H
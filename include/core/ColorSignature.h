@@ -0,0 +1,68 @@
+#ifndef COLORSIGNATURE_H
+#define COLORSIGNATURE_H
+
+#include <QColor>
+#include <QImage>
+#include <QPoint>
+#include <QRect>
+#include <cstdint>
+#include <vector>
+
+/**
+ * ColorSignature - 多点颜色特征匹配
+ *
+ * 用锚点附近5-20个像素的相对位置和期望颜色识别界面元素，比完整模板匹配便宜得多：
+ * 1. 在已知位置检查：逐点比较，任一点不匹配立即返回
+ * 2. 全帧查找：先用最有区分度（帧中匹配像素最少）的点筛选候选锚点，再按区分度依次验证其余点
+ *
+ * 全帧查找借助帧的颜色位置索引：每个像素按R/G/B各取高4位归入4096个颜色格，
+ * 同一格内按光栅顺序记录像素位置。索引每帧只建一次，之后每个特征只需访问与其颜色范围
+ * 重叠的格子中的像素，同一帧上可以查找数百个特征。
+ */
+namespace ColorSignature {
+
+// 特征中的一个点：相对锚点的偏移、期望颜色与每个通道允许的最大差值
+struct Point {
+    QPoint offset;
+    QRgb color = 0;
+    int tolerance = 0;
+};
+
+constexpr int BinBits = 4;
+constexpr int BinCount = 1 << (3 * BinBits);
+
+// 帧的颜色位置索引，positions[binStart[b], binStart[b+1])为颜色格b中像素的y*width+x
+struct FrameIndex {
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> binStart;
+    std::vector<uint32_t> positions;
+
+    bool isEmpty() const { return width <= 0 || height <= 0; }
+
+    // 颜色可能落在point范围内的像素数（与范围重叠的所有格子的像素数之和）
+    size_t candidateCount(const Point& point) const;
+};
+
+// 由32位颜色缓冲（TemplateMatcher::toColorBuffer的结果）构建索引
+FrameIndex buildIndex(const QImage& colorBuffer, int threadCount = 1);
+
+// 像素的R/G/B与期望颜色之差都不超过容差
+inline bool pointMatches(QRgb pixel, const Point& point)
+{
+    return qAbs(qRed(pixel) - qRed(point.color)) <= point.tolerance &&
+           qAbs(qGreen(pixel) - qGreen(point.color)) <= point.tolerance &&
+           qAbs(qBlue(pixel) - qBlue(point.color)) <= point.tolerance;
+}
+
+// 所有点都落在图像内且都匹配
+bool matchAt(const QImage& colorBuffer, const std::vector<Point>& points, const QPoint& anchor);
+
+// 查找锚点位于searchArea内、所有点都匹配的位置，按光栅顺序返回；maxResults为0表示不限
+// index为空或候选像素多于搜索区域时直接逐位置扫描搜索区域
+std::vector<QPoint> find(const QImage& colorBuffer, const FrameIndex& index, const std::vector<Point>& points,
+                         const QRect& searchArea, int maxResults = 0);
+
+}
+
+#endif // COLORSIGNATURE_H
@@ -0,0 +1,55 @@
+#ifndef CONNECTEDCOMPONENTS_H
+#define CONNECTEDCOMPONENTS_H
+
+#include <QPointF>
+#include <QRect>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * ConnectedComponents - 二值掩码的连通域标记
+ *
+ * 基于行程（run）的两遍扫描算法：
+ * 1. 逐行提取连续前景像素段，与上一行相邻的段用并查集合并
+ * 2. 解析并查集得到连通域编号，同时累计外接矩形、像素数与质心
+ *
+ * 只访问掩码一次，之后只处理行程，对缓存友好。多线程时按水平条带并行提取并局部合并，
+ * 再合并条带接缝处的行程。结果与单线程完全一致：连通域按首个像素的光栅顺序编号。
+ */
+namespace ConnectedComponents {
+
+enum class Connectivity {
+    Four,    // 上下左右相邻
+    Eight    // 包括对角相邻
+};
+
+// 一行中连续的前景像素[start, end)
+struct Run {
+    int row = 0;
+    int start = 0;
+    int end = 0;
+};
+
+struct Component {
+    QRect bounds;
+    int64_t pixelCount = 0;
+    int64_t sumX = 0;   // 像素x坐标之和，用于计算质心
+    int64_t sumY = 0;
+
+    QPointF centroid() const;
+};
+
+struct Labeling {
+    std::vector<Run> runs;           // 按行、列顺序排列
+    std::vector<int> runLabels;      // 每个行程所属的连通域下标
+    std::vector<Component> components;
+};
+
+// mask中非0字节为前景，stride为相邻两行的字节间隔；threadCount为参与计算的线程数
+Labeling label(const uint8_t* mask, int width, int height, size_t stride,
+               Connectivity connectivity = Connectivity::Eight, int threadCount = 1);
+
+}
+
+#endif // CONNECTEDCOMPONENTS_H
@@ -0,0 +1,58 @@
+#ifndef FFTCORRELATION_H
+#define FFTCORRELATION_H
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+/**
+ * FftCorrelation - 频域互相关
+ *
+ * 为大模板提供基于FFT的互相关计算：
+ * 1. 自包含的混合基(2/3/4/5)复数FFT，不依赖外部库
+ * 2. 源图像窗口与模板打包为一个复数信号，只需一次正变换和一次逆变换
+ * 3. 结果四舍五入为整数，与空间域逐像素累加的 Σ s*t 一致
+ *
+ * 变换尺寸取不小于窗口尺寸的2^a*3^b*5^c，无需补零到2的幂。
+ */
+namespace FftCorrelation {
+
+using Complex = std::complex<double>;
+
+// 一维变换计划（预计算分解因子与旋转因子）
+class Transform1D
+{
+public:
+    Transform1D(int size, bool inverse);
+
+    int size() const { return length; }
+
+    // out与in不能重叠；stride为输入元素间隔；逆变换不做1/n缩放
+    void run(const Complex* in, Complex* out, int stride = 1) const;
+
+private:
+    void work(Complex* out, const Complex* in, int inputStride, size_t fstride, const int* factor) const;
+    void butterfly2(Complex* out, size_t fstride, int m) const;
+    void butterfly4(Complex* out, size_t fstride, int m) const;
+    void butterflyGeneric(Complex* out, size_t fstride, int m, int p) const;
+
+    int length;
+    bool inverse;
+    std::vector<int> factors;   // 依次为(基数p, 剩余长度m)
+    std::vector<Complex> twiddles;
+};
+
+// 不小于n且只含因子2、3、5的最小整数
+int nextFastSize(int n);
+
+// 计算源图像窗口与模板在所有有效位置上的互相关 Σ s*t
+// 返回按行存储的(windowWidth-templateWidth+1)*(windowHeight-templateHeight+1)个结果，模板大于窗口时返回空
+std::vector<int64_t> crossCorrelate(const uint8_t* source, int sourceStride, int windowWidth, int windowHeight,
+                                    const uint8_t* templ, int templateStride, int templateWidth, int templateHeight);
+
+// 一次crossCorrelate的相对运算量（变换点数 * log2(点数)），用于与空间域比较
+double transformCost(int windowWidth, int windowHeight);
+
+}
+
+#endif // FFTCORRELATION_H
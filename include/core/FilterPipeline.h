@@ -0,0 +1,75 @@
+#ifndef FILTERPIPELINE_H
+#define FILTERPIPELINE_H
+
+#include <QImage>
+#include <QRect>
+#include <cstdint>
+#include <vector>
+
+/**
+ * FilterPipeline - 融合执行的预处理流水线
+ *
+ * 一次描述裁剪、灰度、锐化、阈值、反色组成的操作链，之后对每一帧执行，不生成中间图像：
+ * 1. 以锐化为界把操作链分成若干段，段内的逐像素操作在同一行上依次完成（行数据留在L1缓存中）
+ * 2. 按水平条带分块执行，每块的行数使各段的块缓冲合计不超过L2缓存；
+ *    锐化需要上下相邻行，前面的段多计算若干行作为边缘
+ * 3. 多线程时每个线程处理一个行条带，各线程的块缓冲保存在流水线中，跨帧复用
+ *
+ * 结果与依次调用ImageFilters中对应的函数（裁剪为QImage::copy）逐位一致。
+ * 同一个流水线对象不能同时在多个线程中执行。
+ */
+class FilterPipeline {
+public:
+    // 只处理输入图像中的rect区域（相当于在所有操作之前裁剪）；空矩形表示整幅图像
+    FilterPipeline& crop(const QRect& rect);
+    FilterPipeline& grayscale();
+    FilterPipeline& sharpen(double intensity);
+    FilterPipeline& threshold(int level);
+    FilterPipeline& negative();
+
+    void clear();
+    bool isEmpty() const { return stages.empty() && cropRect.isNull(); }
+
+    // 执行流水线，output尺寸与格式相同时直接复用其像素缓冲；裁剪区域不在图像内或有负强度的锐化时返回false
+    bool run(const QImage& input, QImage& output, int threadCount = 1);
+
+    // 每个线程块缓冲的目标大小
+    static constexpr size_t TileBytes = 256 * 1024;
+
+private:
+    enum class Operation {
+        Grayscale,
+        Sharpen,
+        Threshold,
+        Negative
+    };
+
+    struct Stage {
+        Operation operation = Operation::Grayscale;
+        int weight = 0;   // 锐化权重，负强度时为-1
+        int level = 0;    // 阈值
+    };
+
+    // 以锐化开始（第一段除外）、后接若干逐像素操作的一段
+    struct Segment {
+        bool sharpen = false;
+        int weight = 0;
+        std::vector<Stage> pixelStages;
+        bool grayInput = false;
+        bool grayOutput = false;
+    };
+
+    // 一个线程的块缓冲：各段输出（最后一段直接写入结果图像）与一行ARGB临时缓冲
+    struct Scratch {
+        std::vector<std::vector<uint8_t>> segmentRows;
+        std::vector<uint32_t> row;
+    };
+
+    std::vector<Segment> buildSegments(bool grayInput) const;
+
+    QRect cropRect;
+    std::vector<Stage> stages;
+    std::vector<Scratch> scratch;
+};
+
+#endif // FILTERPIPELINE_H
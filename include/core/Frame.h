@@ -0,0 +1,78 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <QImage>
+#include <QMetaType>
+#include <QSize>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Frame - 共享的截图帧
+ *
+ * 从截图到分析只传递引用，不复制像素：
+ * 1. 像素缓冲区通常来自FramePool，最后一个引用释放时归还到池中
+ * 2. 帧创建后内容不再改变，可以在多个线程中同时读取
+ * 3. image()返回直接引用缓冲区的只读QImage（不复制像素，只持有缓冲区的引用），
+ *    同一帧每次返回同一个QImage，cacheKey不变，ImageProcessor中按cacheKey的缓存可以命中
+ *
+ * 像素格式与QImage在小端机器上的内存布局一致：Bgra32/Bgrx32即ARGB32/RGB32，
+ * GDI的32位DIB（B、G、R、X字节顺序）可直接作为Bgrx32使用。
+ */
+class Frame
+{
+public:
+    enum class PixelFormat {
+        Bgra32,     // QImage::Format_ARGB32
+        Bgrx32,     // QImage::Format_RGB32，第四字节无意义
+        Gray8       // QImage::Format_Grayscale8
+    };
+
+    Frame() = default;
+
+    // 包装已写好像素的缓冲区，stride至少为width * bytesPerPixel(format)
+    Frame(std::shared_ptr<uint8_t> buffer, int width, int height, qsizetype stride, PixelFormat format,
+          quint64 sequence, qint64 timestamp);
+
+    // 包装QImage：ARGB32、RGB32、Grayscale8直接共享其像素，其他格式转换为ARGB32
+    static Frame fromImage(const QImage& image, quint64 sequence = 0, qint64 timestamp = currentTimestamp());
+
+    bool isNull() const { return !d; }
+    int width() const { return d ? d->width : 0; }
+    int height() const { return d ? d->height : 0; }
+    QSize size() const { return QSize(width(), height()); }
+    qsizetype stride() const { return d ? d->stride : 0; }
+    PixelFormat format() const { return d ? d->format : PixelFormat::Bgra32; }
+    quint64 sequence() const { return d ? d->sequence : 0; }
+    qint64 timestamp() const { return d ? d->timestamp : 0; }   // 单调时钟，纳秒（见currentTimestamp）
+
+    const uint8_t* constBits() const { return d ? d->buffer.get() : nullptr; }
+    const uint8_t* constScanLine(int y) const { return constBits() + y * stride(); }
+
+    // 引用本帧像素的只读QImage，修改它会使QImage复制一份像素（不影响本帧）
+    QImage image() const { return d ? d->view : QImage(); }
+
+    static int bytesPerPixel(PixelFormat format);
+    static QImage::Format imageFormat(PixelFormat format);
+
+    // 帧时间戳使用的单调时钟（纳秒）
+    static qint64 currentTimestamp();
+
+private:
+    struct Data {
+        std::shared_ptr<uint8_t> buffer;
+        int width = 0;
+        int height = 0;
+        qsizetype stride = 0;
+        PixelFormat format = PixelFormat::Bgra32;
+        quint64 sequence = 0;
+        qint64 timestamp = 0;
+        QImage view;
+    };
+
+    std::shared_ptr<const Data> d;
+};
+
+Q_DECLARE_METATYPE(Frame)
+
+#endif // FRAME_H
@@ -0,0 +1,80 @@
+#ifndef FRAMEPOOL_H
+#define FRAMEPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * FramePool - 帧缓冲池
+ *
+ * 截图每帧需要一块数MB的像素缓冲区。缓冲区的最后一个引用释放时归还到池中，
+ * 下一帧直接复用，避免每帧重新分配内存和触发缺页：
+ * 1. 请求的大小向上取整到尺寸档位：每个2的幂区间分为4档，浪费不超过25%，
+ *    窗口尺寸略有变化时仍能复用同一档位的缓冲区
+ * 2. 每个档位最多保留maxFreePerClass个空闲缓冲区，多余的直接释放
+ * 3. 缓冲区按64字节对齐，供SIMD内核使用
+ *
+ * 池销毁后仍在使用的缓冲区在释放时直接归还给系统。可在多个线程中同时获取和释放。
+ * 不依赖平台接口。
+ */
+class FramePool {
+public:
+    static constexpr size_t Alignment = 64;
+    static constexpr size_t MinClassBytes = 4096;
+    static constexpr int ClassesPerOctave = 4;
+
+    struct Statistics {
+        uint64_t hits = 0;           // 由空闲缓冲区满足的请求
+        uint64_t misses = 0;         // 需要新分配的请求
+        uint64_t recycled = 0;       // 释放后归还到池中的缓冲区
+        uint64_t discarded = 0;      // 释放时档位已满而归还给系统的缓冲区
+        int buffersInUse = 0;
+        int freeBuffers = 0;
+        size_t bytesInUse = 0;       // 按档位大小计
+        size_t freeBytes = 0;
+
+        double hitRate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+    };
+
+    explicit FramePool(int maxFreePerClass = 4);
+    ~FramePool();
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // 获取至少bytes字节的缓冲区（内容未初始化）
+    std::shared_ptr<uint8_t> acquire(size_t bytes);
+
+    // 释放所有空闲缓冲区
+    void clear();
+
+    void setMaxFreePerClass(int count);
+    int getMaxFreePerClass() const;
+
+    Statistics statistics() const;
+    void resetStatistics();   // 只清零计数，不影响缓冲区数量
+
+    // bytes所属档位的大小
+    static size_t sizeClass(size_t bytes);
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::map<size_t, std::vector<uint8_t*>> freeLists;   // 档位大小 -> 空闲缓冲区
+        int maxFreePerClass = 4;
+        Statistics statistics;
+
+        ~State();
+    };
+
+    static uint8_t* allocate(size_t bytes);
+    static void release(uint8_t* data);
+
+    std::shared_ptr<State> state;
+};
+
+#endif // FRAMEPOOL_H
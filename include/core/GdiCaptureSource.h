@@ -0,0 +1,59 @@
+#ifndef GDICAPTURESOURCE_H
+#define GDICAPTURESOURCE_H
+
+#include "core/CaptureSource.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/**
+ * GdiCaptureSource - GDI截图后端
+ *
+ * PrintWindow（失败时BitBlt）直接绘制到缓存的DIB段，再复制一次到帧缓冲池的缓冲区：
+ * 1. DIB段与内存DC只在窗口尺寸变化时重建
+ * 2. 32位DIB的BGRX字节顺序即Frame::PixelFormat::Bgrx32，无需转换
+ */
+class GdiCaptureSource : public CaptureSource
+{
+public:
+    explicit GdiCaptureSource(HWND targetWindow);
+    ~GdiCaptureSource() override;
+
+    GdiCaptureSource(const GdiCaptureSource&) = delete;
+    GdiCaptureSource& operator=(const GdiCaptureSource&) = delete;
+
+    bool start() override;
+    void stop() override;
+    bool isRunning() const override { return running; }
+
+    Frame nextFrame() override;
+    QSize frameSize() const override;
+    Frame::PixelFormat pixelFormat() const override { return Frame::PixelFormat::Bgrx32; }
+    QString name() const override { return "GDI"; }
+
+    FramePool::Statistics framePoolStatistics() const override { return framePool.statistics(); }
+    void setFramePoolCapacity(int buffersPerClass) { framePool.setMaxFreePerClass(buffersPerClass); }
+
+    HWND getTargetWindow() const { return targetWindow; }
+    int getSurfaceRebuildCount() const { return surfaceRebuilds; }
+
+private:
+    bool ensureCaptureSurface(HDC windowDC, const QSize& size);
+    void releaseCaptureSurface();
+
+    HWND targetWindow;
+    bool running;
+    FramePool framePool;
+    quint64 frameSequence;
+
+    // 截图表面缓存：PrintWindow/BitBlt直接写入DIB段，尺寸不变时跨帧复用
+    HDC surfaceDC;
+    HBITMAP surfaceBitmap;
+    HGDIOBJ surfacePreviousBitmap;
+    uint8_t* surfaceBits;
+    QSize surfaceSize;
+    int surfaceRebuilds;
+};
+
+#endif // GDICAPTURESOURCE_H
@@ -0,0 +1,86 @@
+#ifndef IMAGEFILTERS_H
+#define IMAGEFILTERS_H
+
+#include <QImage>
+#include <QString>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * ImageFilters - 图像滤镜
+ *
+ * 所有滤镜都直接按扫描线处理32位像素，由行条带执行器分给多个线程：
+ * 1. 模糊：二维核拆成水平、垂直两次一维卷积。水平方向逐行卷积，第y行的结果写入转置缓冲的第y列；
+ *    转置缓冲的每一行即原图的一列，再逐行卷积并写回结果的对应列
+ * 2. 锐化、边缘检测：3x3邻域，每行读取上下相邻两行，由PixelKernels按SIMD后端执行
+ * 3. 怀旧、反色：逐像素，怀旧色使用预计算的查找表
+ *
+ * 卷积权重为定点整数，结果与线程数及SIMD后端无关。大半径的高斯模糊用三次盒式模糊近似，
+ * 盒式模糊用滑动窗口求和，耗时与半径无关。
+ */
+namespace ImageFilters {
+
+// 行条带执行器：把[0, rows)分成最多threadCount个条带（每个至少64行），在TaskPool共享线程池上
+// 并行执行body(起始行, 结束行)；行数不足时在调用线程执行
+void forEachRowBand(int rows, int threadCount, const std::function<void(int, int)>& body);
+
+// 高斯核的定点权重（和为1 << PixelKernels::ConvolutionShift），长度2*radius+1；sigma≤0时取0.3*(radius-1)+0.8
+std::vector<int16_t> gaussianKernel(int radius, double sigma = 0.0);
+
+// 半径超过此值时gaussianBlur改用三次盒式模糊近似
+constexpr int BoxApproximationRadius = 24;
+
+// 结果为32位格式（ARGB32或RGB32，与TemplateMatcher::toColorBuffer一致），边界像素向外延伸；radius≤0时返回原图
+// transposeBuffer为调用方持有、跨帧复用的转置缓冲（调整为宽×高个像素），同一缓冲不能同时用于多次调用；
+// 为空时每次调用临时分配，返回前释放
+QImage gaussianBlur(const QImage& image, int radius, int threadCount = 1,
+                    std::vector<uint32_t>* transposeBuffer = nullptr);
+QImage boxBlur(const QImage& image, int radius, int threadCount = 1, std::vector<uint32_t>* transposeBuffer = nullptr);
+
+// 拉普拉斯锐化：各颜色通道加上intensity倍的4c-上下左右四邻之和（intensity按1/256量化，超过128按128处理），
+// 边框像素与alpha不变；Grayscale8输入的结果仍为Grayscale8。不支持负强度（柔化），intensity < 0时返回空图像
+QImage sharpen(const QImage& image, double intensity, int threadCount = 1);
+
+// Sobel边缘检测：灰度梯度幅值乘以intensity，结果为RGB32灰度图，边框为黑色
+QImage edgeDetection(const QImage& image, double intensity, int threadCount = 1);
+
+// 怀旧色与反色，alpha不变；Grayscale8输入的反色结果仍为Grayscale8
+QImage sepia(const QImage& image, int threadCount = 1);
+QImage negative(const QImage& image, int threadCount = 1);
+
+// 按qGray权重转换为Grayscale8（与模板匹配使用的灰度一致）
+QImage grayscale(const QImage& image, int threadCount = 1);
+
+// 灰度不低于level的像素为255，其余为0，结果为Grayscale8
+QImage threshold(const QImage& image, int level, int threadCount = 1);
+
+// ========== 行操作 ==========
+// 上述滤镜逐行使用的运算，FilterPipeline复用以保证结果一致
+
+// 锐化强度转换为PixelKernels锐化内核的权重[0, 32767]；intensity < 0时返回-1
+int sharpenWeight(double intensity);
+
+// 锐化一行（width ≥ 3）：内部像素由上下左右四邻计算，左右边框像素直接复制；pixelBytes为1（灰度）或4（ARGB）
+void sharpenRow(const uchar* above, const uchar* row, const uchar* below, int width, int pixelBytes, int weight, uchar* dst);
+
+void grayRow(const uint32_t* src, int count, uint8_t* dst);
+void thresholdRow(uint8_t* row, int count, int level);
+void negateRow(uint32_t* row, int count);
+void negateRow(uint8_t* row, int count);
+
+// ========== 基准测试 ==========
+
+struct FilterBenchmark {
+    QString filter;
+    double legacyMilliseconds = 0.0;     // 逐像素QColor读写的原实现
+    double scanlineMilliseconds = 0.0;   // 扫描线实现
+    int maxDifference = 0;               // 两者结果的最大通道差
+};
+
+// 在size大小的伪随机图像上对比每个滤镜的两种实现，每种重复repetitions次取平均
+std::vector<FilterBenchmark> benchmarkFilters(const QSize& size, int threadCount = 1, int repetitions = 3);
+
+}
+
+#endif // IMAGEFILTERS_H
@@ -3,11 +3,32 @@
 
 #include <QObject>
 #include <QImage>
+#include <QColor>
+#include <QPointF>
 #include <QString>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include "core/TemplateMatcher.h"
+#include "core/ImageSimilarity.h"
+#include "core/IntegralImage.h"
+#include "core/ColorSignature.h"
+#include "core/FilterPipeline.h"
+#include "core/TaskPool.h"
 
 
+// ImageProcessor异步操作的选项
+struct AsyncTaskOptions {
+    TaskPriority priority = TaskPriority::Normal;
+    CancellationToken token;
+    QObject* context = nullptr;    // 回调的执行线程为context所在线程，context销毁后不再回调；nullptr表示调用线程
+};
+
 /**
  * ImageProcessor - 图像处理模块
  * 
@@ -57,6 +78,113 @@ public:
         Lanczos         // Lanczos插值
     };
 
+    // 模板匹配选项
+    struct TemplateMatchOptions {
+        TemplateMatcher::MatchMethod method = TemplateMatcher::MatchMethod::CorrelationCoefficient;
+        int pyramidLevels = 0;       // 金字塔层数，0表示在原始分辨率上全图搜索
+        int refineRadius = 2;        // 金字塔每层细化的邻域半径（像素）
+        int candidateCount = 8;      // 保留的候选数量（金字塔最粗层；按颜色差评分重排前的灰度峰值数）
+        
+        // 搜索区域：模板需完整落入该区域，空矩形表示整幅图像
+        QRect searchRect;
+        
+        // 掩码：非空时须与模板同尺寸，灰度不低于128的像素参与比较；
+        // 为空且useTemplateAlpha时，模板中alpha低于128的像素不参与比较
+        QImage templateMask;
+        bool useTemplateAlpha = true;
+        
+        // 上次命中提示：先在上次命中位置附近搜索，置信度低于minConfidence时回退到整个搜索区域
+        bool useLastHitHint = false;
+        int hintRadius = 16;
+        
+        double minConfidence = 0.9;       // 结果的最低置信度（templateMatchAll、上次命中提示与多尺度比例记忆）
+        
+        // 多尺度匹配（仅用于templateMatchMultiScale）：依次尝试的模板缩放比例，空表示只用1.0
+        // 例如适配125%/150% DPI可使用 {1.0, 1.25, 1.5}
+        std::vector<double> templateScales;
+        
+        // 序贯相似性检测(SSDA)：直接按颜色差评分逐行累加误差，超过当前最优或rejectConfidence对应的上限时
+        // 提前放弃该位置。启用后忽略method与金字塔参数，仅用于templateMatch
+        bool earlyTermination = false;
+        double rejectConfidence = 0.0;    // 0表示只与当前最优比较，所有位置都被放弃时confidence为-1
+        
+        // 以下仅用于templateMatchAll
+        double candidateThreshold = 0.7;  // 匹配度量得分低于此值的位置直接跳过
+        double maxOverlap = 0.3;          // 非极大值抑制允许的最大交并比
+        int maxResults = 0;               // 结果数量上限，0表示不限；达到上限后保留得分最高的maxResults个
+
+        TemplateMatcher::PyramidParameters pyramidParameters() const {
+            return TemplateMatcher::PyramidParameters{pyramidLevels, refineRadius, candidateCount};
+        }
+        TemplateMatcher::MultiMatchParameters multiMatchParameters() const {
+            return TemplateMatcher::MultiMatchParameters{minConfidence, candidateThreshold, maxOverlap, maxResults};
+        }
+    };
+
+    // 图像相似度选项
+    struct SimilarityOptions {
+        ImageSimilarity::Metric metric = ImageSimilarity::Metric::StructuralSimilarity;
+        QRect region;            // 比较区域，空矩形表示整幅图像
+        int proxyStep = 1;       // 降采样代理：每隔proxyStep行、列取一个像素，1表示逐像素
+        int ssimWindow = 8;      // SSIM窗口边长（取样后的像素数）
+        double maxPsnr = 50.0;   // PSNR达到此值（dB）时相似度为1
+
+        ImageSimilarity::Parameters parameters() const {
+            return ImageSimilarity::Parameters{metric, proxyStep, ssimWindow, maxPsnr};
+        }
+    };
+
+    // 矩形检测选项：先生成二值掩码（边缘或阈值），再做连通域标记，最后按外接矩形四边的覆盖率筛选
+    struct RectangleDetectionOptions {
+        bool useEdges = true;          // true：灰度梯度|dx|+|dy|不低于edgeThreshold的像素为前景；false：按灰度阈值
+        int edgeThreshold = 48;
+        int grayThreshold = 128;       // 阈值模式下灰度不低于此值的像素为前景
+        bool darkForeground = false;   // 阈值模式下改为灰度低于grayThreshold的像素为前景
+        double tolerance = 0.02;       // 外接矩形每条边允许缺失的比例
+        int minWidth = 12;             // 矩形的最小尺寸（像素）
+        int minHeight = 12;
+        int mergeDistance = 3;         // 四边都在外层矩形内侧此距离以内的矩形视为同一边框的内轮廓而舍去
+        int threadCount = 1;           // 并行处理的水平条带数，0表示使用setProcessingThreads设置的线程数
+    };
+
+    // 颜色范围：RGB模式下各分量位于[low, high]之间；HSV模式下色相（度，0-359）位于[hueLow, hueHigh]之间
+    // （hueLow > hueHigh表示跨越0度，如红色取340到20），饱和度与明度（0-255）位于对应范围内
+    struct ColorRange {
+        enum class Space {
+            Rgb,
+            Hsv
+        };
+        Space space = Space::Rgb;
+        QColor low = QColor(0, 0, 0);
+        QColor high = QColor(255, 255, 255);
+        int hueLow = 0;
+        int hueHigh = 359;
+        int saturationLow = 0;
+        int saturationHigh = 255;
+        int valueLow = 0;
+        int valueHigh = 255;
+
+        // 以color为中心、每个分量允许±tolerance的RGB范围
+        static ColorRange rgb(const QColor& color, int tolerance);
+        // 色相为hue±hueTolerance度、饱和度与明度不低于给定值的HSV范围
+        static ColorRange hsv(int hue, int hueTolerance, int minSaturation = 0, int minValue = 0);
+    };
+
+    // 颜色区域：外接矩形、质心与像素数（均为帧坐标）
+    struct ColorBlob {
+        QRect bounds;
+        QPointF centroid;
+        int pixelCount = 0;
+    };
+
+    struct ColorBlobOptions {
+        QRect searchRect;              // 搜索区域，空矩形表示整幅图像
+        int minPixels = 1;             // 像素数少于此值的区域被忽略（过滤噪点）
+        bool eightConnected = true;    // 对角相邻的像素是否属于同一区域
+        int maxResults = 0;            // 结果数量上限，0表示不限
+        int threadCount = 1;           // 并行处理的水平条带数，0表示使用setProcessingThreads设置的线程数
+    };
+
     explicit ImageProcessor(QObject *parent = nullptr);
     ~ImageProcessor();
 
@@ -77,10 +205,13 @@ public:
 
     // ========== 图像增强和滤镜 ==========
     
-    // 应用滤镜
+    // 应用滤镜：intensity须在[0, 2]内，否则返回InvalidInput（锐化不支持负强度的柔化，请用Blur）
     ProcessResult applyFilter(const QImage& input, QImage& output, 
                              FilterType filter, double intensity = 1.0);
     
+    // 执行预处理流水线（裁剪、灰度、锐化、阈值等融合为一遍），使用processingThreads个线程
+    ProcessResult runPipeline(const QImage& input, QImage& output, FilterPipeline& pipeline);
+
     // 调整亮度对比度
     ProcessResult adjustBrightnessContrast(const QImage& input, QImage& output,
                                           double brightness, double contrast);
@@ -91,17 +222,92 @@ public:
 
     // ========== 图像分析 ==========
     
-    // 计算图像相似度
+    // 计算图像相似度（默认选项，即整幅图像的SSIM）
     double calculateSimilarity(const QImage& image1, const QImage& image2);
     
-    // 检测图像中的矩形
-    ProcessResult detectRectangles(const QImage& input, 
+    // 仅比较两幅图像中region范围内的部分
+    double calculateSimilarity(const QImage& image1, const QImage& image2, const QRect& region);
+    
+    // 按选项指定的度量计算相似度，范围[0,1]（用于检测画面切换，1080p整帧约数毫秒）
+    double calculateSimilarity(const QImage& image1, const QImage& image2, const SimilarityOptions& options);
+    
+    // 检测图像中的矩形（对话框、按钮、面板等），threshold为每条边允许缺失的比例
+    ProcessResult detectRectangles(const QImage& input,
                                   std::vector<QRect>& rectangles,
                                   double threshold = 0.02);
+
+    // 按选项检测矩形，结果按上边、左边排序（1280x720单线程数毫秒）
+    ProcessResult detectRectangles(const QImage& input,
+                                  std::vector<QRect>& rectangles,
+                                  const RectangleDetectionOptions& options);
+    
+    // 查找颜色位于range内的所有连通区域，按像素数降序排列
+    // 只读取已截取的帧：先用SIMD生成颜色掩码，再按行程标记连通域，不逐像素调用系统取色接口
+    ProcessResult findColorBlobs(const QImage& frame, const ColorRange& range, std::vector<ColorBlob>& blobs);
+    ProcessResult findColorBlobs(const QImage& frame, const ColorRange& range, std::vector<ColorBlob>& blobs,
+                                 const ColorBlobOptions& options);
+    
+    // 多点颜色特征：anchor处特征的所有点都在图像内且颜色都在容差内时返回true
+    bool matchColorSignature(const QImage& frame, const std::vector<ColorSignature::Point>& signature,
+                             const QPoint& anchor);
+    
+    // 查找所有匹配多点颜色特征的锚点（光栅顺序），searchRect为锚点的范围，空矩形表示整幅图像
+    // 先检查帧中匹配像素最少的点；整帧查找时使用按cacheKey缓存的颜色索引，同一帧上的多个特征共用
+    ProcessResult findColorSignature(const QImage& frame, const std::vector<ColorSignature::Point>& signature,
+                                     std::vector<QPoint>& anchors);
+    ProcessResult findColorSignature(const QImage& frame, const std::vector<ColorSignature::Point>& signature,
+                                     std::vector<QPoint>& anchors, const QRect& searchRect, int maxResults = 0);
+    
+    // 帧的颜色位置索引（供多点颜色特征查找），按图像cacheKey缓存最近的ColorIndexCacheSize帧
+    std::shared_ptr<const ColorSignature::FrameIndex> colorIndex(const QImage& frame);
+    void clearColorIndexCache();
+    
+    static constexpr int ColorIndexCacheSize = 2;
     
     // 模板匹配
     ProcessResult templateMatch(const QImage& source, const QImage& template_,
                                QPoint& bestMatch, double& confidence);
+    
+    // 模板匹配（可选由粗到精的金字塔搜索，置信度始终在原始分辨率上计算）
+    ProcessResult templateMatch(const QImage& source, const QImage& template_,
+                               QPoint& bestMatch, double& confidence,
+                               const TemplateMatchOptions& options);
+    
+    // 同上，并返回序贯相似性检测的比较/跳过像素统计（未启用earlyTermination时全部为0）
+    ProcessResult templateMatch(const QImage& source, const QImage& template_,
+                               QPoint& bestMatch, double& confidence,
+                               const TemplateMatchOptions& options,
+                               TemplateMatcher::SequentialStatistics& statistics);
+    
+    // 查找所有置信度不低于options.minConfidence的匹配位置（经过非极大值抑制，按得分降序）
+    ProcessResult templateMatchAll(const QImage& source, const QImage& template_,
+                                  std::vector<TemplateMatcher::MatchCandidate>& matches);
+    ProcessResult templateMatchAll(const QImage& source, const QImage& template_,
+                                  std::vector<TemplateMatcher::MatchCandidate>& matches,
+                                  const TemplateMatchOptions& options);
+    
+    // 多尺度模板匹配：按options.templateScales缩放模板，返回置信度最高的位置及其比例
+    // 源图像只预处理一次；命中的比例按模板和源图像尺寸记录，之后先只尝试该比例，置信度不足时再尝试全部比例
+    ProcessResult templateMatchMultiScale(const QImage& source, const QImage& template_,
+                                          QPoint& bestMatch, double& confidence, double& scale,
+                                          const TemplateMatchOptions& options);
+    
+    // 清除上次命中提示和多尺度比例记忆（按模板图像的cacheKey记录）
+    void clearMatchHints();
+    
+    // 按匹配选项预处理模板（掩码、alpha和金字塔层数），mask与模板尺寸不一致时返回无效模板
+    static TemplateMatcher::PreparedTemplate prepareMatchTemplate(const QImage& template_, const QImage& mask,
+                                                                  const TemplateMatchOptions& options);
+    
+    // ========== 积分图 ==========
+    
+    // 图像指定通道的积分图，按图像cacheKey和通道缓存最近使用的IntegralCacheSize个结果，
+    // 同一帧上的多个分析（盒式模糊、区域均值、自适应阈值等）只计算一次；按处理线程数并行计算
+    std::shared_ptr<const IntegralImage::Tables> integralImage(const QImage& image,
+                                                               IntegralImage::Channel channel = IntegralImage::Channel::Gray);
+    void clearIntegralCache();
+    
+    static constexpr int IntegralCacheSize = 8;
                                
     // 新增：OCR文字识别功能
     ProcessResult recognizeText(const QImage& input, QString& recognizedText, const QString& language = "chi_sim");
@@ -109,17 +315,50 @@ public:
     ProcessResult preprocessForOCR(const QImage& input, QImage& output); // 预处理以提高OCR精度
 
     // ========== 异步处理 ==========
+    // 异步操作在ImageProcessor持有的线程池中执行（线程数随setProcessingThreads调整），
+    // 回调通过排队调用在调用线程（或options.context所在线程）中执行，该线程需运行事件循环。
+    // 返回的取消标记即options.token：取消后尚未开始的任务被丢弃，已完成但尚未送达的结果也不再回调
     
-    // 异步图像处理回调类型
+    using AsyncOptions = AsyncTaskOptions;
+    
+    // 异步图像处理回调类型（同时发出processingCompleted信号）
     using ProcessCallback = std::function<void(ProcessResult result, const QImage& output)>;
     
+    // 异步模板匹配回调类型，未使用多尺度匹配时scale为1.0
+    using MatchCallback = std::function<void(ProcessResult result, const QPoint& bestMatch, double confidence, double scale)>;
+    using MatchAllCallback = std::function<void(ProcessResult result, const std::vector<TemplateMatcher::MatchCandidate>& matches)>;
+    
+    // 异步OCR回调类型
+    using TextCallback = std::function<void(ProcessResult result, const QString& text)>;
+    
     // 异步缩放
-    void resizeImageAsync(const QImage& input, int width, int height,
-                         ScaleAlgorithm algorithm, ProcessCallback callback);
+    CancellationToken resizeImageAsync(const QImage& input, int width, int height,
+                                       ScaleAlgorithm algorithm, ProcessCallback callback,
+                                       const AsyncOptions& options = AsyncOptions());
     
     // 异步滤镜应用
-    void applyFilterAsync(const QImage& input, FilterType filter, 
-                         double intensity, ProcessCallback callback);
+    CancellationToken applyFilterAsync(const QImage& input, FilterType filter, 
+                                       double intensity, ProcessCallback callback,
+                                       const AsyncOptions& options = AsyncOptions());
+    
+    // 异步执行预处理流水线（使用pipeline的副本，之后修改pipeline不影响已提交的任务）
+    CancellationToken runPipelineAsync(const QImage& input, const FilterPipeline& pipeline,
+                                       ProcessCallback callback, const AsyncOptions& options = AsyncOptions());
+    
+    // 异步模板匹配，matchOptions.templateScales非空时按多尺度匹配
+    CancellationToken templateMatchAsync(const QImage& source, const QImage& template_,
+                                         const TemplateMatchOptions& matchOptions, MatchCallback callback,
+                                         const AsyncOptions& options = AsyncOptions());
+    CancellationToken templateMatchAllAsync(const QImage& source, const QImage& template_,
+                                            const TemplateMatchOptions& matchOptions, MatchAllCallback callback,
+                                            const AsyncOptions& options = AsyncOptions());
+    
+    // 异步OCR文字识别
+    CancellationToken recognizeTextAsync(const QImage& input, const QString& language, TextCallback callback,
+                                         const AsyncOptions& options = AsyncOptions());
+    
+    // 在线程池中执行任意分析：work在工作线程执行，其返回的送达函数按options在回调线程中执行
+    CancellationToken submitAsync(const AsyncOptions& options, std::function<std::function<void()>()> work);
 
     // ========== 实用功能 ==========
     
@@ -164,6 +403,9 @@ private:
     // 验证输入参数
     bool validateInputs(const QImage& input) const;
     
+    // 并行处理使用的线程数（至少为1），任务执行期间可能被setProcessingThreads修改，每次调用时读取
+    int workerThreadCount() const;
+    
     // Qt滤镜实现辅助方法
     QImage applyGaussianBlur(const QImage& image, int radius);
     QImage applySharpen(const QImage& image, double intensity);
@@ -173,15 +415,65 @@ private:
     
     // 模板匹配辅助方法
     double calculateTemplateScore(const QImage& source, const QImage& template_, int x, int y);
+    
+    // 按选项预处理源图像（earlyTermination时只准备颜色缓冲区）
+    static TemplateMatcher::PreparedSource prepareMatchSource(const QImage& source, const TemplateMatchOptions& options);
+    
+    // 在已预处理的源图像上匹配单个模板，返回结果已填写confidence
+    static TemplateMatcher::MatchCandidate matchPrepared(const TemplateMatcher::PreparedSource& source,
+                                                         const TemplateMatcher::PreparedTemplate& templ,
+                                                         const QRect& searchArea,
+                                                         const TemplateMatcher::SearchHint& hint,
+                                                         const TemplateMatchOptions& options,
+                                                         TemplateMatcher::SequentialStatistics& statistics);
+    
+    // 将搜索区域转换为模板左上角的取值范围，区域内放不下模板时返回false
+    static bool resolveSearchArea(const QRect& searchRect, const QImage& source,
+                                  const QSize& templateSize, QRect& searchArea);
+    
+    // 图像结果的送达函数：执行回调并发出processingCompleted
+    std::function<void()> imageDelivery(ProcessResult result, const QImage& output, const ProcessCallback& callback);
 
 private:
     // 配置参数
     bool gpuAccelerationEnabled;
-    int processingThreads;
+    std::atomic<int> processingThreads;
     QString ocrLanguage;      // OCR语言设置
     
-    // 错误状态
+    // 上次命中提示（模板cacheKey -> 命中位置）
+    std::unordered_map<qint64, QPoint> matchHints;
+    
+    // 多尺度匹配命中的比例（模板cacheKey、源图像宽、高 -> 比例），窗口尺寸或DPI变化后源图像尺寸随之变化
+    std::map<std::tuple<qint64, int, int>, double> matchScales;
+    std::mutex matchHintMutex;
+    
+    // 积分图缓存（最近使用的在前）
+    struct IntegralCacheEntry {
+        qint64 imageKey = 0;
+        IntegralImage::Channel channel = IntegralImage::Channel::Gray;
+        std::shared_ptr<const IntegralImage::Tables> tables;
+    };
+    std::vector<IntegralCacheEntry> integralCache;
+    std::mutex integralCacheMutex;
+    
+    // 颜色索引缓存（最近使用的在前）
+    struct ColorIndexCacheEntry {
+        qint64 imageKey = 0;
+        std::shared_ptr<const ColorSignature::FrameIndex> index;
+    };
+    std::vector<ColorIndexCacheEntry> colorIndexCache;
+    std::mutex colorIndexCacheMutex;
+    
+    // 模糊的转置缓冲（一帧大小），跨帧复用，随处理器释放；正被其他线程使用时该次调用临时分配
+    std::vector<uint32_t> blurBuffer;
+    std::mutex blurBufferMutex;
+    
+    // 错误状态（异步任务可能同时写入）
     QString lastErrorMessage;
+    std::mutex errorMutex;
+    
+    // 异步任务线程池，析构时最先销毁，等待正在执行的任务结束
+    std::unique_ptr<TaskPool> taskPool;
 };
 
 // 便捷的静态工具方法
@@ -197,6 +489,65 @@ namespace ImageProcessorUtils {
     
     // 计算图像哈希（用于快速比较）
     QString calculateImageHash(const QImage& image);
+    
+    // ========== 感知哈希 ==========
+    // 64位感知哈希，亮度的轻微变化、缩放和压缩噪声只改变少数几位，用汉明距离衡量相似程度
+    enum class PerceptualHashType {
+        Average,      // aHash：8x8灰度缩略图，高于均值的格子置1
+        Difference,   // dHash：9x8灰度缩略图，每行中比右侧相邻格子亮的格子置1
+        Dct           // pHash：32x32灰度缩略图的DCT，左上8x8低频系数中高于中值的置1
+    };
+    
+    uint64_t averageHash(const QImage& image);
+    uint64_t differenceHash(const QImage& image);
+    uint64_t dctHash(const QImage& image);
+    uint64_t perceptualHash(const QImage& image, PerceptualHashType type = PerceptualHashType::Dct);
+    
+    // 两个哈希不同的位数（0~64）
+    int hammingDistance(uint64_t first, uint64_t second);
+    
+    /**
+     * PerceptualHashIndex - 感知哈希索引
+     *
+     * 多索引哈希：64位哈希分成4段16位，每段建一张表。两个哈希的距离不超过r时，
+     * 至少有一段的距离不超过r/4，因此只需在每张表中查找翻转少数几位后的键，
+     * 在数千个已知画面状态中查找近似重复的哈希通常只需要几微秒。
+     */
+    class PerceptualHashIndex
+    {
+    public:
+        struct Match {
+            QString id;
+            uint64_t hash = 0;
+            int distance = 0;
+            int index = -1;     // 条目的插入序号（从0开始），调用方可直接用作自己数组的下标
+        };
+    
+        // 同一哈希可以对应多个id；返回条目的插入序号
+        int insert(uint64_t hash, const QString& id);
+        void clear();
+        int size() const { return static_cast<int>(hashes.size()); }
+        bool isEmpty() const { return hashes.empty(); }
+    
+        // 所有距离不超过maxDistance的条目，按距离升序（距离相同时按插入顺序）
+        std::vector<Match> search(uint64_t hash, int maxDistance) const;
+    
+        // 距离最近且不超过maxDistance的条目（距离相同时取先插入者），没有时返回false
+        bool nearest(uint64_t hash, int maxDistance, Match& match) const;
+    
+    private:
+        static constexpr int ChunkCount = 4;
+        static constexpr int ChunkBits = 16;
+        static constexpr int MaxProbeDistance = 2;   // 每段最多翻转的位数，需要更多时改为线性扫描
+    
+        // 对某一段与查询的距离恰好为chunkDistance的条目调用visit(条目下标)，同一条目可能被多次访问
+        template <typename Visitor>
+        void visitChunkDistance(uint64_t hash, int chunkDistance, Visitor visit) const;
+    
+        std::vector<uint64_t> hashes;
+        std::vector<QString> ids;
+        std::unordered_map<uint16_t, std::vector<int>> tables[ChunkCount];
+    };
 }
 
 #endif // IMAGEPROCESSOR_H
\ No newline at end of file
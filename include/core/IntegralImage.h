@@ -0,0 +1,57 @@
+#ifndef INTEGRALIMAGE_H
+#define INTEGRALIMAGE_H
+
+#include <QImage>
+#include <QRect>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * IntegralImage - 积分图（和与平方和表）
+ *
+ * 供模板匹配、盒式模糊、区域均值颜色检查、自适应阈值等分析共用：
+ * 1. 每行的前缀和由PixelKernels::integralRowU8计算（SSE4.1/AVX2）
+ * 2. 多线程时按行分段，在TaskPool共享线程池上并行计算，再逐段加上前一段末行的累计值
+ * 3. 任意矩形的和与平方和都可O(1)查询
+ *
+ * 和表按2^32取模累加（每个元素4字节），只要所查询矩形的真实和小于2^32
+ * （8位数据约1680万像素以内）结果就是准确的；平方和表为64位。
+ */
+namespace IntegralImage {
+
+// 积分图所基于的通道
+enum class Channel {
+    Gray,    // 与qGray权重一致的灰度
+    Red,
+    Green,
+    Blue
+};
+
+// 积分图，尺寸为(width+1)*(height+1)，第0行和第0列为0
+struct Tables {
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> sum;
+    std::vector<uint64_t> squaredSum;
+
+    bool isEmpty() const { return width <= 0 || height <= 0; }
+
+    // 以(x, y)为左上角、w*h的矩形，调用方保证矩形位于图像内
+    int64_t rectSum(int x, int y, int w, int h) const;
+    int64_t rectSquaredSum(int x, int y, int w, int h) const;
+
+    // 矩形内的均值与方差，矩形超出图像的部分被忽略，为空时返回0
+    double rectMean(const QRect& rect) const;
+    double rectVariance(const QRect& rect) const;
+};
+
+// 由8位平面构建，stride为相邻两行的字节间隔；threadCount为参与计算的线程数（TaskPool工作线程中按1计）
+Tables build(const uint8_t* pixels, int width, int height, size_t stride, int threadCount = 1);
+
+// 由图像的指定通道构建
+Tables build(const QImage& image, Channel channel, int threadCount = 1);
+
+}
+
+#endif // INTEGRALIMAGE_H
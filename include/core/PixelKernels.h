@@ -0,0 +1,119 @@
+#ifndef PIXELKERNELS_H
+#define PIXELKERNELS_H
+
+#include <QString>
+#include <cstdint>
+#include <vector>
+
+/**
+ * PixelKernels - 像素行比较内核
+ *
+ * 模板匹配内循环使用的逐行SAD/SSD/点积运算、逐位置的行互相关、积分图的行前缀和、颜色范围掩码、行卷积及3x3邻域滤镜，分别提供：
+ * 1. 标量实现（所有平台可用）
+ * 2. SSE4.1实现
+ * 3. AVX2实现
+ *
+ * 运行时根据CPU特性选择最快的可用实现。除HSV色相使用单精度除法、边缘强度使用双精度开方
+ * （各实现运算顺序相同）外均为整数运算，结果与标量实现逐位一致。ARGB内核忽略alpha通道，只处理R/G/B三个通道。
+ */
+namespace PixelKernels {
+
+enum class Backend {
+    Scalar,
+    SSE41,
+    AVX2
+};
+
+// ========== 8位灰度 ==========
+uint32_t dotU8(const uint8_t* a, const uint8_t* b, int count);   // Σ a*b（count < 66051时不溢出）
+uint32_t sadU8(const uint8_t* a, const uint8_t* b, int count);   // Σ |a-b|
+uint32_t ssdU8(const uint8_t* a, const uint8_t* b, int count);   // Σ (a-b)²（count < 66051时不溢出）
+
+// ========== 32位ARGB ==========
+uint32_t sadArgb(const uint32_t* a, const uint32_t* b, int count);  // Σ |Δr|+|Δg|+|Δb|
+uint64_t ssdArgb(const uint32_t* a, const uint32_t* b, int count);  // Σ Δr²+Δg²+Δb²
+uint64_t dotArgb(const uint32_t* a, const uint32_t* b, int count);  // Σ ra*rb+ga*gb+ba*bb
+
+// ========== 积分图 ==========
+// 积分图的一行：sum[i] = sumAbove[i] + Σ src[0..i]（按2^32取模），squaredSum[i] = squaredAbove[i] + Σ src[0..i]²
+// sum/squaredSum可以分别与sumAbove/squaredAbove是同一数组（原地累加）
+void integralRowU8(const uint8_t* src, int count, const uint32_t* sumAbove, const uint64_t* squaredAbove,
+                   uint32_t* sum, uint64_t* squaredSum);
+
+// ========== 行互相关 ==========
+// 相邻两个像素打包为一个32位数：pairs[i] = src[i] | src[i+1] << 16，最后一项的高16位为0
+void pairRowU8(const uint8_t* src, int count, uint32_t* pairs);
+
+// 一行模板在源行count个连续位置上的互相关累加：acc[i] += Σ t[k]*s[i+k]，k∈[0,taps)，按2^32取模
+// sourcePairs与templatePairs分别为源行和模板行的pairRowU8结果，sourcePairs须有count+taps-1项
+void correlateRowU8(const uint32_t* sourcePairs, int count, const uint32_t* templatePairs, int taps, uint32_t* acc);
+
+// ========== 颜色范围掩码 ==========
+// HSV范围：色相为以60度为单位的扇区值，区间[hueLow, hueHigh)，hueLow > hueHigh表示跨越0度；
+// 饱和度（按255*(max-min)/max的实数值比较）与明度（max）为闭区间，取值0-255。
+// 饱和度为0的像素没有色相，只要求饱和度和明度在范围内
+struct HsvRange {
+    float hueLow = 0.0f;
+    float hueHigh = 6.0f;
+    int saturationLow = 0;
+    int saturationHigh = 255;
+    int valueLow = 0;
+    int valueHigh = 255;
+};
+
+// mask[i] = 255：src[i]的R/G/B分量都在low与high的对应分量之间（含边界），否则为0
+void rgbRangeMask(const uint32_t* src, int count, uint32_t low, uint32_t high, uint8_t* mask);
+
+// mask[i] = 255：src[i]的色相、饱和度、明度都在range内，否则为0
+void hsvRangeMask(const uint32_t* src, int count, const HsvRange& range, uint8_t* mask);
+
+// ========== 卷积 ==========
+// 一行ARGB的一维卷积，四个通道（含alpha）分别计算：
+// dst[i*dstStride] = clamp((Σ weights[k]*src[i+k] + 2^(ConvolutionShift-1)) >> ConvolutionShift, 0, 255)
+// src须有count+taps-1个像素（边界由调用方填充）；dstStride为输出像素间隔，便于直接写入转置缓冲
+constexpr int ConvolutionShift = 14;
+void convolveRowArgb(const uint32_t* src, int count, const int16_t* weights, int taps, uint32_t* dst, size_t dstStride);
+
+// ========== 3x3邻域滤镜 ==========
+// 以下内核计算一行中的count个像素，above/row/below为上一行、当前行、下一行中与第0个输出对齐的位置，
+// 须能访问下标-1与count（左右边界由调用方处理）
+
+// 拉普拉斯锐化：各颜色通道v = (256*c + weight*(4c - 左 - 右 - 上 - 下)) >> 8，截断到0-255，alpha保持不变
+// weight为锐化强度乘以256，取值0-32767
+void sharpenRowArgb(const uint32_t* above, const uint32_t* row, const uint32_t* below, int count, int weight, uint32_t* dst);
+
+// 与sharpenRowArgb相同的锐化，用于8位灰度
+void sharpenRowU8(const uint8_t* above, const uint8_t* row, const uint8_t* below, int count, int weight, uint8_t* dst);
+
+// Sobel边缘强度：m = clamp(int(sqrt(gx² + gy²) * intensity), 0, 255)，dst[i]为不透明灰度像素(m, m, m)
+void sobelRowGray(const uint8_t* above, const uint8_t* row, const uint8_t* below, int count, double intensity, uint32_t* dst);
+
+// ========== 后端选择 ==========
+
+// 当前使用的后端
+Backend activeBackend();
+
+// 本机CPU支持的最快后端
+Backend detectBackend();
+
+// 强制使用指定后端（用于对比测试），不支持时返回false并保持原后端
+bool setBackend(Backend backend);
+
+bool isBackendSupported(Backend backend);
+QString backendName(Backend backend);
+
+// ========== 微基准测试 ==========
+
+struct BenchmarkResult {
+    QString kernel;
+    Backend backend = Backend::Scalar;
+    double pixelsPerSecond = 0.0;
+};
+
+// 对每个受支持的后端和每个内核测量吞吐量（像素/秒），完成后恢复原后端
+// rowLength为每次调用处理的像素数，与常见模板宽度相当
+std::vector<BenchmarkResult> runBenchmark(int rowLength = 64, int totalPixels = 1 << 24);
+
+}
+
+#endif // PIXELKERNELS_H
@@ -0,0 +1,127 @@
+#ifndef REPLAYCAPTURESOURCE_H
+#define REPLAYCAPTURESOURCE_H
+
+#include <QFile>
+#include <QImage>
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include "core/CaptureSource.h"
+
+/**
+ * ReplayCaptureSource - 回放截图后端
+ *
+ * 按指定帧率回放图像序列（png/jpg/bmp，按文件名排序）或FrameRecorder录制的帧文件，
+ * 只依赖QtCore/QtGui，截图→分析→操作的整条流水线可以在Linux上运行和测量：
+ * 1. RealTime：按墙上时间回放，nextFrame返回当前时刻应显示的帧；
+ *    调用方跟不上帧率时跳过中间的帧（与真实截图一致），同一帧不会返回两次
+ * 2. Stepped：每次调用返回下一帧，与调用频率和机器速度无关，结果可重复
+ *
+ * 帧序号为帧在序列中的位置（从1开始，循环回放时继续递增），时间戳为返回帧时的Frame::currentTimestamp，
+ * 因此分析延迟的统计方式与真实截图相同。帧文件逐帧读入帧缓冲池的缓冲区；图像序列默认每帧解码一次，
+ * preload时在打开时全部解码，避免解码耗时影响测量。
+ */
+class ReplayCaptureSource : public CaptureSource
+{
+public:
+    enum class Pacing {
+        RealTime,
+        Stepped
+    };
+
+    explicit ReplayCaptureSource(double fps = 30.0, Pacing pacing = Pacing::RealTime);
+
+    // ========== 打开 ==========
+    // 返回帧数，失败时返回-1
+    int openImageSequence(const QString& directory, bool preload = false);
+    int openImageFiles(const QStringList& files, bool preload = false);
+    int openRecording(const QString& path);
+    void close();
+
+    // ========== 回放配置 ==========
+    void setFrameRate(double fps);
+    double getFrameRate() const { return frameRate; }
+    void setPacing(Pacing mode) { pacing = mode; }
+    Pacing getPacing() const { return pacing; }
+    void setLoop(bool enable) { loop = enable; }
+    bool isLooping() const { return loop; }
+
+    int frameCount() const;
+    int position() const { return nextIndex; }   // 下一次返回的帧（Stepped）
+    void seek(int index);
+    bool atEnd() const;                           // 不循环时所有帧都已返回
+
+    // ========== CaptureSource ==========
+    bool start() override;
+    void stop() override;
+    bool isRunning() const override { return running; }
+
+    Frame nextFrame() override;
+    QSize frameSize() const override { return currentSize; }
+    Frame::PixelFormat pixelFormat() const override { return currentFormat; }
+    QString name() const override { return "Replay"; }
+
+    FramePool::Statistics framePoolStatistics() const override { return framePool.statistics(); }
+
+private:
+    // 帧文件中一帧的位置
+    struct RecordedFrame {
+        qint64 offset = 0;           // 像素数据在文件中的偏移
+        int width = 0;
+        int height = 0;
+        qsizetype stride = 0;
+        Frame::PixelFormat format = Frame::PixelFormat::Bgra32;
+    };
+
+    Frame loadFrame(int index, quint64 sequence);
+
+    double frameRate;
+    Pacing pacing;
+    bool loop;
+    bool running;
+
+    // 图像序列
+    QStringList imageFiles;
+    std::vector<QImage> preloadedImages;   // 已转换为Frame可直接共享的格式
+
+    // 帧文件
+    QFile recording;
+    std::vector<RecordedFrame> recordedFrames;
+    FramePool framePool;
+
+    int nextIndex;               // Stepped模式的下一帧
+    qint64 startTimestamp;       // RealTime模式开始回放的时间
+    qint64 lastTick;             // RealTime模式上次返回的帧对应的时刻序号
+    quint64 frameSequence;
+    QSize currentSize;
+    Frame::PixelFormat currentFormat;
+};
+
+/**
+ * FrameRecorder - 帧文件录制
+ *
+ * 把截图帧按原始像素写入文件，供ReplayCaptureSource回放。文件格式（小端）：
+ *   文件头：8字节标识"QDFRAME1"
+ *   每帧：int32宽、int32高、int32像素格式（Frame::PixelFormat）、int32行字节数、int64时间戳，之后为逐行像素
+ * 行字节数为width * bytesPerPixel，不含对齐填充。
+ */
+class FrameRecorder
+{
+public:
+    static constexpr char Magic[9] = "QDFRAME1";
+
+    ~FrameRecorder();
+
+    bool open(const QString& path);
+    bool write(const Frame& frame);
+    void close();
+
+    bool isOpen() const { return file.isOpen(); }
+    int frameCount() const { return framesWritten; }
+
+private:
+    QFile file;
+    int framesWritten = 0;
+};
+
+#endif // REPLAYCAPTURESOURCE_H
@@ -0,0 +1,104 @@
+#ifndef SCREENSTATECLASSIFIER_H
+#define SCREENSTATECLASSIFIER_H
+
+#include <QImage>
+#include <QString>
+#include <QStringList>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "core/ImageProcessor.h"
+
+/**
+ * ScreenStateClassifier - 画面状态识别
+ *
+ * 回答"当前在哪个画面"，代替逐个调用templateMatch：
+ * 1. 从目录加载带标签的参考截图，每幅图像只保存紧凑的描述子
+ * 2. 描述子由64x64颜色缩略图得到：DCT感知哈希 + 4x4固定区域的颜色直方图
+ * 3. 分类时先用哈希索引找出汉明距离足够近的参考图，再用区域直方图确认
+ *
+ * 一帧只采样约6.5万个像素，1080p画面的分类耗时远低于1毫秒。
+ * 只依赖QtCore/QtGui，可在Linux上离线使用。
+ *
+ * 参考目录的组织方式：
+ *   references/main_menu.png          -> 标签 "main_menu"
+ *   references/battle/001.png         -> 标签 "battle"（子目录名，同一标签可有多幅参考图）
+ *
+ * 使用示例：
+ *   ScreenStateClassifier classifier;
+ *   classifier.loadDirectory("references");
+ *   ScreenStateClassifier::Classification result = classifier.classify(frame);
+ *   if (result.isValid()) { ... result.label ... }
+ */
+class ScreenStateClassifier
+{
+public:
+    // 缩略图边长与区域划分
+    static constexpr int ThumbnailSize = 64;
+    static constexpr int RegionGrid = 4;
+    static constexpr int RegionCount = RegionGrid * RegionGrid;
+    static constexpr int HistogramBits = 2;                            // 每通道保留的高位数
+    static constexpr int HistogramBins = 1 << (3 * HistogramBits);
+
+    // 画面描述子
+    struct Descriptor {
+        uint64_t hash = 0;                                              // 缩略图的DCT感知哈希
+        std::array<uint16_t, RegionCount * HistogramBins> histograms{}; // 各区域的颜色直方图（缩略图像素计数）
+    };
+
+    struct Parameters {
+        int maxHashDistance = 10;     // 候选参考图与画面的最大汉明距离
+        double hashWeight = 0.5;      // 置信度中哈希相似度的权重，其余为区域直方图交集
+        double minConfidence = 0.6;   // 低于此置信度时不给出标签
+    };
+
+    struct Classification {
+        QString label;                // 未识别时为空
+        double confidence = 0.0;      // 最佳候选的置信度，范围[0,1]
+        int hashDistance = -1;        // 最佳候选的汉明距离，没有候选时为-1
+        QString reference;            // 最佳候选的参考图来源
+
+        bool isValid() const { return !label.isEmpty(); }
+    };
+
+    ScreenStateClassifier();
+    explicit ScreenStateClassifier(const Parameters& parameters);
+
+    // ========== 参考图管理 ==========
+    // 加载目录中的图像（一级子目录中的图像以子目录名为标签），返回成功加载的数量，目录不存在时返回-1
+    int loadDirectory(const QString& directory);
+
+    bool addReference(const QString& label, const QImage& image, const QString& source = QString());
+    void clear();
+
+    int size() const { return static_cast<int>(references.size()); }
+    bool isEmpty() const { return references.empty(); }
+    QStringList labels() const;
+
+    // ========== 配置 ==========
+    void setParameters(const Parameters& parameters) { this->parameters = parameters; }
+    const Parameters& getParameters() const { return parameters; }
+
+    // ========== 分类 ==========
+    Classification classify(const QImage& frame) const;
+    Classification classify(const Descriptor& descriptor) const;
+
+    // 计算图像的描述子
+    static Descriptor describe(const QImage& image);
+
+    // 两个描述子各区域直方图交集的平均值，范围[0,1]
+    static double histogramSimilarity(const Descriptor& first, const Descriptor& second);
+
+private:
+    struct Reference {
+        QString label;
+        QString source;
+        Descriptor descriptor;
+    };
+
+    std::vector<Reference> references;
+    ImageProcessorUtils::PerceptualHashIndex hashIndex;   // 条目序号即references中的下标，id为标签
+    Parameters parameters;
+};
+
+#endif // SCREENSTATECLASSIFIER_H
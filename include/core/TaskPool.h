@@ -0,0 +1,122 @@
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 任务优先级：工作线程总是先取高优先级的任务
+enum class TaskPriority {
+    Low,
+    Normal,
+    High
+};
+
+/**
+ * CancellationToken - 取消标记
+ *
+ * 复制得到的标记共享同一状态。任务开始前检查标记，已取消的任务直接丢弃；
+ * 已开始的任务由任务本身决定是否检查。
+ */
+class CancellationToken {
+public:
+    CancellationToken() : state(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() const { state->store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return state->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> state;
+};
+
+/**
+ * TaskPool - 有界的工作窃取线程池
+ *
+ * 1. 线程数在[1, MaxThreads]之间，可随时调整：减少时多余的线程执行完当前任务后退出，不阻塞调用者
+ * 2. 每个线程有自己的任务队列（每个优先级一个），外部提交的任务轮流放入各线程的队列，
+ *    工作线程内提交的任务放入本线程的队列
+ * 3. 线程从自己队列的头部取任务，自己的队列为空时从其他线程队列的尾部窃取；
+ *    所有队列中的高优先级任务都取完之后才会取低一级的任务
+ * 4. 析构时丢弃尚未开始的任务，等待正在执行的任务结束
+ */
+class TaskPool {
+public:
+    using Task = std::function<void()>;
+
+    static constexpr int MaxThreads = 64;
+
+    explicit TaskPool(int threadCount = 1);
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    void setThreadCount(int threadCount);
+    int threadCount() const;
+
+    // 提交任务；token在任务开始前已取消时任务被丢弃
+    void submit(Task task, TaskPriority priority = TaskPriority::Normal,
+                const CancellationToken& token = CancellationToken());
+
+    // 尚未开始的任务数
+    int pendingCount() const { return pending.load(std::memory_order_relaxed); }
+
+    // 等待所有已提交的任务结束（不能在工作线程中调用）
+    void waitForIdle();
+
+    // 分叉/汇合：对[0, count)的每个下标执行一次body，返回时全部执行完毕。
+    // 调用线程同样领取下标执行，池中线程繁忙时由调用线程独自完成，因此可以在工作线程中调用
+    void parallelFor(int count, const std::function<void(int)>& body);
+
+    // 进程共享的线程池（核心数-1个线程，调用线程补足），供行条带、多模板匹配等同步并行算法使用，
+    // 避免每次调用创建线程。首次使用时创建
+    static TaskPool& shared();
+
+    // 把[0, height)行分成最多threadCount个水平条带（每个至少minRows行），在共享线程池上
+    // 执行body(条带下标, 起始行, 结束行)；在工作线程中调用时只有一个条带；返回条带数
+    static int forEachBand(int height, int threadCount, int minRows, const std::function<void(int, int, int)>& body);
+
+    // 当前线程是否为某个TaskPool的工作线程
+    static bool isWorkerThread();
+
+    // 并行算法（行条带、多模板匹配等）实际可用的线程数：在工作线程中返回1，否则返回threadCount。
+    // 线程池已按核心数并行执行多个任务，任务内部再创建线程只会超额订阅
+    static int nestedThreadCount(int threadCount);
+
+private:
+    static constexpr int PriorityCount = 3;
+
+    struct Entry {
+        Task task;
+        CancellationToken token;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Entry> queues[PriorityCount];
+        std::thread thread;
+        bool alive = false;   // 由mutex（线程池的）保护
+    };
+
+    void run(int index);
+    bool takeTask(int index, Entry& entry);
+    void startWorkers(int count);
+
+    std::vector<std::unique_ptr<Worker>> workers;   // 固定MaxThreads个槽位
+    mutable std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable idleCondition;
+    int activeCount = 0;            // 当前目标线程数，下标不小于它的线程退出
+    int unfinished = 0;             // 已提交但尚未结束的任务数
+    int nextQueue = 0;              // 外部提交轮流使用的队列
+    bool stopping = false;
+    std::atomic<int> pending{0};
+    std::atomic<int> slotCount{0};  // 启动过线程的槽位数，窃取时只查看这些槽位
+};
+
+#endif // TASKPOOL_H
@@ -0,0 +1,256 @@
+#ifndef TEMPLATEMATCHER_H
+#define TEMPLATEMATCHER_H
+
+#include <QImage>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <cstdint>
+#include <vector>
+#include "core/IntegralImage.h"
+
+/**
+ * TemplateMatcher - 模板匹配引擎
+ *
+ * 为ImageProcessor提供基于原始扫描行缓冲区的模板匹配实现：
+ * 1. 在8位灰度平面上计算归一化互相关(NCC)或平方差(SSD)定位候选位置
+ * 2. 源图像窗口的和/平方和通过积分图O(1)获取
+ * 3. 模板统计量在准备阶段一次性计算
+ * 4. 最终置信度沿用原有的RGB颜色差评分语义
+ *
+ * 设计原则：
+ * - 不依赖QColor/pixelColor，所有内循环直接访问scanLine
+ * - 源图像和模板的预处理结果可以复用
+ */
+namespace TemplateMatcher {
+
+// 匹配度量方式
+enum class MatchMethod {
+    CorrelationCoefficient,  // 归一化互相关（对亮度变化不敏感）
+    SquaredDifference        // 平方差（对纯色模板也有效）
+};
+
+// 互相关的计算方式
+enum class CorrelationBackend {
+    Automatic,  // 按运算量估算在空间域和频域之间自动选择
+    Spatial,    // 按行对所有位置累加模板各行的互相关（SIMD）
+    Frequency   // FFT按水平条带分块计算搜索范围内所有位置（每块约1M变换点）；过宽的搜索范围仍用空间域
+};
+
+// 8位灰度平面（行连续存储，无行填充）
+struct GrayPlane {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;
+
+    bool isEmpty() const { return width <= 0 || height <= 0; }
+    const uint8_t* row(int y) const { return pixels.data() + static_cast<size_t>(y) * width; }
+};
+
+// 积分图（和与平方和），尺寸为(width+1)*(height+1)
+using IntegralTables = IntegralImage::Tables;
+
+// 模板一行中参与比较的连续像素
+struct PixelSpan {
+    int row = 0;
+    int start = 0;
+    int length = 0;
+};
+
+// 模板alpha或掩码灰度低于此值的像素不参与评分
+constexpr int MaskThreshold = 128;
+
+// 预处理后的模板
+struct PreparedTemplate {
+    QImage color;            // ARGB32格式，用于计算最终置信度
+    GrayPlane gray;
+    int64_t sum = 0;         // 灰度和（掩码模板只统计有效像素，下同）
+    int64_t squaredSum = 0;  // 灰度平方和
+    double mean = 0.0;
+    double deviation = 0.0;  // sqrt(Σ(t-mean)²)
+
+    // 掩码模板：只有spans覆盖的像素参与评分，按行、列顺序排列
+    bool masked = false;
+    std::vector<PixelSpan> spans;
+    std::vector<QRect> blocks;   // 相邻行中起止相同的像素段合并成的矩形，用于从积分图求窗口和
+    int validPixelCount = 0;
+
+    // 金字塔各层（第i项为1/2^(i+1)分辨率，不含color）
+    std::vector<PreparedTemplate> pyramid;
+
+    bool isValid() const { return !gray.isEmpty() && (!masked || validPixelCount > 0); }
+    bool isFlat() const { return deviation <= 0.0; }
+    bool isMasked() const { return masked; }
+    int pixelCount() const { return masked ? validPixelCount : gray.width * gray.height; }
+    const PreparedTemplate& level(int index) const { return index == 0 ? *this : pyramid[index - 1]; }
+};
+
+// 预处理后的源图像
+struct PreparedSource {
+    QImage color;            // ARGB32格式
+    GrayPlane gray;
+    IntegralTables integral;
+
+    // 金字塔各层（第i项为1/2^(i+1)分辨率，不含color）
+    std::vector<PreparedSource> pyramid;
+
+    bool isValid() const { return !gray.isEmpty(); }
+    const PreparedSource& level(int index) const { return index == 0 ? *this : pyramid[index - 1]; }
+};
+
+// 金字塔搜索参数
+struct PyramidParameters {
+    int levels = 2;          // 降采样层数，每层缩小一半
+    int refineRadius = 2;    // 每个更精细层上围绕候选位置的搜索半径
+    int candidateCount = 8;  // 保留的候选数量：金字塔最粗层的候选，以及findBestMatchWithHint按颜色差评分重排前的峰值数
+};
+
+// 候选匹配位置
+struct MatchCandidate {
+    QPoint location;
+    double score = -1.0;       // 匹配度量得分，越大越好
+    double confidence = -1.0;  // 颜色差评分，仅由findAllMatches与findBestMatchWithHint填写
+};
+
+// 上次命中提示
+struct SearchHint {
+    bool valid = false;
+    QPoint location;              // 上次命中的模板左上角
+    int radius = 16;              // 在提示位置周围搜索的半径（像素）
+    double minConfidence = 0.9;   // 提示邻域内的置信度低于此值时回退到完整搜索
+};
+
+// 多目标匹配参数
+struct MultiMatchParameters {
+    double minConfidence = 0.9;       // 结果的最低置信度（颜色差评分）
+    double candidateThreshold = 0.7;  // 匹配度量得分低于此值的位置不计算置信度
+    double maxOverlap = 0.3;          // 两个结果框的交并比超过此值时只保留得分高者
+    int maxResults = 0;               // 结果数量上限，0表示不限
+};
+
+// 序贯相似性检测(SSDA)统计
+struct SequentialStatistics {
+    int64_t positions = 0;          // 评估的位置数
+    int64_t rejectedPositions = 0;  // 未比较完整个模板即放弃的位置数
+    int64_t comparedPixels = 0;     // 实际比较的像素数
+    int64_t skippedPixels = 0;      // 因提前放弃而跳过的像素数
+};
+
+// ========== 互相关方式 ==========
+
+// 全局设置，默认为Automatic；频域与空间域得到的互相关完全一致，只影响速度
+void setCorrelationBackend(CorrelationBackend backend);
+CorrelationBackend correlationBackend();
+
+// 按当前设置判断在positions（模板左上角范围）内搜索templ时是否使用频域计算
+bool usesFrequencyDomain(const PreparedTemplate& templ, const QRect& positions);
+
+// 空间域/频域耗时对比
+struct CorrelationBenchmark {
+    QSize templateSize;
+    double spatialMs = 0.0;
+    double frequencyMs = 0.0;
+    bool automaticUsesFrequency = false;  // Automatic模式下的选择
+};
+
+// 在sourceSize的随机灰度图像上，对每种模板尺寸分别强制使用空间域和频域完成一次全图搜索并计时
+// 模板较大时空间域可能耗时数秒，完成后恢复原设置
+std::vector<CorrelationBenchmark> benchmarkCorrelation(const QSize& sourceSize, const std::vector<QSize>& templateSizes);
+
+// ========== 预处理 ==========
+
+// 转换为匹配使用的ARGB32格式（已是32位格式时不复制）
+QImage toColorBuffer(const QImage& image);
+
+// 转换为灰度平面，权重与qGray一致
+GrayPlane toGrayPlane(const QImage& image);
+
+// 构建积分图
+IntegralTables buildIntegral(const GrayPlane& plane);
+
+// 2x2均值降采样
+GrayPlane downsample(const GrayPlane& plane);
+
+// pyramidLevels为额外构建的金字塔层数
+// mask非空时须与模板同尺寸，灰度不低于MaskThreshold的像素参与评分；
+// mask为空且模板带alpha通道时，alpha低于MaskThreshold的像素视为透明。没有被排除的像素时按普通模板处理
+PreparedTemplate prepareTemplate(const QImage& templateImage, int pyramidLevels = 0, const QImage& mask = QImage());
+PreparedSource prepareSource(const QImage& sourceImage, int pyramidLevels = 0);
+
+// 模板在最粗层至少保留的边长
+constexpr int MinPyramidTemplateSize = 4;
+
+// 根据模板尺寸和已构建的金字塔，计算实际可用的层数
+int usablePyramidLevels(const PreparedSource& source, const PreparedTemplate& templ, int requestedLevels);
+
+// ========== 评分 ==========
+
+// 单个位置的匹配度量得分
+double scoreAt(const PreparedSource& source, const PreparedTemplate& templ,
+               int x, int y, MatchMethod method = MatchMethod::CorrelationCoefficient);
+
+// 原有的RGB颜色差评分：1 - Σ(|dr|+|dg|+|db|) / (3*255*N)，范围[0,1]
+double colorScoreAt(const QImage& source, const QImage& templ, int x, int y);
+
+// 同上，掩码模板只统计有效像素
+double colorScoreAt(const QImage& source, const PreparedTemplate& templ, int x, int y);
+
+// 两幅图像中各自以origin为左上角、尺寸为size的区域之间的颜色差评分
+// 区域越界时返回-1
+double colorScore(const QImage& first, const QPoint& firstOrigin,
+                  const QImage& second, const QPoint& secondOrigin, const QSize& size);
+
+// ========== 搜索 ==========
+
+// 在左上角位于searchArea内的所有位置中查找得分最高者
+// searchArea为空时搜索全部有效位置
+MatchCandidate findBestMatch(const PreparedSource& source, const PreparedTemplate& templ,
+                             const QRect& searchArea = QRect(),
+                             MatchMethod method = MatchMethod::CorrelationCoefficient);
+
+// 由粗到精的金字塔搜索：最粗层全范围搜索候选，逐层在refineRadius邻域内细化
+// 返回的score为最精细层（原始分辨率）上的得分；可用层数为0时等价于findBestMatch
+MatchCandidate findBestMatchPyramid(const PreparedSource& source, const PreparedTemplate& templ,
+                                    const PyramidParameters& parameters,
+                                    const QRect& searchArea = QRect(),
+                                    MatchMethod method = MatchMethod::CorrelationCoefficient);
+
+// 单遍扫描查找所有匹配，边扫描边做非极大值抑制，只保留结果列表而不保存得分图
+// 达到maxResults后，新的不重叠结果替换得分最低的已保留结果；只有最低得分已达度量上限时才提前结束
+// 结果按得分从高到低排序
+std::vector<MatchCandidate> findAllMatches(const PreparedSource& source, const PreparedTemplate& templ,
+                                           const MultiMatchParameters& parameters,
+                                           const QRect& searchArea = QRect(),
+                                           MatchMethod method = MatchMethod::CorrelationCoefficient);
+
+// 两个同尺寸(width*height)匹配框的交并比
+double overlapRatio(const QPoint& a, const QPoint& b, int width, int height);
+
+// 先在提示位置邻域内以原始分辨率搜索，置信度不足时再在searchArea内完整搜索
+// 两种搜索都先按匹配度量保留candidateCount个相互分开的峰值，再在各峰值±1像素内按原有的颜色差评分重选，
+// 与原有实现一样返回颜色差评分最高的位置（得分相同时取扫描顺序靠前者），灰度度量只用于缩小范围
+// 返回结果已填写confidence；hintUsed指示结果是否来自提示邻域
+MatchCandidate findBestMatchWithHint(const PreparedSource& source, const PreparedTemplate& templ,
+                                     const SearchHint& hint, const PyramidParameters& parameters,
+                                     const QRect& searchArea = QRect(),
+                                     MatchMethod method = MatchMethod::CorrelationCoefficient,
+                                     bool* hintUsed = nullptr);
+
+// 序贯相似性检测：逐行累加RGB颜色差，部分误差超过当前最优或rejectConfidence对应的上限时放弃该位置
+// source为toColorBuffer的结果，只使用templ的color与掩码，返回的score与confidence均为原有的颜色差评分
+// 所有位置都被放弃时返回score为-1的候选；statistics非空时在其上累加本次统计
+MatchCandidate findBestMatchSequential(const QImage& source, const PreparedTemplate& templ,
+                                       double rejectConfidence = 0.0,
+                                       const QRect& searchArea = QRect(),
+                                       SequentialStatistics* statistics = nullptr);
+
+// 将"模板需完整落入的图像区域"转换为模板左上角的取值范围，区域小于模板时返回空矩形
+QRect positionsInRegion(const QRect& region, int templateWidth, int templateHeight);
+
+// 计算模板左上角的有效取值范围，与searchArea求交
+QRect validPositions(const PreparedSource& source, const PreparedTemplate& templ,
+                     const QRect& searchArea = QRect());
+
+}
+
+#endif // TEMPLATEMATCHER_H
@@ -0,0 +1,93 @@
+#ifndef TEMPLATESET_H
+#define TEMPLATESET_H
+
+#include <QImage>
+#include <QPoint>
+#include <QRect>
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include "core/ImageProcessor.h"
+#include "core/TemplateMatcher.h"
+
+/**
+ * TemplateSet - 批量模板匹配
+ *
+ * 针对"每帧检查数十个模板"的场景：
+ * 1. 模板在注册时完成预处理（颜色缓冲、灰度平面、统计量、金字塔）
+ * 2. 每帧的源图像只做一次预处理（灰度转换、积分图、金字塔）
+ * 3. 所有模板在TaskPool共享线程池上并行评估，不为每帧创建线程
+ * 4. 每个模板可指定固定的搜索区域，并记录上次命中位置用于下一帧优先搜索
+ *
+ * 使用示例：
+ *   TemplateSet templates;
+ *   templates.addTemplate("close_button", closeImage);
+ *   templates.addTemplate("reward_dialog", rewardImage);
+ *   std::vector<TemplateSet::MatchResult> results = templates.matchAll(frame);
+ */
+class TemplateSet
+{
+public:
+    // 单个模板的匹配结果
+    struct MatchResult {
+        QString templateId;
+        QPoint bestMatch;
+        double confidence = -1.0;   // 原始分辨率上的颜色差评分，模板大于源图像时为-1
+    };
+
+    explicit TemplateSet(const ImageProcessor::TemplateMatchOptions& options = ImageProcessor::TemplateMatchOptions());
+
+    // ========== 模板管理 ==========
+    // 同名模板会被替换；searchRegion为模板需完整落入的区域，空矩形表示整帧
+    // mask非空时须与模板同尺寸，只有灰度不低于128的像素参与比较
+    bool addTemplate(const QString& templateId, const QImage& templateImage, const QRect& searchRegion = QRect(),
+                     const QImage& mask = QImage());
+    bool removeTemplate(const QString& templateId);
+    void clear();
+    
+    bool contains(const QString& templateId) const;
+    int size() const { return static_cast<int>(entries.size()); }
+    bool isEmpty() const { return entries.empty(); }
+    QStringList templateIds() const;
+    
+    // 清除所有模板的上次命中位置
+    void clearHints();
+
+    // ========== 匹配配置 ==========
+    // 修改金字塔层数或useTemplateAlpha时会重新预处理已注册的模板（options.templateMask不使用）
+    void setMatchOptions(const ImageProcessor::TemplateMatchOptions& options);
+    const ImageProcessor::TemplateMatchOptions& getMatchOptions() const { return matchOptions; }
+    
+    // matchAll并行匹配的线程数；在TaskPool的任务中调用matchAll时只使用调用线程
+    void setThreadCount(int threadCount);
+    int getThreadCount() const { return threadCount; }
+
+    // ========== 匹配 ==========
+    // 对所有模板进行匹配，结果顺序与注册顺序一致
+    std::vector<MatchResult> matchAll(const QImage& frame) const;
+    std::vector<MatchResult> matchAll(const TemplateMatcher::PreparedSource& preparedFrame) const;
+
+    // 按当前配置预处理源图像，可在多个TemplateSet之间共享
+    TemplateMatcher::PreparedSource prepareFrame(const QImage& frame) const;
+
+private:
+    struct Entry {
+        QString id;
+        QImage image;                               // 原始模板，用于重新预处理
+        QImage mask;
+        TemplateMatcher::PreparedTemplate prepared;
+        QRect searchRegion;
+        
+        // 上次命中位置（matchAll中每个模板只由一个线程处理）
+        mutable bool hasLastHit = false;
+        mutable QPoint lastHit;
+    };
+
+    MatchResult matchEntry(const Entry& entry, const TemplateMatcher::PreparedSource& preparedFrame) const;
+
+    std::vector<Entry> entries;
+    ImageProcessor::TemplateMatchOptions matchOptions;
+    int threadCount;
+};
+
+#endif // TEMPLATESET_H
@@ -2,6 +2,8 @@
 #define WINDOWCAPTURE_H
 
 #include "core/CommonTypes.h"
+#include "core/CaptureSource.h"
+#include "core/Frame.h"
 #include <QObject>
 #include <QImage>
 #include <functional>
@@ -69,14 +71,30 @@ public:
     void setFrameRate(int fps);
     int getFrameRate() const { return frameRate; }
 
+    // ========== 截图后端 ==========
+    // initializeCapture使用GDI后端；也可以换成其他后端（如回放图像序列的ReplayCaptureSource），
+    // 之后同步与异步截图都从该后端取帧，startCapture时启动尚未运行的后端
+    void setCaptureSource(std::unique_ptr<CaptureSource> source);
+    CaptureSource* getCaptureSource() const { return captureSource.get(); }
+
     // ========== 同步捕获 ==========
+    // 从截图后端取一帧（GDI后端直接写入帧缓冲池中的缓冲区），之后只传递引用
+    Frame grabFrame();
+    // 同grabFrame，返回引用帧像素的QImage（RGB32，不复制）
     QImage captureFrame();
+    // 复制到调用者的缓冲区（每行width * 4字节，BGRX顺序；灰度帧转换为R=G=B）
     bool captureFrameToBuffer(uint8_t* buffer, size_t bufferSize, int& width, int& height);
 
     // ========== 异步捕获 ==========
     void enableAsyncCapture(bool enable) { asyncCaptureEnabled = enable; }
     bool isAsyncCaptureEnabled() const { return asyncCaptureEnabled; }
 
+    // ========== 帧缓冲池 ==========
+    // 截图后端的缓冲区复用统计；GDI后端的截图表面（DIB段与内存DC）只在目标窗口或尺寸变化时重建
+    FramePool::Statistics getFramePoolStatistics() const;
+    void setFramePoolCapacity(int buffersPerClass);
+    int getSurfaceRebuildCount() const;
+
     // ========== 窗口信息 ==========
     QSize getWindowSize() const;
     bool isWindowMinimized() const;
@@ -87,7 +105,8 @@ signals:
     void captureStateChanged(CaptureState newState, CaptureState oldState);
     void captureError(const QString& errorMessage);
     
-    // 异步捕获信号
+    // 异步捕获信号（三个信号共享同一帧的像素）
+    void frameAvailable(const Frame& frame);
     void frameReady(const QImage& frame);
     void frameCaptured(int width, int height, const uint8_t* data, size_t dataSize);
 
@@ -105,7 +124,6 @@ private:
     bool captureToTexture();
     QImage convertTextureToQImage();
     bool convertTextureToBuffer(uint8_t* buffer, size_t bufferSize, int& width, int& height);
-    QImage captureWindowInternal();  // 内部窗口捕获方法
     
     // ========== 格式转换 ==========
     QImage convertBGRAToQImage(const uint8_t* data, int width, int height);
@@ -135,6 +153,9 @@ private:
     QSize windowSize;
     std::vector<uint8_t> pixelBuffer;
     
+    // 截图后端
+    std::unique_ptr<CaptureSource> captureSource;
+    
     // 错误状态
     QString lastErrorMessage;
 };
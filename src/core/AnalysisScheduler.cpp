@@ -0,0 +1,262 @@
+#include "core/AnalysisScheduler.h"
+#include <algorithm>
+
+AnalysisScheduler::AnalysisScheduler(ImageProcessor* processor, QObject* parent)
+    : QObject(parent)
+    , processor(processor)
+{
+}
+
+AnalysisScheduler::~AnalysisScheduler()
+{
+    clear();
+}
+
+// ========== 任务管理 ==========
+
+bool AnalysisScheduler::addJob(const QString& jobId, Analysis analysis, TaskPriority priority)
+{
+    if (!analysis || findJob(jobId)) {
+        return false;
+    }
+    auto job = std::make_shared<Job>();
+    job->id = jobId;
+    job->analysis = std::move(analysis);
+    job->priority = priority;
+    jobs.push_back(job);
+    return true;
+}
+
+bool AnalysisScheduler::addTemplateJob(const QString& jobId, const TemplateSet& templates,
+                                       TemplateCallback callback, TaskPriority priority)
+{
+    // 副本只由本任务的分析函数访问，调用方修改原模板集不会与工作线程中的matchAll冲突
+    auto snapshot = std::make_shared<TemplateSet>(templates);
+    return addJob(jobId, [snapshot, callback](const QImage& frame, quint64 frameNumber) -> std::function<void()> {
+        std::vector<TemplateSet::MatchResult> results = snapshot->matchAll(frame);
+        return [callback, frameNumber, results = std::move(results)]() {
+            if (callback) {
+                callback(frameNumber, results);
+            }
+        };
+    }, priority);
+}
+
+bool AnalysisScheduler::addTextJob(const QString& jobId, const QRect& region, const QString& language,
+                                   TextCallback callback, TaskPriority priority)
+{
+    ImageProcessor* imageProcessor = processor;
+    return addJob(jobId, [imageProcessor, region, language, callback](const QImage& frame, quint64 frameNumber)
+                      -> std::function<void()> {
+        QString text;
+        ImageProcessor::ProcessResult result = ImageProcessor::ProcessResult::InvalidInput;
+        if (region.isNull() || frame.rect().contains(region)) {
+            result = imageProcessor->recognizeText(region.isNull() ? frame : frame.copy(region), text, language);
+        }
+        return [callback, frameNumber, result, text]() {
+            if (callback) {
+                callback(frameNumber, result, text);
+            }
+        };
+    }, priority);
+}
+
+bool AnalysisScheduler::addColorJob(const QString& jobId, const ImageProcessor::ColorRange& range,
+                                    const ImageProcessor::ColorBlobOptions& options, ColorCallback callback,
+                                    TaskPriority priority)
+{
+    ImageProcessor* imageProcessor = processor;
+    return addJob(jobId, [imageProcessor, range, options, callback](const QImage& frame, quint64 frameNumber)
+                      -> std::function<void()> {
+        std::vector<ImageProcessor::ColorBlob> blobs;
+        ImageProcessor::ProcessResult result = imageProcessor->findColorBlobs(frame, range, blobs, options);
+        return [callback, frameNumber, result, blobs = std::move(blobs)]() {
+            if (callback) {
+                callback(frameNumber, result, blobs);
+            }
+        };
+    }, priority);
+}
+
+bool AnalysisScheduler::removeJob(const QString& jobId)
+{
+    auto it = std::find_if(jobs.begin(), jobs.end(), [&jobId](const std::shared_ptr<Job>& job) {
+        return job->id == jobId;
+    });
+    if (it == jobs.end()) {
+        return false;
+    }
+    (*it)->removed = true;
+    (*it)->token.cancel();
+    (*it)->pendingFrame = QImage();
+    jobs.erase(it);
+    return true;
+}
+
+void AnalysisScheduler::clear()
+{
+    for (const std::shared_ptr<Job>& job : jobs) {
+        job->removed = true;
+        job->token.cancel();
+        job->pendingFrame = QImage();
+    }
+    jobs.clear();
+}
+
+bool AnalysisScheduler::contains(const QString& jobId) const
+{
+    return findJob(jobId) != nullptr;
+}
+
+QStringList AnalysisScheduler::jobIds() const
+{
+    QStringList ids;
+    for (const std::shared_ptr<Job>& job : jobs) {
+        ids.append(job->id);
+    }
+    return ids;
+}
+
+std::shared_ptr<AnalysisScheduler::Job> AnalysisScheduler::findJob(const QString& jobId) const
+{
+    for (const std::shared_ptr<Job>& job : jobs) {
+        if (job->id == jobId) {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+// ========== 帧提交 ==========
+
+quint64 AnalysisScheduler::submitFrame(const QImage& frame)
+{
+    return submitImage(frame, Frame::currentTimestamp());
+}
+
+quint64 AnalysisScheduler::submitFrame(const Frame& frame)
+{
+    return submitImage(frame.image(), frame.timestamp());
+}
+
+quint64 AnalysisScheduler::submitImage(const QImage& frame, qint64 submitted)
+{
+    const quint64 frameNumber = ++frameCounter;
+
+    for (const std::shared_ptr<Job>& job : jobs) {
+        ++job->statistics.framesSubmitted;
+        // 信箱中尚未开始的帧被新帧替换
+        if (job->hasPending) {
+            ++job->statistics.framesDropped;
+        }
+        job->hasPending = true;
+        job->pendingFrame = frame;
+        job->pendingNumber = frameNumber;
+        job->pendingSubmitted = submitted;
+        if (!job->running) {
+            startJob(job);
+        }
+    }
+    return frameNumber;
+}
+
+void AnalysisScheduler::startJob(const std::shared_ptr<Job>& job)
+{
+    const QImage frame = job->pendingFrame;
+    const quint64 frameNumber = job->pendingNumber;
+    const qint64 submitted = job->pendingSubmitted;
+    job->hasPending = false;
+    job->pendingFrame = QImage();
+    job->running = true;
+
+    ImageProcessor::AsyncOptions options;
+    options.priority = job->priority;
+    options.token = job->token;
+    options.context = this;
+
+    // 工作线程只使用分析函数与帧的副本，任务状态只在调度器线程中修改
+    Analysis analysis = job->analysis;
+    processor->submitAsync(options, [this, job, analysis, frame, frameNumber, submitted]() -> std::function<void()> {
+        std::function<void()> report = analysis(frame, frameNumber);
+        return [this, job, report, frameNumber, submitted]() {
+            finishJob(job, report, frameNumber, submitted);
+        };
+    });
+}
+
+void AnalysisScheduler::finishJob(const std::shared_ptr<Job>& job, const std::function<void()>& report,
+                                  quint64 frameNumber, qint64 submitted)
+{
+    job->running = false;
+    if (job->removed) {
+        return;
+    }
+
+    const double latencyMs = (Frame::currentTimestamp() - submitted) / 1e6;
+    Statistics& statistics = job->statistics;
+    ++statistics.framesAnalyzed;
+    statistics.lastLatencyMs = latencyMs;
+    statistics.maxLatencyMs = std::max(statistics.maxLatencyMs, latencyMs);
+    job->totalLatencyMs += latencyMs;
+    statistics.averageLatencyMs = job->totalLatencyMs / statistics.framesAnalyzed;
+
+    // 先开始分析信箱中的下一帧，再报告本帧结果
+    if (job->hasPending) {
+        startJob(job);
+    }
+    if (report) {
+        report();
+    }
+    emit analysisCompleted(job->id, frameNumber, latencyMs);
+}
+
+// ========== 统计 ==========
+
+AnalysisScheduler::Statistics AnalysisScheduler::statistics(const QString& jobId) const
+{
+    const std::shared_ptr<Job> job = findJob(jobId);
+    if (!job) {
+        return Statistics();
+    }
+    Statistics result = job->statistics;
+    result.queueDepth = job->hasPending ? 1 : 0;
+    result.inFlight = job->running ? 1 : 0;
+    return result;
+}
+
+AnalysisScheduler::Statistics AnalysisScheduler::totalStatistics() const
+{
+    Statistics total;
+    double totalLatencyMs = 0.0;
+    for (const std::shared_ptr<Job>& job : jobs) {
+        const Statistics& statistics = job->statistics;
+        total.framesSubmitted += statistics.framesSubmitted;
+        total.framesAnalyzed += statistics.framesAnalyzed;
+        total.framesDropped += statistics.framesDropped;
+        total.maxLatencyMs = std::max(total.maxLatencyMs, statistics.maxLatencyMs);
+        total.queueDepth += job->hasPending ? 1 : 0;
+        total.inFlight += job->running ? 1 : 0;
+        totalLatencyMs += job->totalLatencyMs;
+    }
+    if (total.framesAnalyzed > 0) {
+        total.averageLatencyMs = totalLatencyMs / total.framesAnalyzed;
+    }
+    return total;
+}
+
+int AnalysisScheduler::queueDepth() const
+{
+    int depth = 0;
+    for (const std::shared_ptr<Job>& job : jobs) {
+        depth += job->hasPending ? 1 : 0;
+    }
+    return depth;
+}
+
+void AnalysisScheduler::resetStatistics()
+{
+    for (const std::shared_ptr<Job>& job : jobs) {
+        job->statistics = Statistics();
+        job->totalLatencyMs = 0.0;
+    }
+}
@@ -0,0 +1,233 @@
+#include "core/ColorSignature.h"
+#include "core/TaskPool.h"
+#include <algorithm>
+
+namespace ColorSignature {
+
+namespace {
+
+// 建索引时每个条带至少的行数
+const int MinRowsPerBand = 64;
+
+inline int binOf(QRgb pixel)
+{
+    const int shift = 8 - BinBits;
+    return ((qRed(pixel) >> shift) << (2 * BinBits)) | ((qGreen(pixel) >> shift) << BinBits) | (qBlue(pixel) >> shift);
+}
+
+// 与point的颜色范围重叠的格子在每个通道上的下标范围
+struct BinBox {
+    int low[3];
+    int high[3];
+};
+
+BinBox binBox(const Point& point)
+{
+    const int shift = 8 - BinBits;
+    const int channels[3] = {qRed(point.color), qGreen(point.color), qBlue(point.color)};
+    BinBox box;
+    for (int c = 0; c < 3; ++c) {
+        box.low[c] = std::max(0, channels[c] - point.tolerance) >> shift;
+        box.high[c] = std::min(255, channels[c] + point.tolerance) >> shift;
+    }
+    return box;
+}
+
+template <typename Visit>
+void forEachBin(const BinBox& box, Visit&& visit)
+{
+    for (int r = box.low[0]; r <= box.high[0]; ++r) {
+        for (int g = box.low[1]; g <= box.high[1]; ++g) {
+            for (int b = box.low[2]; b <= box.high[2]; ++b) {
+                visit((r << (2 * BinBits)) | (g << BinBits) | b);
+            }
+        }
+    }
+}
+
+inline QRgb pixelAt(const QImage& colorBuffer, int x, int y)
+{
+    return reinterpret_cast<const QRgb*>(colorBuffer.constScanLine(y))[x];
+}
+
+// 所有点都落在图像内的锚点范围
+QRect anchorRange(const std::vector<Point>& points, int width, int height)
+{
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;
+    for (const Point& point : points) {
+        minX = std::min(minX, point.offset.x());
+        minY = std::min(minY, point.offset.y());
+        maxX = std::max(maxX, point.offset.x());
+        maxY = std::max(maxY, point.offset.y());
+    }
+    return QRect(QPoint(-minX, -minY), QPoint(width - 1 - maxX, height - 1 - maxY));
+}
+
+// 从第first个点开始依次检查其余各点
+bool remainingMatch(const QImage& colorBuffer, const std::vector<Point>& points, size_t first, int x, int y)
+{
+    for (size_t i = first; i < points.size(); ++i) {
+        const Point& point = points[i];
+        if (!pointMatches(pixelAt(colorBuffer, x + point.offset.x(), y + point.offset.y()), point)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<QPoint> scanArea(const QImage& colorBuffer, const std::vector<Point>& points, const QRect& area, int maxResults)
+{
+    std::vector<QPoint> anchors;
+    const Point& first = points.front();
+    for (int y = area.top(); y <= area.bottom(); ++y) {
+        const QRgb* row = reinterpret_cast<const QRgb*>(colorBuffer.constScanLine(y + first.offset.y())) + first.offset.x();
+        for (int x = area.left(); x <= area.right(); ++x) {
+            if (pointMatches(row[x], first) && remainingMatch(colorBuffer, points, 1, x, y)) {
+                anchors.emplace_back(x, y);
+                if (maxResults > 0 && static_cast<int>(anchors.size()) >= maxResults) {
+                    return anchors;
+                }
+            }
+        }
+    }
+    return anchors;
+}
+
+}
+
+size_t FrameIndex::candidateCount(const Point& point) const
+{
+    size_t count = 0;
+    forEachBin(binBox(point), [this, &count](int bin) {
+        count += binStart[bin + 1] - binStart[bin];
+    });
+    return count;
+}
+
+// ========== 索引 ==========
+
+FrameIndex buildIndex(const QImage& colorBuffer, int threadCount)
+{
+    FrameIndex index;
+    if (colorBuffer.isNull() || colorBuffer.depth() != 32) {
+        return index;
+    }
+    index.width = colorBuffer.width();
+    index.height = colorBuffer.height();
+    const int width = index.width;
+    threadCount = std::max(1, threadCount);
+
+    // 计数排序：各条带分别统计每格的像素数，按(格, 条带)顺序分配写入位置后再并行写入，
+    // 同一格内的位置仍保持光栅顺序
+    std::vector<std::vector<uint32_t>> counts(threadCount, std::vector<uint32_t>(BinCount, 0));
+    const int bandCount = TaskPool::forEachBand(index.height, threadCount, MinRowsPerBand,
+                                                [&](int band, int first, int last) {
+        uint32_t* count = counts[band].data();
+        for (int y = first; y < last; ++y) {
+            const QRgb* row = reinterpret_cast<const QRgb*>(colorBuffer.constScanLine(y));
+            for (int x = 0; x < width; ++x) {
+                ++count[binOf(row[x])];
+            }
+        }
+    });
+
+    index.binStart.assign(BinCount + 1, 0);
+    uint32_t offset = 0;
+    for (int bin = 0; bin < BinCount; ++bin) {
+        index.binStart[bin] = offset;
+        for (int band = 0; band < bandCount; ++band) {
+            const uint32_t count = counts[band][bin];
+            counts[band][bin] = offset;
+            offset += count;
+        }
+    }
+    index.binStart[BinCount] = offset;
+    index.positions.resize(offset);
+
+    TaskPool::forEachBand(index.height, threadCount, MinRowsPerBand, [&](int band, int first, int last) {
+        uint32_t* next = counts[band].data();
+        uint32_t* positions = index.positions.data();
+        for (int y = first; y < last; ++y) {
+            const QRgb* row = reinterpret_cast<const QRgb*>(colorBuffer.constScanLine(y));
+            const uint32_t rowStart = static_cast<uint32_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                positions[next[binOf(row[x])]++] = rowStart + x;
+            }
+        }
+    });
+    return index;
+}
+
+// ========== 匹配 ==========
+
+bool matchAt(const QImage& colorBuffer, const std::vector<Point>& points, const QPoint& anchor)
+{
+    if (points.empty() || colorBuffer.isNull()) {
+        return false;
+    }
+    if (!anchorRange(points, colorBuffer.width(), colorBuffer.height()).contains(anchor)) {
+        return false;
+    }
+    return remainingMatch(colorBuffer, points, 0, anchor.x(), anchor.y());
+}
+
+std::vector<QPoint> find(const QImage& colorBuffer, const FrameIndex& index, const std::vector<Point>& points,
+                         const QRect& searchArea, int maxResults)
+{
+    if (points.empty() || colorBuffer.isNull()) {
+        return {};
+    }
+    const QRect area = anchorRange(points, colorBuffer.width(), colorBuffer.height()).intersected(searchArea);
+    if (area.isEmpty()) {
+        return {};
+    }
+    const bool indexed = !index.isEmpty() && index.width == colorBuffer.width() && index.height == colorBuffer.height();
+
+    // 按候选像素数从少到多排序，最有区分度的点最先检查
+    std::vector<Point> ordered = points;
+    if (indexed) {
+        std::vector<std::pair<size_t, size_t>> counts;
+        counts.reserve(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            counts.emplace_back(index.candidateCount(points[i]), i);
+        }
+        std::sort(counts.begin(), counts.end());
+        for (size_t i = 0; i < counts.size(); ++i) {
+            ordered[i] = points[counts[i].second];
+        }
+        if (counts.front().first == 0) {
+            return {};
+        }
+        if (counts.front().first >= static_cast<size_t>(area.width()) * area.height()) {
+            return scanArea(colorBuffer, ordered, area, maxResults);
+        }
+    } else {
+        return scanArea(colorBuffer, ordered, area, maxResults);
+    }
+
+    std::vector<QPoint> anchors;
+    const Point& first = ordered.front();
+    const int width = index.width;
+    forEachBin(binBox(first), [&](int bin) {
+        for (uint32_t i = index.binStart[bin]; i < index.binStart[bin + 1]; ++i) {
+            const int x = static_cast<int>(index.positions[i] % width);
+            const int y = static_cast<int>(index.positions[i] / width);
+            const int anchorX = x - first.offset.x();
+            const int anchorY = y - first.offset.y();
+            if (area.contains(QPoint(anchorX, anchorY)) && pointMatches(pixelAt(colorBuffer, x, y), first) &&
+                remainingMatch(colorBuffer, ordered, 1, anchorX, anchorY)) {
+                anchors.emplace_back(anchorX, anchorY);
+            }
+        }
+    });
+
+    std::sort(anchors.begin(), anchors.end(), [](const QPoint& a, const QPoint& b) {
+        return a.y() != b.y() ? a.y() < b.y() : a.x() < b.x();
+    });
+    if (maxResults > 0 && anchors.size() > static_cast<size_t>(maxResults)) {
+        anchors.resize(maxResults);
+    }
+    return anchors;
+}
+
+}
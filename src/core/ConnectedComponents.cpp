@@ -0,0 +1,178 @@
+#include "core/ConnectedComponents.h"
+#include "core/TaskPool.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ConnectedComponents {
+
+namespace {
+
+// 每个条带至少的行数，行数太少时线程开销超过收益
+const int MinRowsPerBand = 32;
+
+const uint64_t LowBits = 0x0101010101010101ull;
+const uint64_t HighBits = 0x8080808080808080ull;
+
+inline uint64_t loadWord(const uint8_t* p)
+{
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+// 提取一行中的行程：按8字节一组跳过全0或全非0的区段
+void extractRuns(const uint8_t* row, int width, int y, std::vector<Run>& runs)
+{
+    int x = 0;
+    while (x < width) {
+        while (x + 8 <= width && loadWord(row + x) == 0) {
+            x += 8;
+        }
+        while (x < width && !row[x]) {
+            ++x;
+        }
+        if (x >= width) {
+            break;
+        }
+
+        const int start = x;
+        while (x + 8 <= width) {
+            const uint64_t word = loadWord(row + x);
+            if ((word - LowBits) & ~word & HighBits) {   // 含有0字节
+                break;
+            }
+            x += 8;
+        }
+        while (x < width && row[x]) {
+            ++x;
+        }
+        runs.push_back(Run{y, start, x});
+    }
+}
+
+// 并查集，根始终是集合中下标最小（光栅顺序最早）的行程
+int findRoot(std::vector<int>& parent, int i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+void unite(std::vector<int>& parent, int a, int b)
+{
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a < b) {
+        parent[b] = a;
+    } else if (b < a) {
+        parent[a] = b;
+    }
+}
+
+// 合并相邻两行中相互接触的行程，行程下标范围分别为[previous, current)和[current, end)
+void uniteRows(const std::vector<Run>& runs, std::vector<int>& parent,
+               int previous, int current, int end, int slack)
+{
+    int p = previous;
+    for (int c = current; c < end; ++c) {
+        while (p < current && runs[p].end + slack <= runs[c].start) {
+            ++p;
+        }
+        for (int q = p; q < current && runs[q].start < runs[c].end + slack; ++q) {
+            unite(parent, q, c);
+        }
+    }
+}
+
+}
+
+QPointF Component::centroid() const
+{
+    if (pixelCount <= 0) {
+        return QPointF();
+    }
+    return QPointF(static_cast<double>(sumX) / pixelCount, static_cast<double>(sumY) / pixelCount);
+}
+
+Labeling label(const uint8_t* mask, int width, int height, size_t stride, Connectivity connectivity, int threadCount)
+{
+    Labeling result;
+    if (!mask || width <= 0 || height <= 0) {
+        return result;
+    }
+    const int slack = connectivity == Connectivity::Eight ? 1 : 0;
+
+    // 第一遍：各条带独立提取行程并合并条带内的相邻行
+    struct Band {
+        std::vector<Run> runs;
+        std::vector<int> parent;
+        std::vector<int> rowStart;   // 每行第一个行程在runs中的下标，末尾为runs.size()
+    };
+    const int maxBands = std::max(1, std::min(threadCount, height / MinRowsPerBand));
+    std::vector<Band> bands(maxBands);
+
+    const int bandCount = TaskPool::forEachBand(height, threadCount, MinRowsPerBand, [&](int index, int first, int last) {
+        Band& band = bands[index];
+        band.rowStart.reserve(last - first + 1);
+        for (int y = first; y < last; ++y) {
+            band.rowStart.push_back(static_cast<int>(band.runs.size()));
+            extractRuns(mask + static_cast<size_t>(y) * stride, width, y, band.runs);
+        }
+        band.rowStart.push_back(static_cast<int>(band.runs.size()));
+
+        band.parent.resize(band.runs.size());
+        for (size_t i = 0; i < band.parent.size(); ++i) {
+            band.parent[i] = static_cast<int>(i);
+        }
+        for (int row = 1; row < last - first; ++row) {
+            uniteRows(band.runs, band.parent, band.rowStart[row - 1], band.rowStart[row], band.rowStart[row + 1], slack);
+        }
+    });
+    bands.resize(bandCount);
+
+    // 拼接各条带，并合并条带接缝处的相邻两行
+    std::vector<int> parent;
+    int previousLastRow = 0;   // 上一条带最后一行第一个行程的全局下标，该行结束于本条带的起点
+    for (int index = 0; index < bandCount; ++index) {
+        Band& band = bands[index];
+        const int offset = static_cast<int>(result.runs.size());
+        result.runs.insert(result.runs.end(), band.runs.begin(), band.runs.end());
+        for (int p : band.parent) {
+            parent.push_back(p + offset);
+        }
+
+        if (index > 0) {
+            uniteRows(result.runs, parent, previousLastRow, offset, offset + band.rowStart[1], slack);
+        }
+        previousLastRow = offset + band.rowStart[band.rowStart.size() - 2];
+        band = Band();
+    }
+
+    // 第二遍：根总是先于集合中的其他行程出现，按光栅顺序分配连通域编号并累计统计量
+    result.runLabels.resize(result.runs.size());
+    for (size_t i = 0; i < result.runs.size(); ++i) {
+        const int root = findRoot(parent, static_cast<int>(i));
+        const Run& run = result.runs[i];
+        const int length = run.end - run.start;
+
+        if (root == static_cast<int>(i)) {
+            result.runLabels[i] = static_cast<int>(result.components.size());
+            Component component;
+            component.bounds = QRect(run.start, run.row, length, 1);
+            result.components.push_back(component);
+        } else {
+            result.runLabels[i] = result.runLabels[root];
+        }
+
+        Component& component = result.components[result.runLabels[i]];
+        component.bounds = component.bounds.united(QRect(run.start, run.row, length, 1));
+        component.pixelCount += length;
+        component.sumX += static_cast<int64_t>(run.start + run.end - 1) * length / 2;
+        component.sumY += static_cast<int64_t>(run.row) * length;
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,278 @@
+#include "core/FftCorrelation.h"
+#include <algorithm>
+#include <cmath>
+
+namespace FftCorrelation {
+
+namespace {
+
+const double Pi = 3.14159265358979323846;
+
+// 对前rows行做行变换（正变换时其余行全为0，变换结果仍为0；逆变换时只需输出行）
+void transformRows(std::vector<Complex>& data, int width, int rows, const Transform1D& plan)
+{
+    std::vector<Complex> buffer(width);
+    for (int y = 0; y < rows; ++y) {
+        Complex* row = data.data() + static_cast<size_t>(y) * width;
+        plan.run(row, buffer.data());
+        std::copy(buffer.begin(), buffer.end(), row);
+    }
+}
+
+void transformColumns(std::vector<Complex>& data, int width, int height, const Transform1D& plan)
+{
+    std::vector<Complex> buffer(height);
+    for (int x = 0; x < width; ++x) {
+        plan.run(data.data() + x, buffer.data(), width);
+        for (int y = 0; y < height; ++y) {
+            data[static_cast<size_t>(y) * width + x] = buffer[y];
+        }
+    }
+}
+
+}
+
+// ========== 一维变换 ==========
+
+Transform1D::Transform1D(int size, bool inverse)
+    : length(std::max(1, size))
+    , inverse(inverse)
+{
+    // 优先分解出4，其次2、3、5，剩余的质因子由通用蝶形处理
+    int n = length;
+    int p = 4;
+    const int limit = static_cast<int>(std::floor(std::sqrt(static_cast<double>(n))));
+    while (n > 1) {
+        while (n % p) {
+            switch (p) {
+                case 4: p = 2; break;
+                case 2: p = 3; break;
+                default: p += 2; break;
+            }
+            if (p > limit) {
+                p = n;
+            }
+        }
+        n /= p;
+        factors.push_back(p);
+        factors.push_back(n);
+    }
+    if (factors.empty()) {
+        factors.push_back(1);
+        factors.push_back(1);
+    }
+
+    twiddles.resize(length);
+    const double sign = inverse ? 1.0 : -1.0;
+    for (int i = 0; i < length; ++i) {
+        const double phase = sign * 2.0 * Pi * i / length;
+        twiddles[i] = Complex(std::cos(phase), std::sin(phase));
+    }
+}
+
+void Transform1D::run(const Complex* in, Complex* out, int stride) const
+{
+    if (length == 1) {
+        out[0] = in[0];
+        return;
+    }
+    work(out, in, stride, 1, factors.data());
+}
+
+void Transform1D::work(Complex* out, const Complex* in, int inputStride, size_t fstride, const int* factor) const
+{
+    const int p = factor[0];
+    const int m = factor[1];
+    Complex* const begin = out;
+    Complex* const end = out + static_cast<size_t>(p) * m;
+    const size_t step = fstride * static_cast<size_t>(inputStride);
+
+    if (m == 1) {
+        for (Complex* current = out; current != end; ++current, in += step) {
+            *current = *in;
+        }
+    } else {
+        for (Complex* current = out; current != end; current += m, in += step) {
+            work(current, in, inputStride, fstride * p, factor + 2);
+        }
+    }
+
+    switch (p) {
+        case 2: butterfly2(begin, fstride, m); break;
+        case 4: butterfly4(begin, fstride, m); break;
+        default: butterflyGeneric(begin, fstride, m, p); break;
+    }
+}
+
+void Transform1D::butterfly2(Complex* out, size_t fstride, int m) const
+{
+    Complex* second = out + m;
+    const Complex* twiddle = twiddles.data();
+    for (int k = 0; k < m; ++k) {
+        const Complex t = second[k] * *twiddle;
+        twiddle += fstride;
+        second[k] = out[k] - t;
+        out[k] += t;
+    }
+}
+
+void Transform1D::butterfly4(Complex* out, size_t fstride, int m) const
+{
+    const Complex* twiddle1 = twiddles.data();
+    const Complex* twiddle2 = twiddles.data();
+    const Complex* twiddle3 = twiddles.data();
+    const int m2 = 2 * m;
+    const int m3 = 3 * m;
+
+    for (int k = 0; k < m; ++k, ++out) {
+        const Complex s0 = out[m] * *twiddle1;
+        const Complex s1 = out[m2] * *twiddle2;
+        const Complex s2 = out[m3] * *twiddle3;
+        twiddle1 += fstride;
+        twiddle2 += fstride * 2;
+        twiddle3 += fstride * 3;
+
+        const Complex s5 = out[0] - s1;
+        const Complex s4 = s0 - s2;
+        const Complex s3 = s0 + s2;
+        const Complex s6 = out[0] + s1;
+
+        out[m2] = s6 - s3;
+        out[0] = s6 + s3;
+        if (inverse) {
+            out[m] = Complex(s5.real() - s4.imag(), s5.imag() + s4.real());
+            out[m3] = Complex(s5.real() + s4.imag(), s5.imag() - s4.real());
+        } else {
+            out[m] = Complex(s5.real() + s4.imag(), s5.imag() - s4.real());
+            out[m3] = Complex(s5.real() - s4.imag(), s5.imag() + s4.real());
+        }
+    }
+}
+
+void Transform1D::butterflyGeneric(Complex* out, size_t fstride, int m, int p) const
+{
+    // 3、5等小基数使用栈上暂存，其他质因子才分配堆内存
+    Complex fixedScratch[5];
+    std::vector<Complex> dynamicScratch;
+    Complex* scratch = fixedScratch;
+    if (p > 5) {
+        dynamicScratch.resize(p);
+        scratch = dynamicScratch.data();
+    }
+
+    for (int u = 0; u < m; ++u) {
+        for (int q = 0, k = u; q < p; ++q, k += m) {
+            scratch[q] = out[k];
+        }
+        for (int q1 = 0, k = u; q1 < p; ++q1, k += m) {
+            size_t twiddleIndex = 0;
+            Complex value = scratch[0];
+            for (int q = 1; q < p; ++q) {
+                twiddleIndex += fstride * k;
+                twiddleIndex %= static_cast<size_t>(length);
+                value += scratch[q] * twiddles[twiddleIndex];
+            }
+            out[k] = value;
+        }
+    }
+}
+
+// ========== 互相关 ==========
+
+int nextFastSize(int n)
+{
+    n = std::max(1, n);
+    for (;; ++n) {
+        int remaining = n;
+        for (int factor : {2, 3, 5}) {
+            while (remaining % factor == 0) {
+                remaining /= factor;
+            }
+        }
+        if (remaining == 1) {
+            return n;
+        }
+    }
+}
+
+double transformCost(int windowWidth, int windowHeight)
+{
+    const double points = static_cast<double>(nextFastSize(windowWidth)) * nextFastSize(windowHeight);
+    return points * std::log2(std::max(2.0, points));
+}
+
+std::vector<int64_t> crossCorrelate(const uint8_t* source, int sourceStride, int windowWidth, int windowHeight,
+                                    const uint8_t* templ, int templateStride, int templateWidth, int templateHeight)
+{
+    const int outputWidth = windowWidth - templateWidth + 1;
+    const int outputHeight = windowHeight - templateHeight + 1;
+    if (templateWidth <= 0 || templateHeight <= 0 || outputWidth <= 0 || outputHeight <= 0) {
+        return {};
+    }
+
+    // 位置x+k不超过windowWidth-1，循环卷积不会回绕，变换尺寸只需覆盖窗口
+    const int width = nextFastSize(windowWidth);
+    const int height = nextFastSize(windowHeight);
+
+    // 实部为源图像，虚部为模板，一次复数变换同时得到两者的频谱
+    std::vector<Complex> data(static_cast<size_t>(width) * height);
+    for (int y = 0; y < windowHeight; ++y) {
+        const uint8_t* src = source + static_cast<size_t>(y) * sourceStride;
+        Complex* dst = data.data() + static_cast<size_t>(y) * width;
+        for (int x = 0; x < windowWidth; ++x) {
+            dst[x].real(src[x]);
+        }
+    }
+    for (int y = 0; y < templateHeight; ++y) {
+        const uint8_t* src = templ + static_cast<size_t>(y) * templateStride;
+        Complex* dst = data.data() + static_cast<size_t>(y) * width;
+        for (int x = 0; x < templateWidth; ++x) {
+            dst[x].imag(src[x]);
+        }
+    }
+
+    const Transform1D forwardRows(width, false);
+    const Transform1D forwardColumns(height, false);
+    transformRows(data, width, windowHeight, forwardRows);
+    transformColumns(data, width, height, forwardColumns);
+
+    // 拆分频谱：S[k] = (Z[k] + conj(Z[-k]))/2，T[k] = (Z[k] - conj(Z[-k]))/2i
+    // 互相关频谱 R[k] = S[k] * conj(T[k])，且 R[-k] = conj(R[k])
+    for (int ky = 0; ky < height; ++ky) {
+        const int negativeY = (height - ky) % height;
+        for (int kx = 0; kx < width; ++kx) {
+            const int negativeX = (width - kx) % width;
+            const size_t index = static_cast<size_t>(ky) * width + kx;
+            const size_t negativeIndex = static_cast<size_t>(negativeY) * width + negativeX;
+            if (negativeIndex < index) {
+                continue;
+            }
+
+            const Complex z = data[index];
+            const Complex zn = std::conj(data[negativeIndex]);
+            const Complex s = (z + zn) * 0.5;
+            const Complex t = (z - zn) * Complex(0.0, -0.5);
+            const Complex r = s * std::conj(t);
+            data[index] = r;
+            data[negativeIndex] = std::conj(r);
+        }
+    }
+
+    const Transform1D inverseRows(width, true);
+    const Transform1D inverseColumns(height, true);
+    transformColumns(data, width, height, inverseColumns);
+    transformRows(data, width, outputHeight, inverseRows);
+
+    const double scale = 1.0 / (static_cast<double>(width) * height);
+    std::vector<int64_t> result(static_cast<size_t>(outputWidth) * outputHeight);
+    for (int y = 0; y < outputHeight; ++y) {
+        const Complex* src = data.data() + static_cast<size_t>(y) * width;
+        int64_t* dst = result.data() + static_cast<size_t>(y) * outputWidth;
+        for (int x = 0; x < outputWidth; ++x) {
+            dst[x] = std::llround(src[x].real() * scale);
+        }
+    }
+    return result;
+}
+
+}
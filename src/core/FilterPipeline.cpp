@@ -0,0 +1,212 @@
+#include "core/FilterPipeline.h"
+#include "core/ImageFilters.h"
+#include "core/TaskPool.h"
+#include "core/TemplateMatcher.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// 每个条带至少的行数
+const int MinRowsPerBand = 64;
+
+// 每块至少的行数，避免边缘行的重复计算占比过高
+const int MinTileRows = 8;
+
+}
+
+FilterPipeline& FilterPipeline::crop(const QRect& rect)
+{
+    cropRect = rect;
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::grayscale()
+{
+    Stage stage;
+    stage.operation = Operation::Grayscale;
+    stages.push_back(stage);
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::sharpen(double intensity)
+{
+    Stage stage;
+    stage.operation = Operation::Sharpen;
+    stage.weight = ImageFilters::sharpenWeight(intensity);
+    stages.push_back(stage);
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::threshold(int level)
+{
+    Stage stage;
+    stage.operation = Operation::Threshold;
+    stage.level = level;
+    stages.push_back(stage);
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::negative()
+{
+    Stage stage;
+    stage.operation = Operation::Negative;
+    stages.push_back(stage);
+    return *this;
+}
+
+void FilterPipeline::clear()
+{
+    cropRect = QRect();
+    stages.clear();
+}
+
+std::vector<FilterPipeline::Segment> FilterPipeline::buildSegments(bool grayInput) const
+{
+    std::vector<Segment> segments;
+    Segment current;
+    current.grayInput = grayInput;
+    current.grayOutput = grayInput;
+
+    for (const Stage& stage : stages) {
+        if (stage.operation == Operation::Sharpen) {
+            // 第一段没有逐像素操作时，第一次锐化直接读取输入图像
+            if (!segments.empty() || current.sharpen || !current.pixelStages.empty()) {
+                segments.push_back(current);
+            }
+            const bool gray = current.grayOutput;
+            current = Segment();
+            current.sharpen = true;
+            current.weight = stage.weight;
+            current.grayInput = gray;
+            current.grayOutput = gray;
+            continue;
+        }
+        current.pixelStages.push_back(stage);
+        if (stage.operation == Operation::Grayscale || stage.operation == Operation::Threshold) {
+            current.grayOutput = true;
+        }
+    }
+    segments.push_back(current);
+    return segments;
+}
+
+bool FilterPipeline::run(const QImage& input, QImage& output, int threadCount)
+{
+    if (input.isNull()) {
+        return false;
+    }
+    for (const Stage& stage : stages) {
+        if (stage.operation == Operation::Sharpen && stage.weight < 0) {
+            return false;
+        }
+    }
+    const QRect area = cropRect.isNull() ? input.rect() : cropRect;
+    if (area.isEmpty() || !input.rect().contains(area)) {
+        return false;
+    }
+
+    const bool grayInput = input.format() == QImage::Format_Grayscale8;
+    const QImage source = grayInput ? input : TemplateMatcher::toColorBuffer(input);
+    const std::vector<Segment> segments = buildSegments(grayInput);
+    const int segmentCount = static_cast<int>(segments.size());
+    const int width = area.width();
+    const int height = area.height();
+
+    const QImage::Format format = segments.back().grayOutput ? QImage::Format_Grayscale8 : source.format();
+    if (output.size() != area.size() || output.format() != format) {
+        output = QImage(area.size(), format);
+    }
+    uchar* outputBits = output.bits();
+    const qsizetype outputStride = output.bytesPerLine();
+
+    const int sourceBytes = grayInput ? 1 : 4;
+    const uchar* sourceOrigin = source.constScanLine(area.top()) + static_cast<size_t>(area.left()) * sourceBytes;
+    const qsizetype sourceStride = source.bytesPerLine();
+
+    // 每段之后的每次锐化都需要该段多输出上下各一行
+    std::vector<int> halo(segmentCount);
+    std::vector<size_t> rowBytes(segmentCount);
+    size_t tileRowBytes = 0;
+    size_t haloBytes = 0;
+    for (int s = 0; s < segmentCount; ++s) {
+        halo[s] = segmentCount - 1 - s;
+        rowBytes[s] = static_cast<size_t>(width) * (segments[s].grayOutput ? 1 : 4);
+        if (s + 1 < segmentCount) {
+            tileRowBytes += rowBytes[s];
+            haloBytes += rowBytes[s] * 2 * halo[s];
+        }
+    }
+    int tileRows = height;
+    if (tileRowBytes > 0) {
+        const size_t budget = TileBytes > haloBytes ? TileBytes - haloBytes : 0;
+        tileRows = std::max(MinTileRows, static_cast<int>(std::min<size_t>(budget / tileRowBytes, height)));
+    }
+
+    const int maxBands = std::max(1, std::min(threadCount, height / MinRowsPerBand));
+    if (static_cast<int>(scratch.size()) < maxBands) {
+        scratch.resize(maxBands);
+    }
+
+    TaskPool::forEachBand(height, threadCount, MinRowsPerBand, [&](int band, int first, int last) {
+        Scratch& buffers = scratch[band];
+        buffers.segmentRows.resize(segmentCount);
+        buffers.row.resize(width);
+        for (int s = 0; s + 1 < segmentCount; ++s) {
+            buffers.segmentRows[s].resize(static_cast<size_t>(tileRows + 2 * halo[s]) * rowBytes[s]);
+        }
+
+        std::vector<int> tileStart(segmentCount);
+        for (int y0 = first; y0 < last; y0 += tileRows) {
+            const int y1 = std::min(last, y0 + tileRows);
+            for (int s = 0; s < segmentCount; ++s) {
+                const Segment& segment = segments[s];
+                const int begin = std::max(0, y0 - halo[s]);
+                const int end = std::min(height, y1 + halo[s]);
+                tileStart[s] = begin;
+
+                // 本段输入：第一段为输入图像，其余为上一段在本块的输出
+                auto inputRow = [&](int y) -> const uchar* {
+                    if (s == 0) {
+                        return sourceOrigin + y * sourceStride;
+                    }
+                    return buffers.segmentRows[s - 1].data() + static_cast<size_t>(y - tileStart[s - 1]) * rowBytes[s - 1];
+                };
+                const int inputBytes = segment.grayInput ? 1 : 4;
+
+                for (int y = begin; y < end; ++y) {
+                    uchar* dst = s + 1 == segmentCount
+                        ? outputBits + y * outputStride
+                        : buffers.segmentRows[s].data() + static_cast<size_t>(y - begin) * rowBytes[s];
+                    // 段内先转换为灰度的部分在ARGB临时行中完成
+                    uchar* base = segment.grayInput != segment.grayOutput ? reinterpret_cast<uchar*>(buffers.row.data()) : dst;
+
+                    if (segment.sharpen && width >= 3 && height >= 3 && y > 0 && y < height - 1) {
+                        ImageFilters::sharpenRow(inputRow(y - 1), inputRow(y), inputRow(y + 1), width, inputBytes,
+                                                 segment.weight, base);
+                    } else {
+                        std::memcpy(base, inputRow(y), static_cast<size_t>(width) * inputBytes);
+                    }
+
+                    bool gray = segment.grayInput;
+                    for (const Stage& stage : segment.pixelStages) {
+                        if (!gray && (stage.operation == Operation::Grayscale || stage.operation == Operation::Threshold)) {
+                            ImageFilters::grayRow(reinterpret_cast<const uint32_t*>(base), width, dst);
+                            gray = true;
+                        }
+                        if (stage.operation == Operation::Threshold) {
+                            ImageFilters::thresholdRow(dst, width, stage.level);
+                        } else if (stage.operation == Operation::Negative) {
+                            if (gray) {
+                                ImageFilters::negateRow(dst, width);
+                            } else {
+                                ImageFilters::negateRow(reinterpret_cast<uint32_t*>(base), width);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    });
+    return true;
+}
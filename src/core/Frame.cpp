@@ -0,0 +1,88 @@
+#include "core/Frame.h"
+#include <chrono>
+
+namespace {
+
+// QImage视图释放时释放它持有的缓冲区引用
+void releaseBufferReference(void* reference)
+{
+    delete static_cast<std::shared_ptr<uint8_t>*>(reference);
+}
+
+}
+
+Frame::Frame(std::shared_ptr<uint8_t> buffer, int width, int height, qsizetype stride, PixelFormat format,
+             quint64 sequence, qint64 timestamp)
+{
+    if (!buffer || width <= 0 || height <= 0 || stride < static_cast<qsizetype>(width) * bytesPerPixel(format)) {
+        return;
+    }
+
+    auto data = std::make_shared<Data>();
+    data->buffer = std::move(buffer);
+    data->width = width;
+    data->height = height;
+    data->stride = stride;
+    data->format = format;
+    data->sequence = sequence;
+    data->timestamp = timestamp;
+    // 以只读方式包装，写入视图时QImage先复制像素
+    const uchar* pixels = data->buffer.get();
+    data->view = QImage(pixels, width, height, stride, imageFormat(format),
+                        releaseBufferReference, new std::shared_ptr<uint8_t>(data->buffer));
+    d = std::move(data);
+}
+
+Frame Frame::fromImage(const QImage& image, quint64 sequence, qint64 timestamp)
+{
+    if (image.isNull()) {
+        return Frame();
+    }
+
+    PixelFormat format;
+    QImage source = image;
+    switch (image.format()) {
+    case QImage::Format_ARGB32:
+        format = PixelFormat::Bgra32;
+        break;
+    case QImage::Format_RGB32:
+        format = PixelFormat::Bgrx32;
+        break;
+    case QImage::Format_Grayscale8:
+        format = PixelFormat::Gray8;
+        break;
+    default:
+        source = image.convertToFormat(QImage::Format_ARGB32);
+        format = PixelFormat::Bgra32;
+        break;
+    }
+
+    // 缓冲区引用持有QImage的隐式共享副本，像素随最后一个引用释放
+    auto holder = std::make_shared<QImage>(source);
+    std::shared_ptr<uint8_t> buffer(holder, const_cast<uint8_t*>(holder->constBits()));
+    return Frame(std::move(buffer), source.width(), source.height(), source.bytesPerLine(), format, sequence, timestamp);
+}
+
+int Frame::bytesPerPixel(PixelFormat format)
+{
+    return format == PixelFormat::Gray8 ? 1 : 4;
+}
+
+QImage::Format Frame::imageFormat(PixelFormat format)
+{
+    switch (format) {
+    case PixelFormat::Bgra32:
+        return QImage::Format_ARGB32;
+    case PixelFormat::Bgrx32:
+        return QImage::Format_RGB32;
+    case PixelFormat::Gray8:
+        return QImage::Format_Grayscale8;
+    }
+    return QImage::Format_ARGB32;
+}
+
+qint64 Frame::currentTimestamp()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,154 @@
+#include "core/FramePool.h"
+#include <algorithm>
+#include <bit>
+#include <new>
+
+FramePool::FramePool(int maxFreePerClass)
+    : state(std::make_shared<State>())
+{
+    state->maxFreePerClass = std::max(0, maxFreePerClass);
+}
+
+FramePool::~FramePool()
+{
+    clear();
+}
+
+// 池销毁后仍可能有缓冲区在释放时归还到状态中，随状态一起释放
+FramePool::State::~State()
+{
+    for (const auto& [bytes, buffers] : freeLists) {
+        for (uint8_t* data : buffers) {
+            release(data);
+        }
+    }
+}
+
+uint8_t* FramePool::allocate(size_t bytes)
+{
+    return static_cast<uint8_t*>(::operator new[](bytes, std::align_val_t(Alignment)));
+}
+
+void FramePool::release(uint8_t* data)
+{
+    ::operator delete[](data, std::align_val_t(Alignment));
+}
+
+size_t FramePool::sizeClass(size_t bytes)
+{
+    if (bytes <= MinClassBytes) {
+        return MinClassBytes;
+    }
+    // bytes位于(2^k, 2^(k+1)]，该区间按2^k / ClassesPerOctave的步长分档
+    const int octave = std::bit_width(bytes - 1) - 1;
+    const size_t step = (static_cast<size_t>(1) << octave) / ClassesPerOctave;
+    return (bytes + step - 1) / step * step;
+}
+
+std::shared_ptr<uint8_t> FramePool::acquire(size_t bytes)
+{
+    if (bytes == 0) {
+        return nullptr;
+    }
+
+    const size_t classBytes = sizeClass(bytes);
+    uint8_t* data = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        Statistics& statistics = state->statistics;
+        auto it = state->freeLists.find(classBytes);
+        if (it != state->freeLists.end() && !it->second.empty()) {
+            data = it->second.back();
+            it->second.pop_back();
+            ++statistics.hits;
+            --statistics.freeBuffers;
+            statistics.freeBytes -= classBytes;
+        } else {
+            ++statistics.misses;
+        }
+        ++statistics.buffersInUse;
+        statistics.bytesInUse += classBytes;
+    }
+    if (!data) {
+        data = allocate(classBytes);
+    }
+
+    // 最后一个引用释放时归还到池中；池已销毁或档位已满时释放内存
+    std::weak_ptr<State> owner = state;
+    return std::shared_ptr<uint8_t>(data, [owner, classBytes](uint8_t* data) {
+        if (std::shared_ptr<State> pool = owner.lock()) {
+            std::lock_guard<std::mutex> lock(pool->mutex);
+            Statistics& statistics = pool->statistics;
+            --statistics.buffersInUse;
+            statistics.bytesInUse -= classBytes;
+            std::vector<uint8_t*>& freeList = pool->freeLists[classBytes];
+            if (static_cast<int>(freeList.size()) < pool->maxFreePerClass) {
+                freeList.push_back(data);
+                ++statistics.recycled;
+                ++statistics.freeBuffers;
+                statistics.freeBytes += classBytes;
+                return;
+            }
+            ++statistics.discarded;
+        }
+        release(data);
+    });
+}
+
+void FramePool::clear()
+{
+    std::map<size_t, std::vector<uint8_t*>> freeLists;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        freeLists.swap(state->freeLists);
+        state->statistics.freeBuffers = 0;
+        state->statistics.freeBytes = 0;
+    }
+    for (const auto& [bytes, buffers] : freeLists) {
+        for (uint8_t* data : buffers) {
+            release(data);
+        }
+    }
+}
+
+void FramePool::setMaxFreePerClass(int count)
+{
+    std::vector<uint8_t*> excess;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->maxFreePerClass = std::max(0, count);
+        for (auto& [bytes, buffers] : state->freeLists) {
+            while (static_cast<int>(buffers.size()) > state->maxFreePerClass) {
+                excess.push_back(buffers.back());
+                buffers.pop_back();
+                --state->statistics.freeBuffers;
+                state->statistics.freeBytes -= bytes;
+            }
+        }
+    }
+    for (uint8_t* data : excess) {
+        release(data);
+    }
+}
+
+int FramePool::getMaxFreePerClass() const
+{
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->maxFreePerClass;
+}
+
+FramePool::Statistics FramePool::statistics() const
+{
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->statistics;
+}
+
+void FramePool::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(state->mutex);
+    Statistics& statistics = state->statistics;
+    statistics.hits = 0;
+    statistics.misses = 0;
+    statistics.recycled = 0;
+    statistics.discarded = 0;
+}
@@ -0,0 +1,176 @@
+#include "core/GdiCaptureSource.h"
+#include <cstring>
+
+#ifdef _WIN32
+#pragma comment(lib, "gdi32.lib")
+#pragma comment(lib, "user32.lib")
+#endif
+
+GdiCaptureSource::GdiCaptureSource(HWND targetWindow)
+    : targetWindow(targetWindow)
+    , running(false)
+    , frameSequence(0)
+    , surfaceDC(nullptr)
+    , surfaceBitmap(nullptr)
+    , surfacePreviousBitmap(nullptr)
+    , surfaceBits(nullptr)
+    , surfaceRebuilds(0)
+{
+}
+
+GdiCaptureSource::~GdiCaptureSource()
+{
+    releaseCaptureSurface();
+}
+
+bool GdiCaptureSource::start()
+{
+#ifdef _WIN32
+    running = targetWindow && IsWindow(targetWindow);
+#else
+    running = false;
+#endif
+    return running;
+}
+
+void GdiCaptureSource::stop()
+{
+    running = false;
+}
+
+QSize GdiCaptureSource::frameSize() const
+{
+#ifdef _WIN32
+    RECT rect;
+    if (targetWindow && GetWindowRect(targetWindow, &rect)) {
+        return QSize(rect.right - rect.left, rect.bottom - rect.top);
+    }
+#endif
+    return QSize();
+}
+
+Frame GdiCaptureSource::nextFrame()
+{
+    if (!running || !targetWindow) {
+        return Frame();
+    }
+
+#ifdef _WIN32
+    if (!IsWindow(targetWindow) || !IsWindowVisible(targetWindow)) {
+        return Frame();
+    }
+
+    // 获取窗口大小
+    RECT windowRect;
+    if (!GetWindowRect(targetWindow, &windowRect)) {
+        return Frame();
+    }
+
+    int width = windowRect.right - windowRect.left;
+    int height = windowRect.bottom - windowRect.top;
+
+    if (width <= 0 || height <= 0) {
+        return Frame();
+    }
+
+    // 创建设备上下文
+    HDC windowDC = GetWindowDC(targetWindow);
+    if (!windowDC) {
+        return Frame();
+    }
+
+    // 尺寸变化时才重建DIB段与内存DC
+    if (!ensureCaptureSurface(windowDC, QSize(width, height))) {
+        ReleaseDC(targetWindow, windowDC);
+        return Frame();
+    }
+
+    // 使用PrintWindow捕获窗口内容（比BitBlt更好，支持最小化窗口）
+    BOOL result = PrintWindow(targetWindow, surfaceDC, PW_CLIENTONLY);
+    if (!result) {
+        // 如果PrintWindow失败，尝试使用BitBlt
+        result = BitBlt(surfaceDC, 0, 0, width, height, windowDC, 0, 0, SRCCOPY);
+    }
+    ReleaseDC(targetWindow, windowDC);
+
+    Frame frame;
+    if (result) {
+        // GDI对DIB段的绘制可能仍在批处理中，读取前先刷新
+        GdiFlush();
+
+        // 复制到帧缓冲池的缓冲区，DIB段留给下一帧；BGRX字节顺序即QImage::Format_RGB32，无需转换
+        const qsizetype stride = static_cast<qsizetype>(width) * 4;
+        const size_t bytes = static_cast<size_t>(stride) * height;
+        std::shared_ptr<uint8_t> buffer = framePool.acquire(bytes);
+        memcpy(buffer.get(), surfaceBits, bytes);
+        frame = Frame(std::move(buffer), width, height, stride, Frame::PixelFormat::Bgrx32,
+                      ++frameSequence, Frame::currentTimestamp());
+    }
+
+    return frame;
+#else
+    return Frame();
+#endif
+}
+
+bool GdiCaptureSource::ensureCaptureSurface(HDC windowDC, const QSize& size)
+{
+#ifdef _WIN32
+    if (surfaceDC && surfaceSize == size) {
+        return true;
+    }
+    releaseCaptureSurface();
+
+    HDC memoryDC = CreateCompatibleDC(windowDC);
+    if (!memoryDC) {
+        return false;
+    }
+
+    // 自顶向下的32位DIB段，每行恰好width * 4字节
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = size.width();
+    bmi.bmiHeader.biHeight = -size.height();
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    void* bits = nullptr;
+    HBITMAP bitmap = CreateDIBSection(windowDC, &bmi, DIB_RGB_COLORS, &bits, nullptr, 0);
+    if (!bitmap || !bits) {
+        if (bitmap) {
+            DeleteObject(bitmap);
+        }
+        DeleteDC(memoryDC);
+        return false;
+    }
+
+    surfacePreviousBitmap = SelectObject(memoryDC, bitmap);
+    surfaceDC = memoryDC;
+    surfaceBitmap = bitmap;
+    surfaceBits = static_cast<uint8_t*>(bits);
+    surfaceSize = size;
+    ++surfaceRebuilds;
+    return true;
+#else
+    Q_UNUSED(windowDC)
+    Q_UNUSED(size)
+    return false;
+#endif
+}
+
+void GdiCaptureSource::releaseCaptureSurface()
+{
+#ifdef _WIN32
+    if (surfaceDC) {
+        SelectObject(surfaceDC, surfacePreviousBitmap);
+        DeleteObject(surfaceBitmap);
+        DeleteDC(surfaceDC);
+    }
+#endif
+    surfaceDC = nullptr;
+    surfaceBitmap = nullptr;
+    surfacePreviousBitmap = nullptr;
+    surfaceBits = nullptr;
+    surfaceSize = QSize();
+}
@@ -0,0 +1,573 @@
+#include "core/ImageFilters.h"
+#include "core/PixelKernels.h"
+#include "core/TaskPool.h"
+#include "core/TemplateMatcher.h"
+#include <QColor>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace ImageFilters {
+
+namespace {
+
+// 每个条带至少的行数
+const int MinRowsPerBand = 64;
+
+// 一维行滤镜：处理src的count个像素，第i个结果写入dst[i*dstStride]；scratch为线程内复用的临时缓冲
+using RowFilter = std::function<void(const uint32_t* src, int count, uint32_t* dst, size_t dstStride,
+                                     std::vector<uint32_t>& scratch)>;
+
+// 先水平后垂直各做一次行滤镜，中间结果存放在转置缓冲中（调用方未提供时临时分配）
+QImage applySeparable(const QImage& image, int threadCount, std::vector<uint32_t>* transposeBuffer, const RowFilter& filter)
+{
+    const QImage source = TemplateMatcher::toColorBuffer(image);
+    const int width = source.width();
+    const int height = source.height();
+    QImage result(width, height, source.format());
+
+    std::vector<uint32_t> local;
+    std::vector<uint32_t>& transposed = transposeBuffer ? *transposeBuffer : local;
+    transposed.resize(static_cast<size_t>(width) * height);
+    uint32_t* buffer = transposed.data();
+
+    forEachRowBand(height, threadCount, [&](int first, int last) {
+        std::vector<uint32_t> scratch;
+        for (int y = first; y < last; ++y) {
+            filter(reinterpret_cast<const uint32_t*>(source.constScanLine(y)), width, buffer + y, height, scratch);
+        }
+    });
+
+    uint32_t* output = reinterpret_cast<uint32_t*>(result.bits());
+    const size_t outputStride = static_cast<size_t>(result.bytesPerLine()) / sizeof(uint32_t);
+    forEachRowBand(width, threadCount, [&](int first, int last) {
+        std::vector<uint32_t> scratch;
+        for (int x = first; x < last; ++x) {
+            filter(buffer + static_cast<size_t>(x) * height, height, output + x, outputStride, scratch);
+        }
+    });
+    return result;
+}
+
+// 盒式模糊的一行：滑动窗口累加各通道，除以窗口宽度时用32位定点倒数
+// padded为左右各向外延伸radius+1个像素后的输入（第radius+1个元素为原第0个像素）
+void boxRow(const uint32_t* padded, int count, int radius, uint32_t* dst, size_t dstStride)
+{
+    const int window = 2 * radius + 1;
+    const uint64_t scale = ((1ull << 32) + window / 2) / window;
+    auto average = [scale](uint32_t sum) {
+        return static_cast<uint32_t>((sum * scale + (1ull << 31)) >> 32);
+    };
+
+    // 窗口[i - radius, i + radius]对应padded[i + 1, i + window]；先累加i = -1时的窗口
+    uint32_t blue = 0, green = 0, red = 0, alpha = 0;
+    for (int k = 0; k < window; ++k) {
+        const uint32_t p = padded[k];
+        blue += p & 0xFF;
+        green += (p >> 8) & 0xFF;
+        red += (p >> 16) & 0xFF;
+        alpha += p >> 24;
+    }
+    for (int i = 0; i < count; ++i) {
+        const uint32_t entering = padded[i + window];
+        const uint32_t leaving = padded[i];
+        blue += (entering & 0xFF) - (leaving & 0xFF);
+        green += ((entering >> 8) & 0xFF) - ((leaving >> 8) & 0xFF);
+        red += ((entering >> 16) & 0xFF) - ((leaving >> 16) & 0xFF);
+        alpha += (entering >> 24) - (leaving >> 24);
+        dst[i * dstStride] = average(blue) | (average(green) << 8) | (average(red) << 16) | (average(alpha) << 24);
+    }
+}
+
+// 把src复制到padded并在两端各延伸margin个边界像素
+void padRow(const uint32_t* src, int count, int margin, uint32_t* padded)
+{
+    std::fill_n(padded, margin, src[0]);
+    std::copy_n(src, count, padded + margin);
+    std::fill_n(padded + margin + count, margin, src[count - 1]);
+}
+
+// 依次做多次盒式模糊，最后一次写入dst；scratch前部为延伸后的输入，后部存放中间结果
+void boxRows(const uint32_t* src, int count, const std::vector<int>& radii, uint32_t* dst, size_t dstStride,
+             std::vector<uint32_t>& scratch)
+{
+    const int margin = *std::max_element(radii.begin(), radii.end()) + 1;
+    const size_t paddedLength = static_cast<size_t>(count) + 2 * static_cast<size_t>(margin);
+    scratch.resize(paddedLength + count);
+    uint32_t* padded = scratch.data();
+    uint32_t* row = scratch.data() + paddedLength;
+
+    padRow(src, count, margin, padded);
+    for (size_t pass = 0; pass < radii.size(); ++pass) {
+        const uint32_t* input = padded + (margin - radii[pass] - 1);
+        if (pass + 1 == radii.size()) {
+            boxRow(input, count, radii[pass], dst, dstStride);
+        } else {
+            boxRow(input, count, radii[pass], row, 1);
+            padRow(row, count, margin, padded);
+        }
+    }
+}
+
+// 逐像素滤镜：按行条带把source的每个像素经pixelFilter写入同格式的结果图像
+template <typename PixelFilter>
+QImage mapPixels(const QImage& image, int threadCount, PixelFilter pixelFilter)
+{
+    const QImage source = TemplateMatcher::toColorBuffer(image);
+    QImage result(source.size(), source.format());
+    const int width = source.width();
+    uchar* output = result.bits();
+    const qsizetype outputStride = result.bytesPerLine();
+
+    forEachRowBand(source.height(), threadCount, [&](int first, int last) {
+        for (int y = first; y < last; ++y) {
+            const uint32_t* in = reinterpret_cast<const uint32_t*>(source.constScanLine(y));
+            uint32_t* out = reinterpret_cast<uint32_t*>(output + y * outputStride);
+            for (int x = 0; x < width; ++x) {
+                out[x] = pixelFilter(in[x]);
+            }
+        }
+    });
+    return result;
+}
+
+// 怀旧色查找表：每个输出通道为三个输入通道查表之和，求和顺序与逐像素计算相同，结果逐位一致
+struct SepiaTable {
+    double red[3][256];
+    double green[3][256];
+    double blue[3][256];
+
+    SepiaTable()
+    {
+        const double coefficients[3][3] = {{0.393, 0.769, 0.189}, {0.349, 0.686, 0.168}, {0.272, 0.534, 0.131}};
+        double (*tables[3])[256] = {red, green, blue};
+        for (int output = 0; output < 3; ++output) {
+            for (int input = 0; input < 3; ++input) {
+                for (int v = 0; v < 256; ++v) {
+                    tables[output][input][v] = coefficients[output][input] * v;
+                }
+            }
+        }
+    }
+};
+
+const SepiaTable& sepiaTable()
+{
+    static const SepiaTable table;
+    return table;
+}
+
+// ========== 原逐像素实现（仅用于基准测试对比） ==========
+
+QImage legacySharpen(const QImage& image, double intensity)
+{
+    QImage result = image.copy();
+    for (int y = 1; y < result.height() - 1; ++y) {
+        for (int x = 1; x < result.width() - 1; ++x) {
+            QColor center = result.pixelColor(x, y);
+            QColor left = result.pixelColor(x - 1, y);
+            QColor right = result.pixelColor(x + 1, y);
+            QColor top = result.pixelColor(x, y - 1);
+            QColor bottom = result.pixelColor(x, y + 1);
+
+            int r = qBound(0, static_cast<int>(center.red() + intensity *
+                (4 * center.red() - left.red() - right.red() - top.red() - bottom.red())), 255);
+            int g = qBound(0, static_cast<int>(center.green() + intensity *
+                (4 * center.green() - left.green() - right.green() - top.green() - bottom.green())), 255);
+            int b = qBound(0, static_cast<int>(center.blue() + intensity *
+                (4 * center.blue() - left.blue() - right.blue() - top.blue() - bottom.blue())), 255);
+
+            result.setPixelColor(x, y, QColor(r, g, b, center.alpha()));
+        }
+    }
+    return result;
+}
+
+QImage legacyEdgeDetection(const QImage& image, double intensity)
+{
+    QImage gray = image.convertToFormat(QImage::Format_Grayscale8);
+    QImage result(gray.size(), QImage::Format_RGB32);
+    result.fill(Qt::black);
+    for (int y = 1; y < gray.height() - 1; ++y) {
+        for (int x = 1; x < gray.width() - 1; ++x) {
+            int gx = -1 * qGray(gray.pixel(x-1, y-1)) + 1 * qGray(gray.pixel(x+1, y-1)) +
+                     -2 * qGray(gray.pixel(x-1, y)) + 2 * qGray(gray.pixel(x+1, y)) +
+                     -1 * qGray(gray.pixel(x-1, y+1)) + 1 * qGray(gray.pixel(x+1, y+1));
+            int gy = -1 * qGray(gray.pixel(x-1, y-1)) - 2 * qGray(gray.pixel(x, y-1)) - 1 * qGray(gray.pixel(x+1, y-1)) +
+                     1 * qGray(gray.pixel(x-1, y+1)) + 2 * qGray(gray.pixel(x, y+1)) + 1 * qGray(gray.pixel(x+1, y+1));
+            int magnitude = qBound(0, static_cast<int>(std::sqrt(gx*gx + gy*gy) * intensity), 255);
+            result.setPixel(x, y, qRgb(magnitude, magnitude, magnitude));
+        }
+    }
+    return result;
+}
+
+QImage legacySepia(const QImage& image)
+{
+    QImage result = image.copy();
+    for (int y = 0; y < result.height(); ++y) {
+        for (int x = 0; x < result.width(); ++x) {
+            QColor pixel = result.pixelColor(x, y);
+            int r = qBound(0, static_cast<int>(0.393 * pixel.red() + 0.769 * pixel.green() + 0.189 * pixel.blue()), 255);
+            int g = qBound(0, static_cast<int>(0.349 * pixel.red() + 0.686 * pixel.green() + 0.168 * pixel.blue()), 255);
+            int b = qBound(0, static_cast<int>(0.272 * pixel.red() + 0.534 * pixel.green() + 0.131 * pixel.blue()), 255);
+            result.setPixelColor(x, y, QColor(r, g, b, pixel.alpha()));
+        }
+    }
+    return result;
+}
+
+QImage legacyNegative(const QImage& image)
+{
+    QImage result = image.copy();
+    for (int y = 0; y < result.height(); ++y) {
+        for (int x = 0; x < result.width(); ++x) {
+            QColor pixel = result.pixelColor(x, y);
+            result.setPixelColor(x, y, QColor(255 - pixel.red(), 255 - pixel.green(), 255 - pixel.blue(), pixel.alpha()));
+        }
+    }
+    return result;
+}
+
+// 两幅同尺寸图像逐像素各通道（含alpha）的最大差值
+int maxChannelDifference(const QImage& first, const QImage& second)
+{
+    const QImage a = first.convertToFormat(QImage::Format_ARGB32);
+    const QImage b = second.convertToFormat(QImage::Format_ARGB32);
+    if (a.size() != b.size()) {
+        return 255;
+    }
+    int difference = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        const uint32_t* rowA = reinterpret_cast<const uint32_t*>(a.constScanLine(y));
+        const uint32_t* rowB = reinterpret_cast<const uint32_t*>(b.constScanLine(y));
+        for (int x = 0; x < a.width(); ++x) {
+            for (int shift = 0; shift <= 24; shift += 8) {
+                difference = std::max(difference, std::abs(static_cast<int>((rowA[x] >> shift) & 0xFF) -
+                                                           static_cast<int>((rowB[x] >> shift) & 0xFF)));
+            }
+        }
+    }
+    return difference;
+}
+
+double defaultSigma(int radius)
+{
+    return 0.3 * (radius - 1) + 0.8;
+}
+
+// 与给定sigma的高斯模糊等效的三次盒式模糊半径（窗口宽度取相邻的两个奇数）
+std::vector<int> gaussianBoxRadii(double sigma)
+{
+    const int passes = 3;
+    const double variance = sigma * sigma;
+    int lower = static_cast<int>(std::floor(std::sqrt(12.0 * variance / passes + 1.0)));
+    if (lower % 2 == 0) {
+        --lower;
+    }
+    const int upper = lower + 2;
+    const long lowerCount = std::lround((12.0 * variance - passes * lower * lower - 4.0 * passes * lower - 3.0 * passes) /
+                                        (-4.0 * lower - 4.0));
+
+    std::vector<int> radii;
+    for (int pass = 0; pass < passes; ++pass) {
+        radii.push_back(((pass < lowerCount ? lower : upper) - 1) / 2);
+    }
+    return radii;
+}
+
+}
+
+void forEachRowBand(int rows, int threadCount, const std::function<void(int, int)>& body)
+{
+    TaskPool::forEachBand(rows, threadCount, MinRowsPerBand, [&body](int, int first, int last) {
+        body(first, last);
+    });
+}
+
+std::vector<int16_t> gaussianKernel(int radius, double sigma)
+{
+    radius = std::max(0, radius);
+    if (sigma <= 0.0) {
+        sigma = defaultSigma(radius);
+    }
+
+    std::vector<double> weights(2 * radius + 1);
+    double total = 0.0;
+    for (int k = -radius; k <= radius; ++k) {
+        weights[k + radius] = std::exp(-0.5 * k * k / (sigma * sigma));
+        total += weights[k + radius];
+    }
+
+    // 量化后的舍入误差计入中心权重，保证权重和精确为1
+    const int one = 1 << PixelKernels::ConvolutionShift;
+    std::vector<int16_t> kernel(weights.size());
+    int sum = 0;
+    for (size_t i = 0; i < weights.size(); ++i) {
+        kernel[i] = static_cast<int16_t>(std::lround(weights[i] / total * one));
+        sum += kernel[i];
+    }
+    kernel[radius] = static_cast<int16_t>(kernel[radius] + one - sum);
+    return kernel;
+}
+
+QImage gaussianBlur(const QImage& image, int radius, int threadCount, std::vector<uint32_t>* transposeBuffer)
+{
+    if (image.isNull() || radius <= 0) {
+        return image;
+    }
+
+    if (radius > BoxApproximationRadius) {
+        const std::vector<int> radii = gaussianBoxRadii(defaultSigma(radius));
+        return applySeparable(image, threadCount, transposeBuffer, [&radii](const uint32_t* src, int count, uint32_t* dst,
+                                                                            size_t dstStride, std::vector<uint32_t>& scratch) {
+            boxRows(src, count, radii, dst, dstStride, scratch);
+        });
+    }
+
+    const std::vector<int16_t> kernel = gaussianKernel(radius);
+    const int taps = static_cast<int>(kernel.size());
+    return applySeparable(image, threadCount, transposeBuffer, [&kernel, taps, radius](const uint32_t* src, int count,
+                                                                                       uint32_t* dst, size_t dstStride,
+                                                                                       std::vector<uint32_t>& padded) {
+        padded.resize(static_cast<size_t>(count) + taps - 1);
+        padRow(src, count, radius, padded.data());
+        PixelKernels::convolveRowArgb(padded.data(), count, kernel.data(), taps, dst, dstStride);
+    });
+}
+
+QImage boxBlur(const QImage& image, int radius, int threadCount, std::vector<uint32_t>* transposeBuffer)
+{
+    if (image.isNull() || radius <= 0) {
+        return image;
+    }
+
+    const std::vector<int> radii = {radius};
+    return applySeparable(image, threadCount, transposeBuffer, [&radii](const uint32_t* src, int count, uint32_t* dst,
+                                                                        size_t dstStride, std::vector<uint32_t>& scratch) {
+        boxRows(src, count, radii, dst, dstStride, scratch);
+    });
+}
+
+QImage sharpen(const QImage& image, double intensity, int threadCount)
+{
+    const int weight = sharpenWeight(intensity);
+    if (weight < 0) {
+        return QImage();
+    }
+
+    const QImage source = image.format() == QImage::Format_Grayscale8 ? image : TemplateMatcher::toColorBuffer(image);
+    const int width = source.width();
+    const int height = source.height();
+    if (width < 3 || height < 3) {
+        return source.copy();
+    }
+
+    // 只复制边框像素，内部像素全部由内核写入
+    QImage result(source.size(), source.format());
+    const int pixelBytes = source.depth() / 8;
+    const size_t rowBytes = static_cast<size_t>(width) * pixelBytes;
+    std::memcpy(result.scanLine(0), source.constScanLine(0), rowBytes);
+    std::memcpy(result.scanLine(height - 1), source.constScanLine(height - 1), rowBytes);
+
+    uchar* output = result.bits();
+    const qsizetype outputStride = result.bytesPerLine();
+    forEachRowBand(height - 2, threadCount, [&](int first, int last) {
+        for (int y = first + 1; y < last + 1; ++y) {
+            sharpenRow(source.constScanLine(y - 1), source.constScanLine(y), source.constScanLine(y + 1), width, pixelBytes,
+                       weight, output + y * outputStride);
+        }
+    });
+    return result;
+}
+
+QImage edgeDetection(const QImage& image, double intensity, int threadCount)
+{
+    const QImage gray = image.convertToFormat(QImage::Format_Grayscale8);
+    QImage result(gray.size(), QImage::Format_RGB32);
+    result.fill(Qt::black);
+    const int width = gray.width();
+    const int height = gray.height();
+    if (width < 3 || height < 3) {
+        return result;
+    }
+
+    uchar* output = result.bits();
+    const qsizetype outputStride = result.bytesPerLine();
+    forEachRowBand(height - 2, threadCount, [&](int first, int last) {
+        for (int y = first + 1; y < last + 1; ++y) {
+            PixelKernels::sobelRowGray(gray.constScanLine(y - 1) + 1, gray.constScanLine(y) + 1, gray.constScanLine(y + 1) + 1,
+                                       width - 2, intensity, reinterpret_cast<uint32_t*>(output + y * outputStride) + 1);
+        }
+    });
+    return result;
+}
+
+QImage sepia(const QImage& image, int threadCount)
+{
+    const SepiaTable& table = sepiaTable();
+    return mapPixels(image, threadCount, [&table](uint32_t pixel) {
+        const int r = (pixel >> 16) & 0xFF;
+        const int g = (pixel >> 8) & 0xFF;
+        const int b = pixel & 0xFF;
+        auto channel = [r, g, b](const double (&lut)[3][256]) {
+            return static_cast<uint32_t>(std::min(static_cast<int>(lut[0][r] + lut[1][g] + lut[2][b]), 255));
+        };
+        return (pixel & 0xFF000000u) | (channel(table.red) << 16) | (channel(table.green) << 8) | channel(table.blue);
+    });
+}
+
+QImage negative(const QImage& image, int threadCount)
+{
+    if (image.format() != QImage::Format_Grayscale8) {
+        return mapPixels(image, threadCount, [](uint32_t pixel) { return pixel ^ 0x00FFFFFFu; });
+    }
+
+    QImage result(image.size(), QImage::Format_Grayscale8);
+    uchar* output = result.bits();
+    const qsizetype outputStride = result.bytesPerLine();
+    forEachRowBand(image.height(), threadCount, [&](int first, int last) {
+        for (int y = first; y < last; ++y) {
+            uchar* row = output + y * outputStride;
+            std::memcpy(row, image.constScanLine(y), static_cast<size_t>(image.width()));
+            negateRow(row, image.width());
+        }
+    });
+    return result;
+}
+
+QImage grayscale(const QImage& image, int threadCount)
+{
+    if (image.format() == QImage::Format_Grayscale8) {
+        return image.copy();
+    }
+
+    const QImage source = TemplateMatcher::toColorBuffer(image);
+    QImage result(source.size(), QImage::Format_Grayscale8);
+    uchar* output = result.bits();
+    const qsizetype outputStride = result.bytesPerLine();
+    forEachRowBand(source.height(), threadCount, [&](int first, int last) {
+        for (int y = first; y < last; ++y) {
+            grayRow(reinterpret_cast<const uint32_t*>(source.constScanLine(y)), source.width(), output + y * outputStride);
+        }
+    });
+    return result;
+}
+
+QImage threshold(const QImage& image, int level, int threadCount)
+{
+    QImage result = grayscale(image, threadCount);
+    uchar* output = result.bits();
+    const qsizetype outputStride = result.bytesPerLine();
+    forEachRowBand(result.height(), threadCount, [&](int first, int last) {
+        for (int y = first; y < last; ++y) {
+            thresholdRow(output + y * outputStride, result.width(), level);
+        }
+    });
+    return result;
+}
+
+// ========== 行操作 ==========
+
+int sharpenWeight(double intensity)
+{
+    if (intensity < 0.0) {
+        return -1;
+    }
+    return std::clamp(static_cast<int>(std::lround(intensity * 256.0)), 0, 32767);
+}
+
+void sharpenRow(const uchar* above, const uchar* row, const uchar* below, int width, int pixelBytes, int weight, uchar* dst)
+{
+    if (pixelBytes == 1) {
+        PixelKernels::sharpenRowU8(above + 1, row + 1, below + 1, width - 2, weight, dst + 1);
+    } else {
+        PixelKernels::sharpenRowArgb(reinterpret_cast<const uint32_t*>(above) + 1, reinterpret_cast<const uint32_t*>(row) + 1,
+                                     reinterpret_cast<const uint32_t*>(below) + 1, width - 2, weight,
+                                     reinterpret_cast<uint32_t*>(dst) + 1);
+    }
+    std::memcpy(dst, row, pixelBytes);
+    std::memcpy(dst + static_cast<size_t>(width - 1) * pixelBytes, row + static_cast<size_t>(width - 1) * pixelBytes,
+                pixelBytes);
+}
+
+void grayRow(const uint32_t* src, int count, uint8_t* dst)
+{
+    for (int i = 0; i < count; ++i) {
+        dst[i] = static_cast<uint8_t>(qGray(src[i]));
+    }
+}
+
+void thresholdRow(uint8_t* row, int count, int level)
+{
+    for (int i = 0; i < count; ++i) {
+        row[i] = row[i] >= level ? 255 : 0;
+    }
+}
+
+void negateRow(uint32_t* row, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        row[i] ^= 0x00FFFFFFu;
+    }
+}
+
+void negateRow(uint8_t* row, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        row[i] = static_cast<uint8_t>(255 - row[i]);
+    }
+}
+
+// ========== 基准测试 ==========
+
+std::vector<FilterBenchmark> benchmarkFilters(const QSize& size, int threadCount, int repetitions)
+{
+    std::vector<FilterBenchmark> results;
+    if (size.isEmpty() || repetitions <= 0) {
+        return results;
+    }
+
+    // 伪随机测试图像（固定种子），叠加平滑渐变使锐化与边缘检测结果不全为饱和值
+    QImage image(size, QImage::Format_ARGB32);
+    uint32_t seed = 12345u;
+    for (int y = 0; y < image.height(); ++y) {
+        uint32_t* row = reinterpret_cast<uint32_t*>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            seed = seed * 1664525u + 1013904223u;
+            const uint32_t base = static_cast<uint32_t>((x + y) & 0xFF) * 0x010101u;
+            row[x] = 0xFF000000u | ((base + ((seed >> 8) & 0x1F1F1F)) & 0xFFFFFFu);
+        }
+    }
+
+    auto measure = [repetitions](auto&& body, QImage& output) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repetitions; ++i) {
+            output = body();
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repetitions;
+    };
+
+    auto compare = [&](const QString& name, auto&& legacy, auto&& scanline) {
+        QImage legacyResult, scanlineResult;
+        FilterBenchmark benchmark;
+        benchmark.filter = name;
+        benchmark.legacyMilliseconds = measure(legacy, legacyResult);
+        benchmark.scanlineMilliseconds = measure(scanline, scanlineResult);
+        benchmark.maxDifference = maxChannelDifference(legacyResult, scanlineResult);
+        results.push_back(benchmark);
+    };
+
+    const double intensity = 0.5;
+    compare("Sharpen", [&]() { return legacySharpen(image, intensity); },
+            [&]() { return sharpen(image, intensity, threadCount); });
+    compare("EdgeDetection", [&]() { return legacyEdgeDetection(image, intensity); },
+            [&]() { return edgeDetection(image, intensity, threadCount); });
+    compare("Sepia", [&]() { return legacySepia(image); }, [&]() { return sepia(image, threadCount); });
+    compare("Negative", [&]() { return legacyNegative(image); }, [&]() { return negative(image, threadCount); });
+    return results;
+}
+
+}
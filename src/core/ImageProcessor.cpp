@@ -1,4 +1,8 @@
 #include "core/ImageProcessor.h"
+#include "core/TemplateMatcher.h"
+#include "core/ConnectedComponents.h"
+#include "core/ImageFilters.h"
+#include "core/PixelKernels.h"
 #include <QDebug>
 #include <QImage>
 #include <QColor>
@@ -10,8 +14,11 @@
 #include <QPixmap>
 #include <QImageReader>
 #include <QImageWriter>
+#include <QPointer>
 #include <algorithm>
-#include <future>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
 #include <thread>
 
 // Tesseract OCR头文件
@@ -28,13 +35,16 @@
 ImageProcessor::ImageProcessor(QObject *parent)
     : QObject(parent)
     , gpuAccelerationEnabled(false)
-    , processingThreads(std::thread::hardware_concurrency())
+    , processingThreads(static_cast<int>(std::thread::hardware_concurrency()))
     , ocrLanguage("chi_sim")
 {
+    taskPool = std::make_unique<TaskPool>(workerThreadCount());
 }
 
 ImageProcessor::~ImageProcessor()
 {
+    // 先结束异步任务，任务中使用的成员此时仍然有效
+    taskPool.reset();
 }
 
 // ========== 基础图像操作 ==========
@@ -119,12 +129,12 @@ ImageProcessor::ProcessResult ImageProcessor::applyFilter(const QImage& input, Q
 
     switch (filter) {
         case FilterType::Blur: {
-            // 使用Qt的模糊效果
+            // 可分离高斯模糊
             output = applyGaussianBlur(input, static_cast<int>(intensity * 10));
             break;
         }
         case FilterType::Sharpen: {
-            // 使用Qt的锐化效果
+            // 拉普拉斯锐化
             output = applySharpen(input, intensity);
             break;
         }
@@ -153,110 +163,63 @@ ImageProcessor::ProcessResult ImageProcessor::applyFilter(const QImage& input, Q
     return ProcessResult::Success;
 }
 
-// ========== OCR文字识别功能 ==========
+ImageProcessor::ProcessResult ImageProcessor::runPipeline(const QImage& input, QImage& output, FilterPipeline& pipeline)
+{
+    if (!validateInputs(input)) {
+        return ProcessResult::InvalidInput;
+    }
+    return pipeline.run(input, output, workerThreadCount()) ? ProcessResult::Success
+                                                            : ProcessResult::InvalidInput;
+}
+
+namespace {
 
-// Qt实现的滤镜辅助方法
+// ImageFilters的结果为32位格式，转换回输入图像的格式
+QImage toFormatOf(const QImage& result, const QImage& input)
+{
+    return result.format() == input.format() ? result : result.convertToFormat(input.format());
+}
+
+}
+
+// 滤镜辅助方法
 QImage ImageProcessor::applyGaussianBlur(const QImage& image, int radius)
 {
     if (radius <= 0) return image;
-    
-    QImage result = image;
-    QPainter painter(&result);
-    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
-    
-    // 简单的模糊实现：通过多次缩放来模拟模糊效果
-    for (int i = 0; i < radius / 2; ++i) {
-        QImage temp = result.scaled(result.size() * 0.9, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        result = temp.scaled(result.size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    // 可分离高斯模糊（大半径时为三次盒式模糊近似）
+    QImage blurred;
+    {
+        std::unique_lock<std::mutex> locker(blurBufferMutex, std::try_to_lock);
+        blurred = ImageFilters::gaussianBlur(image, radius, workerThreadCount(), locker.owns_lock() ? &blurBuffer : nullptr);
     }
-    
-    return result;
+    return toFormatOf(blurred, image);
 }
 
 QImage ImageProcessor::applySharpen(const QImage& image, double intensity)
 {
-    QImage result = image.copy();
-    
-    // 简单的锐化实现：增强对比度
-    for (int y = 1; y < result.height() - 1; ++y) {
-        for (int x = 1; x < result.width() - 1; ++x) {
-            QColor center = result.pixelColor(x, y);
-            QColor left = result.pixelColor(x-1, y);
-            QColor right = result.pixelColor(x+1, y);
-            QColor top = result.pixelColor(x, y-1);
-            QColor bottom = result.pixelColor(x, y+1);
-            
-            int r = qBound(0, static_cast<int>(center.red() + intensity * 
-                (4 * center.red() - left.red() - right.red() - top.red() - bottom.red())), 255);
-            int g = qBound(0, static_cast<int>(center.green() + intensity * 
-                (4 * center.green() - left.green() - right.green() - top.green() - bottom.green())), 255);
-            int b = qBound(0, static_cast<int>(center.blue() + intensity * 
-                (4 * center.blue() - left.blue() - right.blue() - top.blue() - bottom.blue())), 255);
-            
-            result.setPixelColor(x, y, QColor(r, g, b, center.alpha()));
-        }
-    }
-    
-    return result;
+    // 按扫描线读取原图，不受已锐化的相邻像素影响
+    return toFormatOf(ImageFilters::sharpen(image, intensity, workerThreadCount()), image);
 }
 
 QImage ImageProcessor::applyEdgeDetection(const QImage& image, double intensity)
 {
-    QImage gray = image.convertToFormat(QImage::Format_Grayscale8);
-    QImage result(gray.size(), QImage::Format_RGB32);
-    result.fill(Qt::black);
-    
-    // 简单的Sobel边缘检测
-    for (int y = 1; y < gray.height() - 1; ++y) {
-        for (int x = 1; x < gray.width() - 1; ++x) {
-            int gx = -1 * qGray(gray.pixel(x-1, y-1)) + 1 * qGray(gray.pixel(x+1, y-1)) +
-                     -2 * qGray(gray.pixel(x-1, y)) + 2 * qGray(gray.pixel(x+1, y)) +
-                     -1 * qGray(gray.pixel(x-1, y+1)) + 1 * qGray(gray.pixel(x+1, y+1));
-            
-            int gy = -1 * qGray(gray.pixel(x-1, y-1)) - 2 * qGray(gray.pixel(x, y-1)) - 1 * qGray(gray.pixel(x+1, y-1)) +
-                     1 * qGray(gray.pixel(x-1, y+1)) + 2 * qGray(gray.pixel(x, y+1)) + 1 * qGray(gray.pixel(x+1, y+1));
-            
-            int magnitude = qBound(0, static_cast<int>(sqrt(gx*gx + gy*gy) * intensity), 255);
-            result.setPixel(x, y, qRgb(magnitude, magnitude, magnitude));
-        }
-    }
-    
-    return result;
+    // Sobel边缘检测，结果为RGB32灰度图
+    return ImageFilters::edgeDetection(image, intensity, workerThreadCount());
 }
 
 QImage ImageProcessor::applySepia(const QImage& image)
 {
-    QImage result = image.copy();
-    
-    for (int y = 0; y < result.height(); ++y) {
-        for (int x = 0; x < result.width(); ++x) {
-            QColor pixel = result.pixelColor(x, y);
-            
-            int r = qBound(0, static_cast<int>(0.393 * pixel.red() + 0.769 * pixel.green() + 0.189 * pixel.blue()), 255);
-            int g = qBound(0, static_cast<int>(0.349 * pixel.red() + 0.686 * pixel.green() + 0.168 * pixel.blue()), 255);
-            int b = qBound(0, static_cast<int>(0.272 * pixel.red() + 0.534 * pixel.green() + 0.131 * pixel.blue()), 255);
-            
-            result.setPixelColor(x, y, QColor(r, g, b, pixel.alpha()));
-        }
-    }
-    
-    return result;
+    return toFormatOf(ImageFilters::sepia(image, workerThreadCount()), image);
 }
 
 QImage ImageProcessor::applyNegative(const QImage& image)
 {
-    QImage result = image.copy();
-    
-    for (int y = 0; y < result.height(); ++y) {
-        for (int x = 0; x < result.width(); ++x) {
-            QColor pixel = result.pixelColor(x, y);
-            result.setPixelColor(x, y, QColor(255 - pixel.red(), 255 - pixel.green(), 255 - pixel.blue(), pixel.alpha()));
-        }
-    }
-    
-    return result;
+    return toFormatOf(ImageFilters::negative(image, workerThreadCount()), image);
 }
 
+// ========== OCR文字识别功能 ==========
+
 ImageProcessor::ProcessResult ImageProcessor::recognizeText(const QImage& input, QString& recognizedText, const QString& language)
 {
     if (!validateInputs(input)) {
@@ -351,90 +314,856 @@ ImageProcessor::ProcessResult ImageProcessor::preprocessForOCR(const QImage& inp
     return result;
 }
 
+// ========== 图像相似度 ==========
+
+double ImageProcessor::calculateSimilarity(const QImage& image1, const QImage& image2)
+{
+    return calculateSimilarity(image1, image2, SimilarityOptions());
+}
+
+double ImageProcessor::calculateSimilarity(const QImage& image1, const QImage& image2, const QRect& region)
+{
+    SimilarityOptions options;
+    options.region = region;
+    return calculateSimilarity(image1, image2, options);
+}
+
+double ImageProcessor::calculateSimilarity(const QImage& image1, const QImage& image2, const SimilarityOptions& options)
+{
+    if (!validateInputs(image1) || !validateInputs(image2)) {
+        return 0.0;
+    }
+
+    const QRect area = options.region.isNull() ? image1.rect() : options.region.intersected(image1.rect());
+    if (area.isEmpty()) {
+        return 0.0;
+    }
+
+    // 尺寸不同时先将第二幅图像缩放到第一幅的尺寸
+    const QImage second = image2.size() == image1.size()
+        ? image2
+        : image2.scaled(image1.size(), Qt::IgnoreAspectRatio, Qt::FastTransformation);
+
+    return ImageSimilarity::compare(image1, second, area, options.parameters());
+}
+
+// ========== 矩形检测 ==========
+
+namespace {
+
+// 生成掩码时每个条带至少的行数
+const int MaskMinRowsPerBand = 64;
+
+// 每条边两端不计入覆盖率的最大长度，容许圆角
+const int CornerMargin = 6;
+
+// 外接矩形四条边上各2像素宽的带内，哪些位置有属于该连通域的前景像素
+struct RectangleCandidate {
+    QRect bounds;
+    std::vector<uint8_t> top, bottom, left, right;
+};
+
+void buildRectangleMask(const TemplateMatcher::GrayPlane& gray, const ImageProcessor::RectangleDetectionOptions& options,
+                        std::vector<uint8_t>& mask, int threadCount)
+{
+    const int width = gray.width;
+    const int height = gray.height;
+    mask.assign(static_cast<size_t>(width) * height, 0);
+
+    TaskPool::forEachBand(height, threadCount, MaskMinRowsPerBand, [&](int, int first, int last) {
+        if (options.useEdges) {
+            // 中心差分梯度，图像最外圈保持为背景
+            const int threshold = options.edgeThreshold;
+            for (int y = std::max(first, 1); y < std::min(last, height - 1); ++y) {
+                const uint8_t* up = gray.row(y - 1);
+                const uint8_t* row = gray.row(y);
+                const uint8_t* down = gray.row(y + 1);
+                uint8_t* dst = mask.data() + static_cast<size_t>(y) * width;
+                for (int x = 1; x < width - 1; ++x) {
+                    const int dx = row[x + 1] - row[x - 1];
+                    const int dy = down[x] - up[x];
+                    dst[x] = (std::abs(dx) + std::abs(dy) >= threshold) ? 255 : 0;
+                }
+            }
+            return;
+        }
+
+        const int threshold = options.grayThreshold;
+        const uint8_t foreground = options.darkForeground ? 0 : 255;
+        for (int y = first; y < last; ++y) {
+            const uint8_t* row = gray.row(y);
+            uint8_t* dst = mask.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                dst[x] = row[x] >= threshold ? foreground : static_cast<uint8_t>(255 - foreground);
+            }
+        }
+    });
+}
+
+double sideCoverage(const std::vector<uint8_t>& covered)
+{
+    const int length = static_cast<int>(covered.size());
+    const int margin = std::min(CornerMargin, length / 4);
+    int count = 0;
+    for (int i = margin; i < length - margin; ++i) {
+        count += covered[i];
+    }
+    return static_cast<double>(count) / (length - 2 * margin);
+}
+
+}
+
+ImageProcessor::ProcessResult ImageProcessor::detectRectangles(const QImage& input,
+                                                              std::vector<QRect>& rectangles,
+                                                              double threshold)
+{
+    RectangleDetectionOptions options;
+    options.tolerance = threshold;
+    return detectRectangles(input, rectangles, options);
+}
+
+ImageProcessor::ProcessResult ImageProcessor::detectRectangles(const QImage& input,
+                                                              std::vector<QRect>& rectangles,
+                                                              const RectangleDetectionOptions& options)
+{
+    rectangles.clear();
+    if (!validateInputs(input)) {
+        return ProcessResult::InvalidInput;
+    }
+
+    const int threadCount = options.threadCount > 0 ? options.threadCount : workerThreadCount();
+    const TemplateMatcher::GrayPlane gray = TemplateMatcher::toGrayPlane(input);
+    std::vector<uint8_t> mask;
+    buildRectangleMask(gray, options, mask, threadCount);
+
+    const ConnectedComponents::Labeling labeling = ConnectedComponents::label(
+        mask.data(), gray.width, gray.height, gray.width, ConnectedComponents::Connectivity::Eight, threadCount);
+
+    // 中心差分使边缘两侧各有1像素，边缘模式下外接矩形比实际边框大1像素
+    const int inset = options.useEdges ? 1 : 0;
+    std::vector<RectangleCandidate> candidates;
+    std::vector<int> candidateOf(labeling.components.size(), -1);
+    for (size_t i = 0; i < labeling.components.size(); ++i) {
+        const QRect& bounds = labeling.components[i].bounds;
+        if (bounds.width() - 2 * inset < options.minWidth || bounds.height() - 2 * inset < options.minHeight) {
+            continue;
+        }
+        RectangleCandidate candidate;
+        candidate.bounds = bounds;
+        candidate.top.assign(bounds.width(), 0);
+        candidate.bottom.assign(bounds.width(), 0);
+        candidate.left.assign(bounds.height(), 0);
+        candidate.right.assign(bounds.height(), 0);
+        candidateOf[i] = static_cast<int>(candidates.size());
+        candidates.push_back(std::move(candidate));
+    }
+
+    // 只遍历行程统计四条边的覆盖情况，不需要逐像素的标签图
+    for (size_t i = 0; i < labeling.runs.size(); ++i) {
+        const int index = candidateOf[labeling.runLabels[i]];
+        if (index < 0) {
+            continue;
+        }
+        RectangleCandidate& candidate = candidates[index];
+        const ConnectedComponents::Run& run = labeling.runs[i];
+        const QRect& bounds = candidate.bounds;
+
+        if (run.row <= bounds.top() + 1) {
+            std::fill(candidate.top.begin() + (run.start - bounds.left()), candidate.top.begin() + (run.end - bounds.left()), 1);
+        }
+        if (run.row >= bounds.bottom() - 1) {
+            std::fill(candidate.bottom.begin() + (run.start - bounds.left()), candidate.bottom.begin() + (run.end - bounds.left()), 1);
+        }
+        if (run.start <= bounds.left() + 1) {
+            candidate.left[run.row - bounds.top()] = 1;
+        }
+        if (run.end - 1 >= bounds.right() - 1) {
+            candidate.right[run.row - bounds.top()] = 1;
+        }
+    }
+
+    const double minCoverage = 1.0 - std::clamp(options.tolerance, 0.0, 1.0);
+    std::vector<QRect> found;
+    for (const RectangleCandidate& candidate : candidates) {
+        if (sideCoverage(candidate.top) >= minCoverage && sideCoverage(candidate.bottom) >= minCoverage &&
+            sideCoverage(candidate.left) >= minCoverage && sideCoverage(candidate.right) >= minCoverage) {
+            found.push_back(candidate.bounds.adjusted(inset, inset, -inset, -inset));
+        }
+    }
+
+    // 有宽度的边框会同时产生外轮廓和内轮廓，只保留外层
+    const int distance = std::max(0, options.mergeDistance);
+    for (size_t i = 0; i < found.size(); ++i) {
+        const QRect& inner = found[i];
+        bool nested = false;
+        for (size_t j = 0; j < found.size() && !nested; ++j) {
+            const QRect& outer = found[j];
+            // 完全相同的矩形只保留第一个
+            nested = j != i && (outer != inner || j < i) && outer.contains(inner) &&
+                     inner.left() - outer.left() <= distance && inner.top() - outer.top() <= distance &&
+                     outer.right() - inner.right() <= distance && outer.bottom() - inner.bottom() <= distance;
+        }
+        if (!nested) {
+            rectangles.push_back(inner);
+        }
+    }
+
+    std::sort(rectangles.begin(), rectangles.end(), [](const QRect& a, const QRect& b) {
+        return a.top() != b.top() ? a.top() < b.top() : a.left() < b.left();
+    });
+    return ProcessResult::Success;
+}
+
+// ========== 颜色区域查找 ==========
+
+namespace {
+
+int normalizeHue(int hue)
+{
+    return ((hue % 360) + 360) % 360;
+}
+
+// 度数区间[hueLow, hueHigh]转换为内核使用的扇区区间[hueLow/60, (hueHigh+1)/60)
+PixelKernels::HsvRange toKernelRange(const ImageProcessor::ColorRange& range)
+{
+    PixelKernels::HsvRange hsv;
+    hsv.hueLow = normalizeHue(range.hueLow) / 60.0f;
+    hsv.hueHigh = (normalizeHue(range.hueHigh) + 1) / 60.0f;
+    hsv.saturationLow = qBound(0, range.saturationLow, 256);
+    hsv.saturationHigh = qBound(-1, range.saturationHigh, 255);
+    hsv.valueLow = range.valueLow;
+    hsv.valueHigh = range.valueHigh;
+    return hsv;
+}
+
+}
+
+ImageProcessor::ColorRange ImageProcessor::ColorRange::rgb(const QColor& color, int tolerance)
+{
+    ColorRange range;
+    range.space = Space::Rgb;
+    range.low = QColor(qBound(0, color.red() - tolerance, 255), qBound(0, color.green() - tolerance, 255),
+                       qBound(0, color.blue() - tolerance, 255));
+    range.high = QColor(qBound(0, color.red() + tolerance, 255), qBound(0, color.green() + tolerance, 255),
+                        qBound(0, color.blue() + tolerance, 255));
+    return range;
+}
+
+ImageProcessor::ColorRange ImageProcessor::ColorRange::hsv(int hue, int hueTolerance, int minSaturation, int minValue)
+{
+    ColorRange range;
+    range.space = Space::Hsv;
+    if (hueTolerance < 180) {
+        range.hueLow = normalizeHue(hue - hueTolerance);
+        range.hueHigh = normalizeHue(hue + hueTolerance);
+    }
+    range.saturationLow = minSaturation;
+    range.valueLow = minValue;
+    return range;
+}
+
+ImageProcessor::ProcessResult ImageProcessor::findColorBlobs(const QImage& frame, const ColorRange& range,
+                                                            std::vector<ColorBlob>& blobs)
+{
+    return findColorBlobs(frame, range, blobs, ColorBlobOptions());
+}
+
+ImageProcessor::ProcessResult ImageProcessor::findColorBlobs(const QImage& frame, const ColorRange& range,
+                                                            std::vector<ColorBlob>& blobs,
+                                                            const ColorBlobOptions& options)
+{
+    blobs.clear();
+    if (!validateInputs(frame)) {
+        return ProcessResult::InvalidInput;
+    }
+    const QRect area = options.searchRect.isNull() ? frame.rect() : options.searchRect.intersected(frame.rect());
+    if (area.isEmpty()) {
+        return ProcessResult::InvalidInput;
+    }
+
+    const QImage color = TemplateMatcher::toColorBuffer(frame);
+    const int width = area.width();
+    const int height = area.height();
+    const int threadCount = options.threadCount > 0 ? options.threadCount : workerThreadCount();
+    const uint32_t low = range.low.rgb();
+    const uint32_t high = range.high.rgb();
+    const PixelKernels::HsvRange hsv = toKernelRange(range);
+
+    std::vector<uint8_t> mask(static_cast<size_t>(width) * height);
+    TaskPool::forEachBand(height, threadCount, MaskMinRowsPerBand, [&](int, int first, int last) {
+        for (int y = first; y < last; ++y) {
+            const uint32_t* src = reinterpret_cast<const uint32_t*>(color.constScanLine(area.y() + y)) + area.x();
+            uint8_t* dst = mask.data() + static_cast<size_t>(y) * width;
+            if (range.space == ColorRange::Space::Hsv) {
+                PixelKernels::hsvRangeMask(src, width, hsv, dst);
+            } else {
+                PixelKernels::rgbRangeMask(src, width, low, high, dst);
+            }
+        }
+    });
+
+    const ConnectedComponents::Labeling labeling = ConnectedComponents::label(
+        mask.data(), width, height, width,
+        options.eightConnected ? ConnectedComponents::Connectivity::Eight : ConnectedComponents::Connectivity::Four,
+        threadCount);
+
+    for (const ConnectedComponents::Component& component : labeling.components) {
+        if (component.pixelCount < options.minPixels) {
+            continue;
+        }
+        ColorBlob blob;
+        blob.bounds = component.bounds.translated(area.topLeft());
+        blob.centroid = component.centroid() + QPointF(area.topLeft());
+        blob.pixelCount = static_cast<int>(component.pixelCount);
+        blobs.push_back(blob);
+    }
+
+    // 像素数相同时保持光栅顺序
+    std::stable_sort(blobs.begin(), blobs.end(), [](const ColorBlob& a, const ColorBlob& b) {
+        return a.pixelCount > b.pixelCount;
+    });
+    if (options.maxResults > 0 && blobs.size() > static_cast<size_t>(options.maxResults)) {
+        blobs.resize(options.maxResults);
+    }
+    return ProcessResult::Success;
+}
+
+// ========== 多点颜色特征 ==========
+
+bool ImageProcessor::matchColorSignature(const QImage& frame, const std::vector<ColorSignature::Point>& signature,
+                                         const QPoint& anchor)
+{
+    if (!validateInputs(frame)) {
+        return false;
+    }
+    return ColorSignature::matchAt(TemplateMatcher::toColorBuffer(frame), signature, anchor);
+}
+
+ImageProcessor::ProcessResult ImageProcessor::findColorSignature(const QImage& frame,
+                                                                const std::vector<ColorSignature::Point>& signature,
+                                                                std::vector<QPoint>& anchors)
+{
+    return findColorSignature(frame, signature, anchors, QRect());
+}
+
+ImageProcessor::ProcessResult ImageProcessor::findColorSignature(const QImage& frame,
+                                                                const std::vector<ColorSignature::Point>& signature,
+                                                                std::vector<QPoint>& anchors,
+                                                                const QRect& searchRect, int maxResults)
+{
+    anchors.clear();
+    if (!validateInputs(frame) || signature.empty()) {
+        return ProcessResult::InvalidInput;
+    }
+    const QRect area = searchRect.isNull() ? frame.rect() : searchRect.intersected(frame.rect());
+    if (area.isEmpty()) {
+        return ProcessResult::InvalidInput;
+    }
+
+    // 小范围查找直接扫描，不为此建立整帧索引；已有索引时总是使用
+    std::shared_ptr<const ColorSignature::FrameIndex> index;
+    {
+        std::lock_guard<std::mutex> locker(colorIndexCacheMutex);
+        for (const ColorIndexCacheEntry& entry : colorIndexCache) {
+            if (entry.imageKey == frame.cacheKey()) {
+                index = entry.index;
+                break;
+            }
+        }
+    }
+    if (!index && static_cast<int64_t>(area.width()) * area.height() * 4 >= static_cast<int64_t>(frame.width()) * frame.height()) {
+        index = colorIndex(frame);
+    }
+
+    const ColorSignature::FrameIndex noIndex;
+    anchors = ColorSignature::find(TemplateMatcher::toColorBuffer(frame), index ? *index : noIndex,
+                                   signature, area, maxResults);
+    return ProcessResult::Success;
+}
+
+std::shared_ptr<const ColorSignature::FrameIndex> ImageProcessor::colorIndex(const QImage& frame)
+{
+    if (!validateInputs(frame)) {
+        return nullptr;
+    }
+
+    const qint64 imageKey = frame.cacheKey();
+    {
+        std::lock_guard<std::mutex> locker(colorIndexCacheMutex);
+        auto cached = std::find_if(colorIndexCache.begin(), colorIndexCache.end(), [imageKey](const ColorIndexCacheEntry& entry) {
+            return entry.imageKey == imageKey;
+        });
+        if (cached != colorIndexCache.end()) {
+            std::rotate(colorIndexCache.begin(), cached, cached + 1);
+            return colorIndexCache.front().index;
+        }
+    }
+
+    auto index = std::make_shared<const ColorSignature::FrameIndex>(
+        ColorSignature::buildIndex(TemplateMatcher::toColorBuffer(frame), workerThreadCount()));
+
+    std::lock_guard<std::mutex> locker(colorIndexCacheMutex);
+    colorIndexCache.insert(colorIndexCache.begin(), ColorIndexCacheEntry{imageKey, index});
+    if (colorIndexCache.size() > static_cast<size_t>(ColorIndexCacheSize)) {
+        colorIndexCache.pop_back();
+    }
+    return index;
+}
+
+void ImageProcessor::clearColorIndexCache()
+{
+    std::lock_guard<std::mutex> locker(colorIndexCacheMutex);
+    colorIndexCache.clear();
+}
+
 // ========== 模板匹配 ==========
 
 ImageProcessor::ProcessResult ImageProcessor::templateMatch(const QImage& source, const QImage& template_,
                                                            QPoint& bestMatch, double& confidence)
 {
-    if (!validateInputs(source) || !validateInputs(template_)) {
+    return templateMatch(source, template_, bestMatch, confidence, TemplateMatchOptions());
+}
+
+ImageProcessor::ProcessResult ImageProcessor::templateMatch(const QImage& source, const QImage& template_,
+                                                           QPoint& bestMatch, double& confidence,
+                                                           const TemplateMatchOptions& options)
+{
+    TemplateMatcher::SequentialStatistics statistics;
+    return templateMatch(source, template_, bestMatch, confidence, options, statistics);
+}
+
+ImageProcessor::ProcessResult ImageProcessor::templateMatch(const QImage& source, const QImage& template_,
+                                                           QPoint& bestMatch, double& confidence,
+                                                           const TemplateMatchOptions& options,
+                                                           TemplateMatcher::SequentialStatistics& statistics)
+{
+    statistics = TemplateMatcher::SequentialStatistics();
+    if (!validateInputs(source) || !validateInputs(template_) ||
+        options.pyramidLevels < 0 || options.refineRadius < 0 || options.hintRadius < 0) {
         return ProcessResult::InvalidInput;
     }
 
-    // Qt实现的简单模板匹配
     bestMatch = QPoint(0, 0);
-    confidence = 0.0;
-    double bestScore = -1.0;
-    
-    // 遍历源图像的每个可能位置
-    for (int y = 0; y <= source.height() - template_.height(); ++y) {
-        for (int x = 0; x <= source.width() - template_.width(); ++x) {
-            double score = calculateTemplateScore(source, template_, x, y);
-            if (score > bestScore) {
-                bestScore = score;
-                bestMatch = QPoint(x, y);
+    confidence = -1.0;
+
+    const TemplateMatcher::PreparedTemplate preparedTemplate =
+        prepareMatchTemplate(template_, options.templateMask, options);
+    if (!preparedTemplate.isValid()) {
+        return ProcessResult::InvalidInput;
+    }
+
+    // 搜索区域内放不下模板（或模板大于源图像）时没有有效位置
+    QRect searchArea;
+    if (!resolveSearchArea(options.searchRect, source, template_.size(), searchArea)) {
+        return ProcessResult::Success;
+    }
+
+    TemplateMatcher::SearchHint hint;
+    if (options.useLastHitHint) {
+        std::lock_guard<std::mutex> locker(matchHintMutex);
+        auto it = matchHints.find(template_.cacheKey());
+        if (it != matchHints.end()) {
+            hint.valid = true;
+            hint.location = it->second;
+            hint.radius = options.hintRadius;
+            hint.minConfidence = options.minConfidence;
+        }
+    }
+
+    const TemplateMatcher::PreparedSource preparedSource = prepareMatchSource(source, options);
+    const TemplateMatcher::MatchCandidate candidate =
+        matchPrepared(preparedSource, preparedTemplate, searchArea, hint, options, statistics);
+    bestMatch = candidate.location;
+    confidence = candidate.confidence;
+
+    if (options.useLastHitHint) {
+        std::lock_guard<std::mutex> locker(matchHintMutex);
+        if (confidence >= options.minConfidence) {
+            matchHints[template_.cacheKey()] = bestMatch;
+        } else {
+            matchHints.erase(template_.cacheKey());
+        }
+    }
+    return ProcessResult::Success;
+}
+
+ImageProcessor::ProcessResult ImageProcessor::templateMatchAll(const QImage& source, const QImage& template_,
+                                                              std::vector<TemplateMatcher::MatchCandidate>& matches)
+{
+    return templateMatchAll(source, template_, matches, TemplateMatchOptions());
+}
+
+ImageProcessor::ProcessResult ImageProcessor::templateMatchAll(const QImage& source, const QImage& template_,
+                                                              std::vector<TemplateMatcher::MatchCandidate>& matches,
+                                                              const TemplateMatchOptions& options)
+{
+    matches.clear();
+    if (!validateInputs(source) || !validateInputs(template_) ||
+        options.maxOverlap < 0.0 || options.maxOverlap > 1.0 || options.maxResults < 0) {
+        return ProcessResult::InvalidInput;
+    }
+
+    TemplateMatchOptions singleLevel = options;
+    singleLevel.pyramidLevels = 0;
+    const TemplateMatcher::PreparedTemplate preparedTemplate =
+        prepareMatchTemplate(template_, options.templateMask, singleLevel);
+    if (!preparedTemplate.isValid()) {
+        return ProcessResult::InvalidInput;
+    }
+
+    QRect searchArea;
+    if (!resolveSearchArea(options.searchRect, source, template_.size(), searchArea)) {
+        return ProcessResult::Success;
+    }
+
+    const TemplateMatcher::PreparedSource preparedSource = TemplateMatcher::prepareSource(source);
+
+    matches = TemplateMatcher::findAllMatches(preparedSource, preparedTemplate,
+                                              options.multiMatchParameters(), searchArea, options.method);
+    return ProcessResult::Success;
+}
+
+ImageProcessor::ProcessResult ImageProcessor::templateMatchMultiScale(const QImage& source, const QImage& template_,
+                                                                     QPoint& bestMatch, double& confidence, double& scale,
+                                                                     const TemplateMatchOptions& options)
+{
+    bestMatch = QPoint(0, 0);
+    confidence = -1.0;
+    scale = 1.0;
+
+    std::vector<double> scales = options.templateScales.empty() ? std::vector<double>{1.0} : options.templateScales;
+    if (!validateInputs(source) || !validateInputs(template_) ||
+        options.pyramidLevels < 0 || options.refineRadius < 0 || options.hintRadius < 0 ||
+        (!options.templateMask.isNull() && options.templateMask.size() != template_.size()) ||
+        std::any_of(scales.begin(), scales.end(), [](double s) { return s <= 0.0; })) {
+        return ProcessResult::InvalidInput;
+    }
+
+    // 上次命中的比例排在最前，命中时不再尝试其他比例
+    const auto scaleKey = std::make_tuple(template_.cacheKey(), source.width(), source.height());
+    bool rememberedFirst = false;
+    TemplateMatcher::SearchHint hint;
+    {
+        std::lock_guard<std::mutex> locker(matchHintMutex);
+        auto remembered = matchScales.find(scaleKey);
+        if (remembered != matchScales.end()) {
+            auto position = std::find(scales.begin(), scales.end(), remembered->second);
+            if (position != scales.end()) {
+                std::rotate(scales.begin(), position, position + 1);
+                rememberedFirst = true;
             }
         }
+
+        auto it = matchHints.find(template_.cacheKey());
+        if (options.useLastHitHint && rememberedFirst && it != matchHints.end()) {
+            hint.valid = true;
+            hint.location = it->second;
+            hint.radius = options.hintRadius;
+            hint.minConfidence = options.minConfidence;
+        }
+    }
+
+    // 源图像只预处理一次，所有比例共享灰度平面、积分图与金字塔
+    const TemplateMatcher::PreparedSource preparedSource = prepareMatchSource(source, options);
+    const QImage templateColor = TemplateMatcher::toColorBuffer(template_);
+    TemplateMatcher::SequentialStatistics statistics;
+
+    TemplateMatcher::MatchCandidate best;
+    bool anyValid = false;
+    for (size_t i = 0; i < scales.size(); ++i) {
+        const QSize size(std::max(1, qRound(template_.width() * scales[i])),
+                         std::max(1, qRound(template_.height() * scales[i])));
+        QRect searchArea;
+        if (!resolveSearchArea(options.searchRect, source, size, searchArea)) {
+            continue;
+        }
+
+        const bool original = size == template_.size();
+        const QImage scaledTemplate = original
+            ? templateColor
+            : templateColor.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        const QImage scaledMask = (original || options.templateMask.isNull())
+            ? options.templateMask
+            : options.templateMask.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        const TemplateMatcher::PreparedTemplate prepared = prepareMatchTemplate(scaledTemplate, scaledMask, options);
+        if (!prepared.isValid()) {
+            continue;
+        }
+        anyValid = true;
+
+        const TemplateMatcher::MatchCandidate candidate = matchPrepared(
+            preparedSource, prepared, searchArea, i == 0 ? hint : TemplateMatcher::SearchHint(), options, statistics);
+        if (candidate.confidence > best.confidence) {
+            best = candidate;
+            scale = scales[i];
+        }
+        if (i == 0 && rememberedFirst && candidate.confidence >= options.minConfidence) {
+            break;
+        }
+    }
+
+    if (!anyValid) {
+        return ProcessResult::Success;
+    }
+    bestMatch = best.location;
+    confidence = best.confidence;
+
+    std::lock_guard<std::mutex> locker(matchHintMutex);
+    if (confidence >= options.minConfidence) {
+        matchScales[scaleKey] = scale;
+        if (options.useLastHitHint) {
+            matchHints[template_.cacheKey()] = bestMatch;
+        }
+    } else {
+        matchScales.erase(scaleKey);
+        matchHints.erase(template_.cacheKey());
     }
-    
-    confidence = bestScore;
     return ProcessResult::Success;
 }
 
-// ========== 异步处理 ==========
+void ImageProcessor::clearMatchHints()
+{
+    std::lock_guard<std::mutex> locker(matchHintMutex);
+    matchHints.clear();
+    matchScales.clear();
+}
 
-// ========== 模板匹配辅助方法 ==========
+TemplateMatcher::PreparedSource ImageProcessor::prepareMatchSource(const QImage& source,
+                                                                  const TemplateMatchOptions& options)
+{
+    // 序贯相似性检测只需要颜色缓冲区，不构建灰度平面和积分图
+    if (options.earlyTermination) {
+        TemplateMatcher::PreparedSource prepared;
+        prepared.color = TemplateMatcher::toColorBuffer(source);
+        return prepared;
+    }
+    return TemplateMatcher::prepareSource(source, options.pyramidLevels);
+}
 
-double ImageProcessor::calculateTemplateScore(const QImage& source, const QImage& template_, int x, int y)
+TemplateMatcher::MatchCandidate ImageProcessor::matchPrepared(const TemplateMatcher::PreparedSource& source,
+                                                              const TemplateMatcher::PreparedTemplate& templ,
+                                                              const QRect& searchArea,
+                                                              const TemplateMatcher::SearchHint& hint,
+                                                              const TemplateMatchOptions& options,
+                                                              TemplateMatcher::SequentialStatistics& statistics)
 {
-    if (x + template_.width() > source.width() || y + template_.height() > source.height()) {
-        return -1.0;
+    if (!options.earlyTermination) {
+        // 金字塔层数为0时等价于原始分辨率全图搜索，置信度按原有的颜色差评分在原始分辨率上计算
+        return TemplateMatcher::findBestMatchWithHint(
+            source, templ, hint, options.pyramidParameters(), searchArea, options.method);
     }
-    
-    double score = 0.0;
-    int totalPixels = template_.width() * template_.height();
-    
-    for (int ty = 0; ty < template_.height(); ++ty) {
-        for (int tx = 0; tx < template_.width(); ++tx) {
-            QColor sourcePixel = source.pixelColor(x + tx, y + ty);
-            QColor templatePixel = template_.pixelColor(tx, ty);
-            
-            // 计算颜色相似度
-            double rDiff = qAbs(sourcePixel.red() - templatePixel.red()) / 255.0;
-            double gDiff = qAbs(sourcePixel.green() - templatePixel.green()) / 255.0;
-            double bDiff = qAbs(sourcePixel.blue() - templatePixel.blue()) / 255.0;
-            
-            double pixelScore = 1.0 - (rDiff + gDiff + bDiff) / 3.0;
-            score += pixelScore;
+
+    // 提示邻域内只接受达到minConfidence的位置，否则回退到整个搜索区域
+    TemplateMatcher::MatchCandidate candidate;
+    if (hint.valid) {
+        const QRect neighbourhood = QRect(hint.location.x() - hint.radius, hint.location.y() - hint.radius,
+                                          2 * hint.radius + 1, 2 * hint.radius + 1).intersected(searchArea);
+        if (!neighbourhood.isEmpty()) {
+            candidate = TemplateMatcher::findBestMatchSequential(
+                source.color, templ, std::max(options.rejectConfidence, options.minConfidence),
+                neighbourhood, &statistics);
         }
     }
-    
-    return score / totalPixels;
+    if (candidate.confidence < options.minConfidence) {
+        candidate = TemplateMatcher::findBestMatchSequential(
+            source.color, templ, options.rejectConfidence, searchArea, &statistics);
+    }
+    return candidate;
+}
+
+TemplateMatcher::PreparedTemplate ImageProcessor::prepareMatchTemplate(const QImage& template_, const QImage& mask,
+                                                                      const TemplateMatchOptions& options)
+{
+    if (!mask.isNull() && mask.size() != template_.size()) {
+        return TemplateMatcher::PreparedTemplate();
+    }
+
+    // 不使用alpha时去掉alpha通道，透明像素按其RGB值参与比较（原有行为）
+    const QImage image = (!options.useTemplateAlpha && template_.hasAlphaChannel())
+        ? template_.convertToFormat(QImage::Format_RGB32)
+        : template_;
+    return TemplateMatcher::prepareTemplate(image, options.pyramidLevels, mask);
+}
+
+bool ImageProcessor::resolveSearchArea(const QRect& searchRect, const QImage& source,
+                                       const QSize& templateSize, QRect& searchArea)
+{
+    const QRect region = searchRect.isNull() ? source.rect() : searchRect.intersected(source.rect());
+    const QRect positions = TemplateMatcher::positionsInRegion(region, templateSize.width(), templateSize.height());
+    if (positions.isEmpty()) {
+        return false;
+    }
+
+    searchArea = positions;
+    return true;
 }
 
-void ImageProcessor::resizeImageAsync(const QImage& input, int width, int height,
-                                     ScaleAlgorithm algorithm, ProcessCallback callback)
+// ========== 积分图 ==========
+
+std::shared_ptr<const IntegralImage::Tables> ImageProcessor::integralImage(const QImage& image,
+                                                                           IntegralImage::Channel channel)
 {
-    // 存储 future 对象以避免 nodiscard 警告
-    auto future = std::async(std::launch::async, [this, input, width, height, algorithm, callback]() {
+    if (!validateInputs(image)) {
+        return nullptr;
+    }
+
+    const qint64 imageKey = image.cacheKey();
+    {
+        std::lock_guard<std::mutex> locker(integralCacheMutex);
+        auto cached = std::find_if(integralCache.begin(), integralCache.end(), [&](const IntegralCacheEntry& entry) {
+            return entry.imageKey == imageKey && entry.channel == channel;
+        });
+        if (cached != integralCache.end()) {
+            std::rotate(integralCache.begin(), cached, cached + 1);
+            return integralCache.front().tables;
+        }
+    }
+
+    // 计算期间不持有锁，其他线程可以同时查询缓存
+    auto tables = std::make_shared<const IntegralImage::Tables>(
+        IntegralImage::build(image, channel, workerThreadCount()));
+
+    std::lock_guard<std::mutex> locker(integralCacheMutex);
+    integralCache.insert(integralCache.begin(), IntegralCacheEntry{imageKey, channel, tables});
+    if (integralCache.size() > static_cast<size_t>(IntegralCacheSize)) {
+        integralCache.pop_back();
+    }
+    return tables;
+}
+
+void ImageProcessor::clearIntegralCache()
+{
+    std::lock_guard<std::mutex> locker(integralCacheMutex);
+    integralCache.clear();
+}
+
+// ========== 异步处理 ==========
+
+// ========== 模板匹配辅助方法 ==========
+
+double ImageProcessor::calculateTemplateScore(const QImage& source, const QImage& template_, int x, int y)
+{
+    return TemplateMatcher::colorScoreAt(source, template_, x, y);
+}
+
+CancellationToken ImageProcessor::resizeImageAsync(const QImage& input, int width, int height,
+                                                   ScaleAlgorithm algorithm, ProcessCallback callback,
+                                                   const AsyncOptions& options)
+{
+    return submitAsync(options, [this, input, width, height, algorithm, callback]() {
         QImage output;
         ProcessResult result = resizeImage(input, output, width, height, algorithm);
-        callback(result, output);
+        return imageDelivery(result, output, callback);
     });
-    // future 对象会在作用域结束时自动析构
-    (void)future; // 明确表示我们不使用返回值
 }
 
-void ImageProcessor::applyFilterAsync(const QImage& input, FilterType filter, 
-                                     double intensity, ProcessCallback callback)
+CancellationToken ImageProcessor::applyFilterAsync(const QImage& input, FilterType filter, 
+                                                   double intensity, ProcessCallback callback,
+                                                   const AsyncOptions& options)
 {
-    // 存储 future 对象以避免 nodiscard 警告
-    auto future = std::async(std::launch::async, [this, input, filter, intensity, callback]() {
+    return submitAsync(options, [this, input, filter, intensity, callback]() {
         QImage output;
         ProcessResult result = applyFilter(input, output, filter, intensity);
-        callback(result, output);
+        return imageDelivery(result, output, callback);
+    });
+}
+
+CancellationToken ImageProcessor::runPipelineAsync(const QImage& input, const FilterPipeline& pipeline,
+                                                   ProcessCallback callback, const AsyncOptions& options)
+{
+    return submitAsync(options, [this, input, copy = pipeline, callback]() mutable {
+        QImage output;
+        ProcessResult result = runPipeline(input, output, copy);
+        return imageDelivery(result, output, callback);
     });
-    // future 对象会在作用域结束时自动析构
-    (void)future; // 明确表示我们不使用返回值
+}
+
+CancellationToken ImageProcessor::templateMatchAsync(const QImage& source, const QImage& template_,
+                                                     const TemplateMatchOptions& matchOptions,
+                                                     MatchCallback callback, const AsyncOptions& options)
+{
+    return submitAsync(options, [this, source, template_, matchOptions, callback]() -> std::function<void()> {
+        QPoint bestMatch;
+        double confidence = 0.0;
+        double scale = 1.0;
+        ProcessResult result = matchOptions.templateScales.empty()
+            ? templateMatch(source, template_, bestMatch, confidence, matchOptions)
+            : templateMatchMultiScale(source, template_, bestMatch, confidence, scale, matchOptions);
+        return [callback, result, bestMatch, confidence, scale]() {
+            if (callback) {
+                callback(result, bestMatch, confidence, scale);
+            }
+        };
+    });
+}
+
+CancellationToken ImageProcessor::templateMatchAllAsync(const QImage& source, const QImage& template_,
+                                                        const TemplateMatchOptions& matchOptions,
+                                                        MatchAllCallback callback, const AsyncOptions& options)
+{
+    return submitAsync(options, [this, source, template_, matchOptions, callback]() -> std::function<void()> {
+        std::vector<TemplateMatcher::MatchCandidate> matches;
+        ProcessResult result = templateMatchAll(source, template_, matches, matchOptions);
+        return [callback, result, matches = std::move(matches)]() {
+            if (callback) {
+                callback(result, matches);
+            }
+        };
+    });
+}
+
+CancellationToken ImageProcessor::recognizeTextAsync(const QImage& input, const QString& language,
+                                                     TextCallback callback, const AsyncOptions& options)
+{
+    return submitAsync(options, [this, input, language, callback]() -> std::function<void()> {
+        QString text;
+        ProcessResult result = recognizeText(input, text, language);
+        return [callback, result, text]() {
+            if (callback) {
+                callback(result, text);
+            }
+        };
+    });
+}
+
+CancellationToken ImageProcessor::submitAsync(const AsyncOptions& options,
+                                              std::function<std::function<void()>()> work)
+{
+    // 中转对象在回调线程中接收排队调用，随任务及排队调用一起释放（任务被丢弃时也会释放）
+    std::shared_ptr<QObject> relay(new QObject, [](QObject* object) { object->deleteLater(); });
+    if (options.context) {
+        relay->moveToThread(options.context->thread());
+    }
+    QPointer<QObject> context = options.context;
+    const bool hasContext = options.context != nullptr;
+    const CancellationToken token = options.token;
+
+    taskPool->submit([relay, context, hasContext, token, work = std::move(work)]() {
+        std::function<void()> deliver = work();
+        if (token.isCancelled()) {
+            return;
+        }
+        QMetaObject::invokeMethod(relay.get(), [relay, context, hasContext, token, deliver = std::move(deliver)]() {
+            if (!token.isCancelled() && (!hasContext || context)) {
+                deliver();
+            }
+        }, Qt::QueuedConnection);
+    }, options.priority, token);
+    return token;
+}
+
+std::function<void()> ImageProcessor::imageDelivery(ProcessResult result, const QImage& output,
+                                                    const ProcessCallback& callback)
+{
+    QPointer<ImageProcessor> self(this);
+    return [self, result, output, callback]() {
+        if (callback) {
+            callback(result, output);
+        }
+        if (self) {
+            emit self->processingCompleted(result, output);
+        }
+    };
 }
 
 // ========== 实用功能 ==========
@@ -481,13 +1210,19 @@ bool ImageProcessor::isGpuAccelerationEnabled() const
 void ImageProcessor::setProcessingThreads(int threadCount)
 {
     if (threadCount > 0) {
-        processingThreads = threadCount;
+        processingThreads.store(threadCount, std::memory_order_relaxed);
+        taskPool->setThreadCount(threadCount);
     }
 }
 
 int ImageProcessor::getProcessingThreads() const
 {
-    return processingThreads;
+    return processingThreads.load(std::memory_order_relaxed);
+}
+
+int ImageProcessor::workerThreadCount() const
+{
+    return std::max(1, processingThreads.load(std::memory_order_relaxed));
 }
 
 void ImageProcessor::setOCRLanguage(const QString& language)
@@ -517,7 +1252,10 @@ bool ImageProcessor::isOCRAvailable() const
 
 void ImageProcessor::handleError(const QString& errorMessage)
 {
-    lastErrorMessage = errorMessage;
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        lastErrorMessage = errorMessage;
+    }
     emit processingError(errorMessage);
     qWarning() << "ImageProcessor Error:" << errorMessage;
 }
@@ -559,4 +1297,294 @@ QString calculateImageHash(const QImage& image)
     return hash.result().toHex();
 }
 
-}
\ No newline at end of file
+// ========== 感知哈希 ==========
+
+namespace {
+
+// 缩略图每个格子在每个方向上最多取的样本数，大图像不必逐像素累加
+const int ThumbnailSamples = 16;
+
+// 按格子求灰度均值的缩略图（按行存储）
+std::vector<double> grayThumbnail(const QImage& image, int width, int height)
+{
+    std::vector<double> cells(static_cast<size_t>(width) * height, 0.0);
+    if (image.isNull()) {
+        return cells;
+    }
+
+    // 图像小于缩略图时先放大，保证每个格子都有样本
+    QImage color = TemplateMatcher::toColorBuffer(image);
+    if (color.width() < width || color.height() < height) {
+        color = color.scaled(std::max(color.width(), width), std::max(color.height(), height),
+                             Qt::IgnoreAspectRatio, Qt::FastTransformation);
+    }
+
+    const int imageWidth = color.width();
+    const int imageHeight = color.height();
+    const int stepX = std::max(1, imageWidth / (width * ThumbnailSamples));
+    const int stepY = std::max(1, imageHeight / (height * ThumbnailSamples));
+
+    std::vector<int> columnCells;
+    for (int x = 0; x < imageWidth; x += stepX) {
+        columnCells.push_back(static_cast<int>(static_cast<int64_t>(x) * width / imageWidth));
+    }
+
+    std::vector<uint64_t> sums(cells.size(), 0);
+    std::vector<uint32_t> counts(cells.size(), 0);
+    for (int y = 0; y < imageHeight; y += stepY) {
+        const int cellRow = static_cast<int>(static_cast<int64_t>(y) * height / imageHeight) * width;
+        const QRgb* row = reinterpret_cast<const QRgb*>(color.constScanLine(y));
+        for (size_t i = 0; i < columnCells.size(); ++i) {
+            const size_t cell = cellRow + columnCells[i];
+            sums[cell] += qGray(row[i * stepX]);
+            ++counts[cell];
+        }
+    }
+
+    for (size_t i = 0; i < cells.size(); ++i) {
+        cells[i] = static_cast<double>(sums[i]) / counts[i];
+    }
+    return cells;
+}
+
+}
+
+uint64_t averageHash(const QImage& image)
+{
+    const std::vector<double> cells = grayThumbnail(image, 8, 8);
+    double mean = 0.0;
+    for (double value : cells) {
+        mean += value;
+    }
+    mean /= cells.size();
+
+    uint64_t hash = 0;
+    for (size_t i = 0; i < cells.size(); ++i) {
+        if (cells[i] > mean) {
+            hash |= uint64_t(1) << i;
+        }
+    }
+    return hash;
+}
+
+uint64_t differenceHash(const QImage& image)
+{
+    const std::vector<double> cells = grayThumbnail(image, 9, 8);
+    uint64_t hash = 0;
+    for (int y = 0; y < 8; ++y) {
+        const double* row = cells.data() + y * 9;
+        for (int x = 0; x < 8; ++x) {
+            if (row[x] > row[x + 1]) {
+                hash |= uint64_t(1) << (y * 8 + x);
+            }
+        }
+    }
+    return hash;
+}
+
+uint64_t dctHash(const QImage& image)
+{
+    const int size = 32;
+    const int lowFrequencies = 8;
+    const std::vector<double> cells = grayThumbnail(image, size, size);
+
+    // 只需要前8个频率的DCT-II基函数
+    const double pi = 3.14159265358979323846;
+    double basis[lowFrequencies][size];
+    for (int u = 0; u < lowFrequencies; ++u) {
+        for (int x = 0; x < size; ++x) {
+            basis[u][x] = std::cos((2 * x + 1) * u * pi / (2.0 * size));
+        }
+    }
+
+    // 先对每行做变换，再对列做变换
+    double rows[size][lowFrequencies];
+    for (int y = 0; y < size; ++y) {
+        for (int u = 0; u < lowFrequencies; ++u) {
+            double sum = 0.0;
+            for (int x = 0; x < size; ++x) {
+                sum += cells[y * size + x] * basis[u][x];
+            }
+            rows[y][u] = sum;
+        }
+    }
+
+    double coefficients[lowFrequencies * lowFrequencies];
+    for (int v = 0; v < lowFrequencies; ++v) {
+        for (int u = 0; u < lowFrequencies; ++u) {
+            double sum = 0.0;
+            for (int y = 0; y < size; ++y) {
+                sum += rows[y][u] * basis[v][y];
+            }
+            coefficients[v * lowFrequencies + u] = sum;
+        }
+    }
+
+    double sorted[lowFrequencies * lowFrequencies];
+    std::copy(std::begin(coefficients), std::end(coefficients), sorted);
+    std::sort(std::begin(sorted), std::end(sorted));
+    const double median = (sorted[31] + sorted[32]) / 2.0;
+
+    uint64_t hash = 0;
+    for (int i = 0; i < lowFrequencies * lowFrequencies; ++i) {
+        if (coefficients[i] > median) {
+            hash |= uint64_t(1) << i;
+        }
+    }
+    return hash;
+}
+
+uint64_t perceptualHash(const QImage& image, PerceptualHashType type)
+{
+    switch (type) {
+        case PerceptualHashType::Average:
+            return averageHash(image);
+        case PerceptualHashType::Difference:
+            return differenceHash(image);
+        case PerceptualHashType::Dct:
+            return dctHash(image);
+    }
+    return 0;
+}
+
+int hammingDistance(uint64_t first, uint64_t second)
+{
+    return std::popcount(first ^ second);
+}
+
+// ========== 感知哈希索引 ==========
+
+namespace {
+
+inline uint16_t hashChunk(uint64_t hash, int chunk)
+{
+    return static_cast<uint16_t>(hash >> (chunk * 16));
+}
+
+// 对与key恰好相差flips位（只翻转from及更高的位）的所有16位键调用visit
+template <typename Visitor>
+void forEachFlippedKey(uint16_t key, int flips, int from, Visitor& visit)
+{
+    if (flips == 0) {
+        visit(key);
+        return;
+    }
+    for (int bit = from; bit <= 16 - flips; ++bit) {
+        forEachFlippedKey(static_cast<uint16_t>(key ^ (1u << bit)), flips - 1, bit + 1, visit);
+    }
+}
+
+}
+
+int PerceptualHashIndex::insert(uint64_t hash, const QString& id)
+{
+    const int index = static_cast<int>(hashes.size());
+    hashes.push_back(hash);
+    ids.push_back(id);
+    for (int chunk = 0; chunk < ChunkCount; ++chunk) {
+        tables[chunk][hashChunk(hash, chunk)].push_back(index);
+    }
+    return index;
+}
+
+void PerceptualHashIndex::clear()
+{
+    hashes.clear();
+    ids.clear();
+    for (auto& table : tables) {
+        table.clear();
+    }
+}
+
+template <typename Visitor>
+void PerceptualHashIndex::visitChunkDistance(uint64_t hash, int chunkDistance, Visitor visit) const
+{
+    for (int chunk = 0; chunk < ChunkCount; ++chunk) {
+        const auto& table = tables[chunk];
+        auto lookup = [&table, &visit](uint16_t key) {
+            const auto bucket = table.find(key);
+            if (bucket != table.end()) {
+                for (int index : bucket->second) {
+                    visit(index);
+                }
+            }
+        };
+        forEachFlippedKey(hashChunk(hash, chunk), chunkDistance, 0, lookup);
+    }
+}
+
+std::vector<PerceptualHashIndex::Match> PerceptualHashIndex::search(uint64_t hash, int maxDistance) const
+{
+    std::vector<Match> matches;
+    if (maxDistance < 0 || hashes.empty()) {
+        return matches;
+    }
+
+    // 距离不超过maxDistance的条目至少有一段的距离不超过maxDistance/4
+    std::vector<int> found;
+    const int chunkDistance = maxDistance / ChunkCount;
+    if (chunkDistance > MaxProbeDistance) {
+        for (int index = 0; index < static_cast<int>(hashes.size()); ++index) {
+            if (hammingDistance(hash, hashes[index]) <= maxDistance) {
+                found.push_back(index);
+            }
+        }
+    } else {
+        for (int distance = 0; distance <= chunkDistance; ++distance) {
+            visitChunkDistance(hash, distance, [&](int index) {
+                if (hammingDistance(hash, hashes[index]) <= maxDistance) {
+                    found.push_back(index);
+                }
+            });
+        }
+        std::sort(found.begin(), found.end());
+        found.erase(std::unique(found.begin(), found.end()), found.end());
+    }
+
+    matches.reserve(found.size());
+    for (int index : found) {
+        matches.push_back(Match{ids[index], hashes[index], hammingDistance(hash, hashes[index]), index});
+    }
+    std::stable_sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        return a.distance < b.distance;
+    });
+    return matches;
+}
+
+bool PerceptualHashIndex::nearest(uint64_t hash, int maxDistance, Match& match) const
+{
+    if (maxDistance < 0 || hashes.empty()) {
+        return false;
+    }
+
+    int bestIndex = -1;
+    int bestDistance = maxDistance + 1;
+    auto consider = [&](int index) {
+        const int distance = hammingDistance(hash, hashes[index]);
+        if (distance < bestDistance || (distance == bestDistance && index < bestIndex)) {
+            bestIndex = index;
+            bestDistance = distance;
+        }
+    };
+
+    // 逐级增加每段的翻转位数：处理完第d级后，未访问的条目每段距离都大于d，总距离至少为4*(d+1)
+    bool complete = false;
+    for (int distance = 0; distance <= MaxProbeDistance && !complete; ++distance) {
+        visitChunkDistance(hash, distance, consider);
+        const int unvisitedBound = ChunkCount * (distance + 1);
+        complete = bestDistance <= unvisitedBound - 1 || unvisitedBound > maxDistance;
+    }
+    if (!complete) {
+        for (int index = 0; index < static_cast<int>(hashes.size()); ++index) {
+            consider(index);
+        }
+    }
+
+    if (bestIndex < 0) {
+        return false;
+    }
+    match = Match{ids[bestIndex], hashes[bestIndex], bestDistance, bestIndex};
+    return true;
+}
+
+}
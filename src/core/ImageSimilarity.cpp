@@ -0,0 +1,275 @@
+#include "core/ImageSimilarity.h"
+#include "core/PixelKernels.h"
+#include "core/TemplateMatcher.h"
+#include <QColor>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace ImageSimilarity {
+
+namespace {
+
+// SSIM稳定常数（L=255，K1=0.01，K2=0.03）
+const double SsimC1 = (0.01 * 255.0) * (0.01 * 255.0);
+const double SsimC2 = (0.03 * 255.0) * (0.03 * 255.0);
+
+const int HistogramShift = 8 - HistogramBitsPerChannel;
+const int HistogramBins = 1 << (3 * HistogramBitsPerChannel);
+
+// 两幅图像转换为32位格式并求出实际比较区域，不可比较时返回false
+bool prepareInputs(const QImage& first, const QImage& second, const QRect& region,
+                   QImage& firstColor, QImage& secondColor, QRect& area)
+{
+    if (first.isNull() || second.isNull() || first.size() != second.size()) {
+        return false;
+    }
+    area = region.intersected(first.rect());
+    if (area.isEmpty()) {
+        return false;
+    }
+    firstColor = TemplateMatcher::toColorBuffer(first);
+    secondColor = TemplateMatcher::toColorBuffer(second);
+    return true;
+}
+
+inline int sampledCount(int length, int step)
+{
+    return (length + step - 1) / step;
+}
+
+inline const QRgb* rowAt(const QImage& image, const QRect& area, int y)
+{
+    return reinterpret_cast<const QRgb*>(image.constScanLine(y)) + area.left();
+}
+
+// 与qGray相同的权重
+inline uint32_t grayOf(QRgb pixel)
+{
+    return (qRed(pixel) * 11 + qGreen(pixel) * 16 + qBlue(pixel) * 5) >> 5;
+}
+
+inline int histogramBin(QRgb pixel)
+{
+    return ((qRed(pixel) >> HistogramShift) << (2 * HistogramBitsPerChannel)) |
+           ((qGreen(pixel) >> HistogramShift) << HistogramBitsPerChannel) |
+           (qBlue(pixel) >> HistogramShift);
+}
+
+// 一行中一个SSIM窗口的累加量
+struct WindowSums {
+    uint64_t first = 0;
+    uint64_t second = 0;
+    uint64_t firstSquared = 0;
+    uint64_t secondSquared = 0;
+    uint64_t product = 0;
+    uint32_t count = 0;
+};
+
+double windowSsim(const WindowSums& sums)
+{
+    const double n = sums.count;
+    const double meanX = sums.first / n;
+    const double meanY = sums.second / n;
+    const double varianceX = std::max(0.0, sums.firstSquared / n - meanX * meanX);
+    const double varianceY = std::max(0.0, sums.secondSquared / n - meanY * meanY);
+    const double covariance = sums.product / n - meanX * meanY;
+
+    return ((2.0 * meanX * meanY + SsimC1) * (2.0 * covariance + SsimC2)) /
+           ((meanX * meanX + meanY * meanY + SsimC1) * (varianceX + varianceY + SsimC2));
+}
+
+}
+
+// ========== 综合 ==========
+
+double compare(const QImage& first, const QImage& second, const QRect& region, const Parameters& parameters)
+{
+    if (parameters.proxyStep < 1 || parameters.ssimWindow < 1 || parameters.maxPsnr <= 0.0) {
+        return 0.0;
+    }
+
+    switch (parameters.metric) {
+        case Metric::ColorDifference:
+            return colorDifference(first, second, region, parameters.proxyStep);
+        case Metric::PeakSignalToNoise: {
+            const double psnr = peakSignalToNoise(meanSquaredError(first, second, region, parameters.proxyStep));
+            return std::min(psnr, parameters.maxPsnr) / parameters.maxPsnr;
+        }
+        case Metric::StructuralSimilarity:
+            // SSIM可能为负，负相关的画面按完全不同处理
+            return std::max(0.0, structuralSimilarity(first, second, region,
+                                                      parameters.proxyStep, parameters.ssimWindow));
+        case Metric::HistogramIntersection:
+            return histogramIntersection(first, second, region, parameters.proxyStep);
+    }
+    return 0.0;
+}
+
+// ========== 单项度量 ==========
+
+double colorDifference(const QImage& first, const QImage& second, const QRect& region, int proxyStep)
+{
+    QImage a, b;
+    QRect area;
+    if (proxyStep < 1 || !prepareInputs(first, second, region, a, b, area)) {
+        return 0.0;
+    }
+
+    const int columns = sampledCount(area.width(), proxyStep);
+    uint64_t difference = 0;
+    int rows = 0;
+    for (int y = area.top(); y <= area.bottom(); y += proxyStep, ++rows) {
+        const QRgb* rowA = rowAt(a, area, y);
+        const QRgb* rowB = rowAt(b, area, y);
+        if (proxyStep == 1) {
+            difference += PixelKernels::sadArgb(rowA, rowB, columns);
+            continue;
+        }
+        uint32_t rowDifference = 0;
+        for (int i = 0; i < columns; ++i) {
+            const QRgb p = rowA[i * proxyStep];
+            const QRgb q = rowB[i * proxyStep];
+            rowDifference += std::abs(qRed(p) - qRed(q)) + std::abs(qGreen(p) - qGreen(q)) +
+                             std::abs(qBlue(p) - qBlue(q));
+        }
+        difference += rowDifference;
+    }
+
+    const double samples = static_cast<double>(columns) * rows;
+    return 1.0 - static_cast<double>(difference) / (3.0 * 255.0 * samples);
+}
+
+double meanSquaredError(const QImage& first, const QImage& second, const QRect& region, int proxyStep)
+{
+    QImage a, b;
+    QRect area;
+    if (proxyStep < 1 || !prepareInputs(first, second, region, a, b, area)) {
+        return 255.0 * 255.0;
+    }
+
+    const int columns = sampledCount(area.width(), proxyStep);
+    uint64_t squaredError = 0;
+    int rows = 0;
+    for (int y = area.top(); y <= area.bottom(); y += proxyStep, ++rows) {
+        const QRgb* rowA = rowAt(a, area, y);
+        const QRgb* rowB = rowAt(b, area, y);
+        if (proxyStep == 1) {
+            squaredError += PixelKernels::ssdArgb(rowA, rowB, columns);
+            continue;
+        }
+        uint64_t rowError = 0;
+        for (int i = 0; i < columns; ++i) {
+            const QRgb p = rowA[i * proxyStep];
+            const QRgb q = rowB[i * proxyStep];
+            const int dr = qRed(p) - qRed(q);
+            const int dg = qGreen(p) - qGreen(q);
+            const int db = qBlue(p) - qBlue(q);
+            rowError += static_cast<uint32_t>(dr * dr + dg * dg + db * db);
+        }
+        squaredError += rowError;
+    }
+
+    const double samples = static_cast<double>(columns) * rows;
+    return static_cast<double>(squaredError) / (3.0 * samples);
+}
+
+double peakSignalToNoise(double mse)
+{
+    if (mse <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+double structuralSimilarity(const QImage& first, const QImage& second, const QRect& region,
+                            int proxyStep, int window)
+{
+    QImage a, b;
+    QRect area;
+    if (proxyStep < 1 || window < 1 || !prepareInputs(first, second, region, a, b, area)) {
+        return 0.0;
+    }
+
+    // 先按列累加window行（或到达末行）的灰度统计量，再把每window列合并为一个窗口结算
+    const int columns = sampledCount(area.width(), proxyStep);
+    std::vector<uint32_t> grayA(columns), grayB(columns);
+    std::vector<uint32_t> sumX(columns), sumY(columns), sumXX(columns), sumYY(columns), sumXY(columns);
+
+    double total = 0.0;
+    int64_t windows = 0;
+    int bandRows = 0;
+    for (int y = area.top(); y <= area.bottom(); y += proxyStep) {
+        const QRgb* rowA = rowAt(a, area, y);
+        const QRgb* rowB = rowAt(b, area, y);
+        for (int i = 0; i < columns; ++i) {
+            grayA[i] = grayOf(rowA[i * proxyStep]);
+            grayB[i] = grayOf(rowB[i * proxyStep]);
+        }
+        for (int i = 0; i < columns; ++i) {
+            const uint32_t x = grayA[i];
+            const uint32_t yValue = grayB[i];
+            sumX[i] += x;
+            sumY[i] += yValue;
+            sumXX[i] += x * x;
+            sumYY[i] += yValue * yValue;
+            sumXY[i] += x * yValue;
+        }
+
+        if (++bandRows < window && y + proxyStep <= area.bottom()) {
+            continue;
+        }
+        for (int begin = 0; begin < columns; begin += window) {
+            const int end = std::min(columns, begin + window);
+            WindowSums sums;
+            for (int i = begin; i < end; ++i) {
+                sums.first += sumX[i];
+                sums.second += sumY[i];
+                sums.firstSquared += sumXX[i];
+                sums.secondSquared += sumYY[i];
+                sums.product += sumXY[i];
+            }
+            sums.count = static_cast<uint32_t>(bandRows) * (end - begin);
+            total += windowSsim(sums);
+            ++windows;
+        }
+        for (std::vector<uint32_t>* sum : {&sumX, &sumY, &sumXX, &sumYY, &sumXY}) {
+            std::fill(sum->begin(), sum->end(), 0u);
+        }
+        bandRows = 0;
+    }
+
+    return total / static_cast<double>(windows);
+}
+
+double histogramIntersection(const QImage& first, const QImage& second, const QRect& region, int proxyStep)
+{
+    QImage a, b;
+    QRect area;
+    if (proxyStep < 1 || !prepareInputs(first, second, region, a, b, area)) {
+        return 0.0;
+    }
+
+    const int columns = sampledCount(area.width(), proxyStep);
+    std::vector<uint32_t> histogramA(HistogramBins, 0);
+    std::vector<uint32_t> histogramB(HistogramBins, 0);
+    uint64_t samples = 0;
+    for (int y = area.top(); y <= area.bottom(); y += proxyStep) {
+        const QRgb* rowA = rowAt(a, area, y);
+        const QRgb* rowB = rowAt(b, area, y);
+        for (int i = 0; i < columns; ++i) {
+            ++histogramA[histogramBin(rowA[i * proxyStep])];
+            ++histogramB[histogramBin(rowB[i * proxyStep])];
+        }
+        samples += columns;
+    }
+
+    uint64_t common = 0;
+    for (int bin = 0; bin < HistogramBins; ++bin) {
+        common += std::min(histogramA[bin], histogramB[bin]);
+    }
+    return static_cast<double>(common) / static_cast<double>(samples);
+}
+
+}
@@ -0,0 +1,186 @@
+#include "core/IntegralImage.h"
+#include "core/PixelKernels.h"
+#include "core/TaskPool.h"
+#include "core/TemplateMatcher.h"
+#include <QColor>
+#include <algorithm>
+#include <functional>
+
+namespace IntegralImage {
+
+namespace {
+
+// 每个线程至少处理的行数，行数太少时线程开销超过收益
+const int MinRowsPerBand = 64;
+
+// 把第y行（0起）的8位数据写入buffer，或直接返回原始数据
+using RowSource = std::function<const uint8_t*(int y, uint8_t* buffer)>;
+
+Tables buildFromRows(int width, int height, const RowSource& rowSource, int threadCount)
+{
+    Tables tables;
+    if (width <= 0 || height <= 0) {
+        return tables;
+    }
+    tables.width = width;
+    tables.height = height;
+
+    const size_t stride = static_cast<size_t>(width) + 1;
+    tables.sum.assign(stride * (height + 1), 0);
+    tables.squaredSum.assign(stride * (height + 1), 0);
+
+    uint32_t* const sumBase = tables.sum.data();
+    uint64_t* const squaredBase = tables.squaredSum.data();
+    auto sumRow = [sumBase, stride](int row) { return sumBase + static_cast<size_t>(row) * stride + 1; };
+    auto squaredRow = [squaredBase, stride](int row) { return squaredBase + static_cast<size_t>(row) * stride + 1; };
+
+    // 按行分段，每段先从0开始独立累加
+    const int bandCount = std::max(1, std::min(TaskPool::nestedThreadCount(threadCount), height / MinRowsPerBand));
+    std::vector<int> bandStart(bandCount + 1);
+    for (int band = 0; band <= bandCount; ++band) {
+        bandStart[band] = static_cast<int>(static_cast<int64_t>(height) * band / bandCount);
+    }
+
+    auto runBands = [bandCount](const std::function<void(int)>& body) {
+        TaskPool::shared().parallelFor(bandCount, body);
+    };
+
+    runBands([&](int band) {
+        std::vector<uint8_t> buffer(width);
+        for (int y = bandStart[band]; y < bandStart[band + 1]; ++y) {
+            // 每段第一行的"上一行"取全0的第0行
+            const int above = y == bandStart[band] ? 0 : y;
+            PixelKernels::integralRowU8(rowSource(y, buffer.data()), width, sumRow(above), squaredRow(above),
+                                        sumRow(y + 1), squaredRow(y + 1));
+        }
+    });
+    if (bandCount == 1) {
+        return tables;
+    }
+
+    // 各段末行依次加上前一段末行的最终值，之后每段其余各行可以并行修正
+    for (int band = 1; band < bandCount; ++band) {
+        const int previousLast = bandStart[band];
+        const int last = bandStart[band + 1];
+        uint32_t* sum = sumRow(last);
+        uint64_t* squared = squaredRow(last);
+        const uint32_t* offset = sumRow(previousLast);
+        const uint64_t* squaredOffset = squaredRow(previousLast);
+        for (int x = 0; x < width; ++x) {
+            sum[x] += offset[x];
+            squared[x] += squaredOffset[x];
+        }
+    }
+    runBands([&](int band) {
+        if (band == 0) {
+            return;
+        }
+        const uint32_t* offset = sumRow(bandStart[band]);
+        const uint64_t* squaredOffset = squaredRow(bandStart[band]);
+        for (int row = bandStart[band] + 1; row < bandStart[band + 1]; ++row) {
+            uint32_t* sum = sumRow(row);
+            uint64_t* squared = squaredRow(row);
+            for (int x = 0; x < width; ++x) {
+                sum[x] += offset[x];
+                squared[x] += squaredOffset[x];
+            }
+        }
+    });
+    return tables;
+}
+
+}
+
+// ========== 查询 ==========
+
+int64_t Tables::rectSum(int x, int y, int w, int h) const
+{
+    const size_t stride = static_cast<size_t>(width) + 1;
+    const uint32_t* top = sum.data() + static_cast<size_t>(y) * stride;
+    const uint32_t* bottom = sum.data() + static_cast<size_t>(y + h) * stride;
+    // 按2^32取模相减，矩形的真实和小于2^32时结果准确
+    return static_cast<uint32_t>(bottom[x + w] - bottom[x] - top[x + w] + top[x]);
+}
+
+int64_t Tables::rectSquaredSum(int x, int y, int w, int h) const
+{
+    const size_t stride = static_cast<size_t>(width) + 1;
+    const uint64_t* top = squaredSum.data() + static_cast<size_t>(y) * stride;
+    const uint64_t* bottom = squaredSum.data() + static_cast<size_t>(y + h) * stride;
+    return static_cast<int64_t>(bottom[x + w] - bottom[x] - top[x + w] + top[x]);
+}
+
+double Tables::rectMean(const QRect& rect) const
+{
+    const QRect area = rect.intersected(QRect(0, 0, width, height));
+    if (area.isEmpty()) {
+        return 0.0;
+    }
+    const double count = static_cast<double>(area.width()) * area.height();
+    return rectSum(area.x(), area.y(), area.width(), area.height()) / count;
+}
+
+double Tables::rectVariance(const QRect& rect) const
+{
+    const QRect area = rect.intersected(QRect(0, 0, width, height));
+    if (area.isEmpty()) {
+        return 0.0;
+    }
+    const double count = static_cast<double>(area.width()) * area.height();
+    const double mean = rectSum(area.x(), area.y(), area.width(), area.height()) / count;
+    const double squaredMean = rectSquaredSum(area.x(), area.y(), area.width(), area.height()) / count;
+    return std::max(0.0, squaredMean - mean * mean);
+}
+
+// ========== 构建 ==========
+
+Tables build(const uint8_t* pixels, int width, int height, size_t stride, int threadCount)
+{
+    if (!pixels) {
+        return Tables();
+    }
+    return buildFromRows(width, height, [pixels, stride](int y, uint8_t*) {
+        return pixels + static_cast<size_t>(y) * stride;
+    }, threadCount);
+}
+
+Tables build(const QImage& image, Channel channel, int threadCount)
+{
+    if (image.isNull()) {
+        return Tables();
+    }
+    if (image.format() == QImage::Format_Grayscale8 && channel == Channel::Gray) {
+        return build(image.constBits(), image.width(), image.height(), image.bytesPerLine(), threadCount);
+    }
+
+    const QImage color = TemplateMatcher::toColorBuffer(image);
+    const int width = color.width();
+    return buildFromRows(width, color.height(), [&color, width, channel](int y, uint8_t* buffer) {
+        const QRgb* src = reinterpret_cast<const QRgb*>(color.constScanLine(y));
+        switch (channel) {
+            case Channel::Gray:
+                for (int x = 0; x < width; ++x) {
+                    buffer[x] = static_cast<uint8_t>(qGray(src[x]));
+                }
+                break;
+            case Channel::Red:
+                for (int x = 0; x < width; ++x) {
+                    buffer[x] = static_cast<uint8_t>(qRed(src[x]));
+                }
+                break;
+            case Channel::Green:
+                for (int x = 0; x < width; ++x) {
+                    buffer[x] = static_cast<uint8_t>(qGreen(src[x]));
+                }
+                break;
+            case Channel::Blue:
+                for (int x = 0; x < width; ++x) {
+                    buffer[x] = static_cast<uint8_t>(qBlue(src[x]));
+                }
+                break;
+        }
+        return static_cast<const uint8_t*>(buffer);
+    }, threadCount);
+}
+
+}
@@ -0,0 +1,1495 @@
+#include "core/PixelKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PIXELKERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang需要为单个函数开启指令集，MSVC可直接使用内建函数
+#if defined(__GNUC__) || defined(__clang__)
+#define PIXELKERNELS_TARGET(features) __attribute__((target(features)))
+#else
+#define PIXELKERNELS_TARGET(features)
+#endif
+
+namespace PixelKernels {
+
+namespace {
+
+constexpr uint32_t RgbMask = 0x00FFFFFFu;
+
+// ========== 标量实现 ==========
+
+uint32_t dotU8Scalar(const uint8_t* a, const uint8_t* b, int count)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < count; ++i) {
+        sum += static_cast<uint32_t>(a[i]) * b[i];
+    }
+    return sum;
+}
+
+uint32_t sadU8Scalar(const uint8_t* a, const uint8_t* b, int count)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < count; ++i) {
+        sum += static_cast<uint32_t>(std::abs(a[i] - b[i]));
+    }
+    return sum;
+}
+
+uint32_t ssdU8Scalar(const uint8_t* a, const uint8_t* b, int count)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < count; ++i) {
+        const int diff = a[i] - b[i];
+        sum += static_cast<uint32_t>(diff * diff);
+    }
+    return sum;
+}
+
+uint32_t sadArgbScalar(const uint32_t* a, const uint32_t* b, int count)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < count; ++i) {
+        sum += std::abs(static_cast<int>((a[i] >> 16) & 0xFF) - static_cast<int>((b[i] >> 16) & 0xFF))
+             + std::abs(static_cast<int>((a[i] >> 8) & 0xFF) - static_cast<int>((b[i] >> 8) & 0xFF))
+             + std::abs(static_cast<int>(a[i] & 0xFF) - static_cast<int>(b[i] & 0xFF));
+    }
+    return sum;
+}
+
+uint64_t ssdArgbScalar(const uint32_t* a, const uint32_t* b, int count)
+{
+    uint64_t sum = 0;
+    for (int i = 0; i < count; ++i) {
+        const int dr = static_cast<int>((a[i] >> 16) & 0xFF) - static_cast<int>((b[i] >> 16) & 0xFF);
+        const int dg = static_cast<int>((a[i] >> 8) & 0xFF) - static_cast<int>((b[i] >> 8) & 0xFF);
+        const int db = static_cast<int>(a[i] & 0xFF) - static_cast<int>(b[i] & 0xFF);
+        sum += static_cast<uint64_t>(dr * dr + dg * dg + db * db);
+    }
+    return sum;
+}
+
+uint64_t dotArgbScalar(const uint32_t* a, const uint32_t* b, int count)
+{
+    uint64_t sum = 0;
+    for (int i = 0; i < count; ++i) {
+        sum += ((a[i] >> 16) & 0xFF) * ((b[i] >> 16) & 0xFF)
+             + ((a[i] >> 8) & 0xFF) * ((b[i] >> 8) & 0xFF)
+             + (a[i] & 0xFF) * (b[i] & 0xFF);
+    }
+    return sum;
+}
+
+// 积分图一行：从下标start开始，carry为start之前的前缀和
+void integralRowTail(const uint8_t* src, int start, int count, const uint32_t* sumAbove, const uint64_t* squaredAbove,
+                     uint32_t* sum, uint64_t* squaredSum, uint32_t carry, uint64_t squaredCarry)
+{
+    for (int i = start; i < count; ++i) {
+        const uint32_t value = src[i];
+        carry += value;
+        squaredCarry += value * value;
+        sum[i] = sumAbove[i] + carry;
+        squaredSum[i] = squaredAbove[i] + squaredCarry;
+    }
+}
+
+void integralRowU8Scalar(const uint8_t* src, int count, const uint32_t* sumAbove, const uint64_t* squaredAbove,
+                         uint32_t* sum, uint64_t* squaredSum)
+{
+    integralRowTail(src, 0, count, sumAbove, squaredAbove, sum, squaredSum, 0, 0);
+}
+
+// 相邻像素对：从下标start开始，最后一项的高16位为0
+void pairRowTail(const uint8_t* src, int start, int count, uint32_t* pairs)
+{
+    for (int i = start; i < count; ++i) {
+        const uint32_t next = i + 1 < count ? src[i + 1] : 0u;
+        pairs[i] = src[i] | (next << 16);
+    }
+}
+
+// 行互相关：从位置start开始逐个累加，每个像素对贡献两个抽头（模板宽度为奇数时最后一对的高16位为0）
+void correlateRowTail(const uint32_t* sourcePairs, int start, int count, const uint32_t* templatePairs, int taps,
+                      uint32_t* acc)
+{
+    for (int i = start; i < count; ++i) {
+        uint32_t sum = 0;
+        for (int k = 0; k < taps; k += 2) {
+            const uint32_t s = sourcePairs[i + k];
+            const uint32_t t = templatePairs[k];
+            sum += (s & 0xFFFF) * (t & 0xFFFF) + (s >> 16) * (t >> 16);
+        }
+        acc[i] += sum;
+    }
+}
+
+void pairRowU8Scalar(const uint8_t* src, int count, uint32_t* pairs)
+{
+    pairRowTail(src, 0, count, pairs);
+}
+
+void correlateRowU8Scalar(const uint32_t* sourcePairs, int count, const uint32_t* templatePairs, int taps, uint32_t* acc)
+{
+    correlateRowTail(sourcePairs, 0, count, templatePairs, taps, acc);
+}
+
+// 不使用分支，颜色随机分布时避免分支预测失败
+inline bool inRgbRange(uint32_t pixel, uint32_t low, uint32_t high)
+{
+    bool inside = true;
+    for (int shift = 0; shift <= 16; shift += 8) {
+        const uint32_t value = (pixel >> shift) & 0xFF;
+        inside &= (value >= ((low >> shift) & 0xFF)) & (value <= ((high >> shift) & 0xFF));
+    }
+    return inside;
+}
+
+inline bool inHsvRange(uint32_t pixel, const HsvRange& range)
+{
+    const int r = (pixel >> 16) & 0xFF;
+    const int g = (pixel >> 8) & 0xFF;
+    const int b = pixel & 0xFF;
+    const int maxChannel = std::max(r, std::max(g, b));
+    const int delta = maxChannel - std::min(r, std::min(g, b));
+
+    if (maxChannel < range.valueLow || maxChannel > range.valueHigh) {
+        return false;
+    }
+    if (delta * 255 < range.saturationLow * maxChannel || delta * 255 > range.saturationHigh * maxChannel) {
+        return false;
+    }
+    if (delta == 0) {
+        return range.saturationLow == 0;
+    }
+
+    float hue;
+    if (maxChannel == r) {
+        hue = static_cast<float>(g - b) / static_cast<float>(delta);
+        if (hue < 0.0f) {
+            hue += 6.0f;
+        }
+    } else if (maxChannel == g) {
+        hue = static_cast<float>(b - r) / static_cast<float>(delta) + 2.0f;
+    } else {
+        hue = static_cast<float>(r - g) / static_cast<float>(delta) + 4.0f;
+    }
+    return range.hueLow <= range.hueHigh ? (hue >= range.hueLow && hue < range.hueHigh)
+                                         : (hue >= range.hueLow || hue < range.hueHigh);
+}
+
+void rgbRangeMaskTail(const uint32_t* src, int start, int count, uint32_t low, uint32_t high, uint8_t* mask)
+{
+    for (int i = start; i < count; ++i) {
+        mask[i] = inRgbRange(src[i], low, high) ? 255 : 0;
+    }
+}
+
+void hsvRangeMaskTail(const uint32_t* src, int start, int count, const HsvRange& range, uint8_t* mask)
+{
+    for (int i = start; i < count; ++i) {
+        mask[i] = inHsvRange(src[i], range) ? 255 : 0;
+    }
+}
+
+void rgbRangeMaskScalar(const uint32_t* src, int count, uint32_t low, uint32_t high, uint8_t* mask)
+{
+    rgbRangeMaskTail(src, 0, count, low, high, mask);
+}
+
+void hsvRangeMaskScalar(const uint32_t* src, int count, const HsvRange& range, uint8_t* mask)
+{
+    hsvRangeMaskTail(src, 0, count, range, mask);
+}
+
+inline uint32_t packConvolution(int32_t blue, int32_t green, int32_t red, int32_t alpha)
+{
+    const int32_t round = 1 << (ConvolutionShift - 1);
+    auto channel = [round](int32_t acc) {
+        return static_cast<uint32_t>(std::clamp((acc + round) >> ConvolutionShift, 0, 255));
+    };
+    return channel(blue) | (channel(green) << 8) | (channel(red) << 16) | (channel(alpha) << 24);
+}
+
+void convolveRowArgbScalar(const uint32_t* src, int count, const int16_t* weights, int taps, uint32_t* dst, size_t dstStride)
+{
+    for (int i = 0; i < count; ++i) {
+        int32_t blue = 0, green = 0, red = 0, alpha = 0;
+        for (int k = 0; k < taps; ++k) {
+            const uint32_t pixel = src[i + k];
+            const int32_t weight = weights[k];
+            blue += static_cast<int32_t>(pixel & 0xFF) * weight;
+            green += static_cast<int32_t>((pixel >> 8) & 0xFF) * weight;
+            red += static_cast<int32_t>((pixel >> 16) & 0xFF) * weight;
+            alpha += static_cast<int32_t>(pixel >> 24) * weight;
+        }
+        dst[i * dstStride] = packConvolution(blue, green, red, alpha);
+    }
+}
+
+void sharpenRowTail(const uint32_t* above, const uint32_t* row, const uint32_t* below, int start, int count, int weight,
+                    uint32_t* dst)
+{
+    for (int i = start; i < count; ++i) {
+        uint32_t pixel = row[i] & 0xFF000000u;
+        for (int shift = 0; shift <= 16; shift += 8) {
+            auto channel = [shift](uint32_t p) { return static_cast<int>((p >> shift) & 0xFF); };
+            const int center = channel(row[i]);
+            const int laplacian = 4 * center - channel(row[i - 1]) - channel(row[i + 1]) - channel(above[i]) - channel(below[i]);
+            const int value = std::clamp((256 * center + weight * laplacian) >> 8, 0, 255);
+            pixel |= static_cast<uint32_t>(value) << shift;
+        }
+        dst[i] = pixel;
+    }
+}
+
+void sharpenRowArgbScalar(const uint32_t* above, const uint32_t* row, const uint32_t* below, int count, int weight, uint32_t* dst)
+{
+    sharpenRowTail(above, row, below, 0, count, weight, dst);
+}
+
+void sharpenRowU8Tail(const uint8_t* above, const uint8_t* row, const uint8_t* below, int start, int count, int weight,
+                      uint8_t* dst)
+{
+    for (int i = start; i < count; ++i) {
+        const int center = row[i];
+        const int laplacian = 4 * center - row[i - 1] - row[i + 1] - above[i] - below[i];
+        dst[i] = static_cast<uint8_t>(std::clamp((256 * center + weight * laplacian) >> 8, 0, 255));
+    }
+}
+
+void sharpenRowU8Scalar(const uint8_t* above, const uint8_t* row, const uint8_t* below, int count, int weight, uint8_t* dst)
+{
+    sharpenRowU8Tail(above, row, below, 0, count, weight, dst);
+}
+
+inline uint32_t grayPixel(int value)
+{
+    return 0xFF000000u | (static_cast<uint32_t>(value) * 0x010101u);
+}
+
+void sobelRowTail(const uint8_t* above, const uint8_t* row, const uint8_t* below, int start, int count, double intensity,
+                  uint32_t* dst)
+{
+    for (int i = start; i < count; ++i) {
+        const int gx = (above[i + 1] - above[i - 1]) + 2 * (row[i + 1] - row[i - 1]) + (below[i + 1] - below[i - 1]);
+        const int gy = (below[i - 1] + 2 * below[i] + below[i + 1]) - (above[i - 1] + 2 * above[i] + above[i + 1]);
+        const double magnitude = std::sqrt(static_cast<double>(gx * gx + gy * gy)) * intensity;
+        dst[i] = grayPixel(std::clamp(static_cast<int>(magnitude), 0, 255));
+    }
+}
+
+void sobelRowGrayScalar(const uint8_t* above, const uint8_t* row, const uint8_t* below, int count, double intensity, uint32_t* dst)
+{
+    sobelRowTail(above, row, below, 0, count, intensity, dst);
+}
+
+#ifdef PIXELKERNELS_X86
+
+// ========== SSE4.1实现 ==========
+
+PIXELKERNELS_TARGET("sse4.1")
+inline uint32_t horizontalSum32(__m128i v)
+{
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+inline uint64_t horizontalSum64(__m128i v)
+{
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(v)) + static_cast<uint64_t>(_mm_extract_epi64(v, 1));
+}
+
+// 16个字节两两相乘并相加为4个32位和
+PIXELKERNELS_TARGET("sse4.1")
+inline __m128i maddBytes(__m128i a, __m128i b)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i low = _mm_madd_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+    const __m128i high = _mm_madd_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+    return _mm_add_epi32(low, high);
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+inline __m128i absDiffBytes(__m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+uint32_t dotU8Sse41(const uint8_t* a, const uint8_t* b, int count)
+{
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        acc = _mm_add_epi32(acc, maddBytes(va, vb));
+    }
+    return horizontalSum32(acc) + dotU8Scalar(a + i, b + i, count - i);
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+uint32_t sadU8Sse41(const uint8_t* a, const uint8_t* b, int count)
+{
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+    }
+    return static_cast<uint32_t>(horizontalSum64(acc)) + sadU8Scalar(a + i, b + i, count - i);
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+uint32_t ssdU8Sse41(const uint8_t* a, const uint8_t* b, int count)
+{
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        const __m128i diff = absDiffBytes(va, vb);
+        acc = _mm_add_epi32(acc, maddBytes(diff, diff));
+    }
+    return horizontalSum32(acc) + ssdU8Scalar(a + i, b + i, count - i);
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+uint32_t sadArgbSse41(const uint32_t* a, const uint32_t* b, int count)
+{
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(RgbMask));
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i va = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), mask);
+        const __m128i vb = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)), mask);
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+    }
+    return static_cast<uint32_t>(horizontalSum64(acc)) + sadArgbScalar(a + i, b + i, count - i);
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+uint64_t ssdArgbSse41(const uint32_t* a, const uint32_t* b, int count)
+{
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(RgbMask));
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i va = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), mask);
+        const __m128i vb = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)), mask);
+        const __m128i diff = absDiffBytes(va, vb);
+        // 每个32位通道最多累加 2*2*65025，为避免溢出按64位累加
+        acc = _mm_add_epi64(acc, _mm_cvtepu32_epi64(_mm_shuffle_epi32(maddBytes(diff, diff), _MM_SHUFFLE(1, 0, 3, 2))));
+        acc = _mm_add_epi64(acc, _mm_cvtepu32_epi64(maddBytes(diff, diff)));
+    }
+    return horizontalSum64(acc) + ssdArgbScalar(a + i, b + i, count - i);
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+uint64_t dotArgbSse41(const uint32_t* a, const uint32_t* b, int count)
+{
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(RgbMask));
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i va = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), mask);
+        const __m128i vb = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)), mask);
+        const __m128i products = maddBytes(va, vb);
+        acc = _mm_add_epi64(acc, _mm_cvtepu32_epi64(products));
+        acc = _mm_add_epi64(acc, _mm_cvtepu32_epi64(_mm_shuffle_epi32(products, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
+    return horizontalSum64(acc) + dotArgbScalar(a + i, b + i, count - i);
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+void integralRowU8Sse41(const uint8_t* src, int count, const uint32_t* sumAbove, const uint64_t* squaredAbove,
+                        uint32_t* sum, uint64_t* squaredSum)
+{
+    // 每次4个像素：寄存器内移位相加得到前缀和，再加上之前的进位和上一行
+    __m128i carry = _mm_setzero_si128();
+    __m128i squaredCarry = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        int packed;
+        std::memcpy(&packed, src + i, sizeof(packed));
+        const __m128i values = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+
+        __m128i prefix = _mm_add_epi32(values, _mm_slli_si128(values, 4));
+        prefix = _mm_add_epi32(prefix, _mm_slli_si128(prefix, 8));
+        prefix = _mm_add_epi32(prefix, carry);
+        carry = _mm_shuffle_epi32(prefix, _MM_SHUFFLE(3, 3, 3, 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sum + i),
+                         _mm_add_epi32(prefix, _mm_loadu_si128(reinterpret_cast<const __m128i*>(sumAbove + i))));
+
+        // 4个平方的前缀和不超过32位，扩展为64位后再累加进位
+        const __m128i squares = _mm_madd_epi16(values, values);
+        __m128i squaredPrefix = _mm_add_epi32(squares, _mm_slli_si128(squares, 4));
+        squaredPrefix = _mm_add_epi32(squaredPrefix, _mm_slli_si128(squaredPrefix, 8));
+        const __m128i low = _mm_add_epi64(_mm_cvtepu32_epi64(squaredPrefix), squaredCarry);
+        const __m128i high = _mm_add_epi64(_mm_cvtepu32_epi64(_mm_srli_si128(squaredPrefix, 8)), squaredCarry);
+        squaredCarry = _mm_unpackhi_epi64(high, high);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(squaredSum + i),
+                         _mm_add_epi64(low, _mm_loadu_si128(reinterpret_cast<const __m128i*>(squaredAbove + i))));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(squaredSum + i + 2),
+                         _mm_add_epi64(high, _mm_loadu_si128(reinterpret_cast<const __m128i*>(squaredAbove + i + 2))));
+    }
+    integralRowTail(src, i, count, sumAbove, squaredAbove, sum, squaredSum,
+                    static_cast<uint32_t>(_mm_cvtsi128_si32(carry)), static_cast<uint64_t>(_mm_cvtsi128_si64(squaredCarry)));
+}
+
+// 最后一项没有下一个像素，由标量部分处理
+PIXELKERNELS_TARGET("sse4.1")
+void pairRowU8Sse41(const uint8_t* src, int count, uint32_t* pairs)
+{
+    int i = 0;
+    for (; i + 5 <= count; i += 4) {
+        int first;
+        int second;
+        std::memcpy(&first, src + i, sizeof(first));
+        std::memcpy(&second, src + i + 1, sizeof(second));
+        const __m128i low = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(first));
+        const __m128i high = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(second));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pairs + i), _mm_or_si128(low, _mm_slli_epi32(high, 16)));
+    }
+    pairRowTail(src, i, count, pairs);
+}
+
+// 每次16个位置：4个累加寄存器在整行抽头上保持不变，每个抽头对一次_mm_madd_epi16得到4个位置的两项乘积和
+PIXELKERNELS_TARGET("sse4.1")
+void correlateRowU8Sse41(const uint32_t* sourcePairs, int count, const uint32_t* templatePairs, int taps, uint32_t* acc)
+{
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i acc0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i acc1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i + 4));
+        __m128i acc2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i + 8));
+        __m128i acc3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i + 12));
+        for (int k = 0; k < taps; k += 2) {
+            const __m128i weights = _mm_set1_epi32(static_cast<int>(templatePairs[k]));
+            const uint32_t* s = sourcePairs + i + k;
+            acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s)), weights));
+            acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 4)), weights));
+            acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 8)), weights));
+            acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 12)), weights));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), acc0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i + 4), acc1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i + 8), acc2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i + 12), acc3);
+    }
+    for (; i + 4 <= count; i += 4) {
+        __m128i sum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        for (int k = 0; k < taps; k += 2) {
+            const __m128i weights = _mm_set1_epi32(static_cast<int>(templatePairs[k]));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePairs + i + k)),
+                                                    weights));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), sum);
+    }
+    correlateRowTail(sourcePairs, i, count, templatePairs, taps, acc);
+}
+
+// 4组各4个32位的全1/全0结果压缩为16个字节
+PIXELKERNELS_TARGET("sse4.1")
+inline void storeMask(uint8_t* mask, __m128i a, __m128i b, __m128i c, __m128i d)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(mask), _mm_packs_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+}
+
+// 每个像素的R/G/B都满足low <= value <= high时对应32位为全1（low的alpha为0，high的alpha为255）
+PIXELKERNELS_TARGET("sse4.1")
+inline __m128i rgbRangeTest(__m128i pixels, __m128i low, __m128i high)
+{
+    const __m128i inside = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(pixels, low), pixels),
+                                         _mm_cmpeq_epi8(_mm_min_epu8(pixels, high), pixels));
+    return _mm_cmpeq_epi32(inside, _mm_set1_epi32(-1));
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+void rgbRangeMaskSse41(const uint32_t* src, int count, uint32_t low, uint32_t high, uint8_t* mask)
+{
+    const __m128i vlow = _mm_set1_epi32(static_cast<int>(low & RgbMask));
+    const __m128i vhigh = _mm_set1_epi32(static_cast<int>(high | ~RgbMask));
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i* p = reinterpret_cast<const __m128i*>(src + i);
+        storeMask(mask + i, rgbRangeTest(_mm_loadu_si128(p), vlow, vhigh), rgbRangeTest(_mm_loadu_si128(p + 1), vlow, vhigh),
+                  rgbRangeTest(_mm_loadu_si128(p + 2), vlow, vhigh), rgbRangeTest(_mm_loadu_si128(p + 3), vlow, vhigh));
+    }
+    rgbRangeMaskTail(src, i, count, low, high, mask);
+}
+
+// 与inHsvRange相同的判断，4个像素一组
+PIXELKERNELS_TARGET("sse4.1")
+inline __m128i hsvRangeTest(__m128i pixels, const HsvRange& range)
+{
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    const __m128i r = _mm_and_si128(_mm_srli_epi32(pixels, 16), byteMask);
+    const __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 8), byteMask);
+    const __m128i b = _mm_and_si128(pixels, byteMask);
+    const __m128i maxChannel = _mm_max_epi32(r, _mm_max_epi32(g, b));
+    const __m128i delta = _mm_sub_epi32(maxChannel, _mm_min_epi32(r, _mm_min_epi32(g, b)));
+
+    // 明度与饱和度，不满足的位为全1
+    __m128i reject = _mm_or_si128(_mm_cmplt_epi32(maxChannel, _mm_set1_epi32(range.valueLow)),
+                                  _mm_cmpgt_epi32(maxChannel, _mm_set1_epi32(range.valueHigh)));
+    // 各分量不超过255，高16位为0，可用16位乘加代替较慢的32位乘法
+    const __m128i scaledDelta = _mm_sub_epi32(_mm_slli_epi32(delta, 8), delta);
+    reject = _mm_or_si128(reject, _mm_cmplt_epi32(scaledDelta, _mm_madd_epi16(maxChannel, _mm_set1_epi32(range.saturationLow))));
+    reject = _mm_or_si128(reject, _mm_cmpgt_epi32(scaledDelta, _mm_madd_epi16(maxChannel, _mm_set1_epi32(range.saturationHigh))));
+    const __m128i achromatic = _mm_cmpeq_epi32(delta, _mm_setzero_si128());
+    if (range.saturationLow > 0) {
+        reject = _mm_or_si128(reject, achromatic);
+    }
+
+    // 色相：按最大分量所在扇区选择分子和偏移，无色相的像素除法结果无效，最后直接放行
+    const __m128i redMax = _mm_cmpeq_epi32(maxChannel, r);
+    const __m128i greenMax = _mm_andnot_si128(redMax, _mm_cmpeq_epi32(maxChannel, g));
+    __m128i numerator = _mm_blendv_epi8(_mm_sub_epi32(r, g), _mm_sub_epi32(b, r), greenMax);
+    numerator = _mm_blendv_epi8(numerator, _mm_sub_epi32(g, b), redMax);
+    __m128 hue = _mm_div_ps(_mm_cvtepi32_ps(numerator), _mm_cvtepi32_ps(delta));
+    __m128 offset = _mm_blendv_ps(_mm_set1_ps(4.0f), _mm_set1_ps(2.0f), _mm_castsi128_ps(greenMax));
+    offset = _mm_blendv_ps(offset, _mm_and_ps(_mm_cmplt_ps(hue, _mm_setzero_ps()), _mm_set1_ps(6.0f)),
+                           _mm_castsi128_ps(redMax));
+    hue = _mm_add_ps(hue, offset);
+
+    const __m128 aboveLow = _mm_cmpge_ps(hue, _mm_set1_ps(range.hueLow));
+    const __m128 belowHigh = _mm_cmplt_ps(hue, _mm_set1_ps(range.hueHigh));
+    const __m128 inHue = range.hueLow <= range.hueHigh ? _mm_and_ps(aboveLow, belowHigh) : _mm_or_ps(aboveLow, belowHigh);
+    const __m128i hueMatch = _mm_or_si128(_mm_castps_si128(inHue), achromatic);
+    return _mm_andnot_si128(reject, hueMatch);
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+void hsvRangeMaskSse41(const uint32_t* src, int count, const HsvRange& range, uint8_t* mask)
+{
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i* p = reinterpret_cast<const __m128i*>(src + i);
+        storeMask(mask + i, hsvRangeTest(_mm_loadu_si128(p), range), hsvRangeTest(_mm_loadu_si128(p + 1), range),
+                  hsvRangeTest(_mm_loadu_si128(p + 2), range), hsvRangeTest(_mm_loadu_si128(p + 3), range));
+    }
+    hsvRangeMaskTail(src, i, count, range, mask);
+}
+
+// 相邻两个像素的通道交错为16位：[a.b, b.b, a.g, b.g, a.r, b.r, a.a, b.a]，供_mm_madd_epi16与两个权重相乘
+PIXELKERNELS_TARGET("sse4.1")
+inline __m128i interleavePixelPair(const uint32_t* pixels)
+{
+    const __m128i pair = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels));
+    return _mm_shuffle_epi8(pair, _mm_setr_epi8(0, -1, 4, -1, 1, -1, 5, -1, 2, -1, 6, -1, 3, -1, 7, -1));
+}
+
+// 从第k个权重开始累加剩余的抽头（每次两个，最后单个），返回四舍五入并饱和后的像素
+PIXELKERNELS_TARGET("sse4.1")
+inline uint32_t convolvePixelTail(const uint32_t* src, const int16_t* weights, const int32_t* weightPairs, int k, int taps,
+                                  __m128i acc)
+{
+    for (; k + 2 <= taps; k += 2) {
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(interleavePixelPair(src + k), _mm_set1_epi32(weightPairs[k / 2])));
+    }
+    if (k < taps) {
+        const __m128i pixel = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(static_cast<int>(src[k])));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(pixel, _mm_set1_epi32(static_cast<uint16_t>(weights[k]))));
+    }
+    acc = _mm_srai_epi32(_mm_add_epi32(acc, _mm_set1_epi32(1 << (ConvolutionShift - 1))), ConvolutionShift);
+    const __m128i packed = _mm_packus_epi16(_mm_packus_epi32(acc, acc), _mm_setzero_si128());
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(packed));
+}
+
+// 相邻两个权重打包为一个32位数（低16位为前一个），与interleavePixelPair的结果对应
+inline std::vector<int32_t> packWeightPairs(const int16_t* weights, int taps)
+{
+    std::vector<int32_t> pairs(taps / 2);
+    for (int k = 0; k + 2 <= taps; k += 2) {
+        pairs[k / 2] = static_cast<int32_t>(static_cast<uint16_t>(weights[k]) |
+                                            (static_cast<uint32_t>(static_cast<uint16_t>(weights[k + 1])) << 16));
+    }
+    return pairs;
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+void convolveRowArgbSse41(const uint32_t* src, int count, const int16_t* weights, int taps, uint32_t* dst, size_t dstStride)
+{
+    const std::vector<int32_t> pairs = packWeightPairs(weights, taps);
+    for (int i = 0; i < count; ++i) {
+        dst[i * dstStride] = convolvePixelTail(src + i, weights, pairs.data(), 0, taps, _mm_setzero_si128());
+    }
+}
+
+// 两个像素（8个16位通道值）的锐化结果，32位精度，尚未截断
+PIXELKERNELS_TARGET("sse4.1")
+inline void sharpenChannels(__m128i center, __m128i left, __m128i right, __m128i up, __m128i down, __m128i weights,
+                            __m128i& low, __m128i& high)
+{
+    const __m128i laplacian = _mm_sub_epi16(_mm_sub_epi16(_mm_slli_epi16(center, 2), _mm_add_epi16(left, right)),
+                                            _mm_add_epi16(up, down));
+    // 交错为(laplacian, center)对，与(weight, 256)做乘加
+    low = _mm_srai_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(laplacian, center), weights), 8);
+    high = _mm_srai_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(laplacian, center), weights), 8);
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+void sharpenRowArgbSse41(const uint32_t* above, const uint32_t* row, const uint32_t* below, int count, int weight, uint32_t* dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weights = _mm_set1_epi32(static_cast<int>((256u << 16) | static_cast<uint32_t>(weight)));
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i center = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        const __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i - 1));
+        const __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i + 1));
+        const __m128i up = _mm_loadu_si128(reinterpret_cast<const __m128i*>(above + i));
+        const __m128i down = _mm_loadu_si128(reinterpret_cast<const __m128i*>(below + i));
+
+        __m128i a, b, c, d;
+        sharpenChannels(_mm_unpacklo_epi8(center, zero), _mm_unpacklo_epi8(left, zero), _mm_unpacklo_epi8(right, zero),
+                        _mm_unpacklo_epi8(up, zero), _mm_unpacklo_epi8(down, zero), weights, a, b);
+        sharpenChannels(_mm_unpackhi_epi8(center, zero), _mm_unpackhi_epi8(left, zero), _mm_unpackhi_epi8(right, zero),
+                        _mm_unpackhi_epi8(up, zero), _mm_unpackhi_epi8(down, zero), weights, c, d);
+        const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_blendv_epi8(packed, center, alphaMask));
+    }
+    sharpenRowTail(above, row, below, i, count, weight, dst);
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+void sharpenRowU8Sse41(const uint8_t* above, const uint8_t* row, const uint8_t* below, int count, int weight, uint8_t* dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weights = _mm_set1_epi32(static_cast<int>((256u << 16) | static_cast<uint32_t>(weight)));
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i center = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        const __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i - 1));
+        const __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i + 1));
+        const __m128i up = _mm_loadu_si128(reinterpret_cast<const __m128i*>(above + i));
+        const __m128i down = _mm_loadu_si128(reinterpret_cast<const __m128i*>(below + i));
+
+        __m128i a, b, c, d;
+        sharpenChannels(_mm_unpacklo_epi8(center, zero), _mm_unpacklo_epi8(left, zero), _mm_unpacklo_epi8(right, zero),
+                        _mm_unpacklo_epi8(up, zero), _mm_unpacklo_epi8(down, zero), weights, a, b);
+        sharpenChannels(_mm_unpackhi_epi8(center, zero), _mm_unpackhi_epi8(left, zero), _mm_unpackhi_epi8(right, zero),
+                        _mm_unpackhi_epi8(up, zero), _mm_unpackhi_epi8(down, zero), weights, c, d);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+    }
+    sharpenRowU8Tail(above, row, below, i, count, weight, dst);
+}
+
+// 8个字节零扩展为16位
+PIXELKERNELS_TARGET("sse4.1")
+inline __m128i loadWidened(const uint8_t* p)
+{
+    return _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+// 8个像素的Sobel梯度（16位），返回交错的(gx, gy)对
+PIXELKERNELS_TARGET("sse4.1")
+inline void sobelGradients(const uint8_t* above, const uint8_t* row, const uint8_t* below, __m128i& low, __m128i& high)
+{
+    const __m128i upLeft = loadWidened(above - 1), up = loadWidened(above), upRight = loadWidened(above + 1);
+    const __m128i left = loadWidened(row - 1), right = loadWidened(row + 1);
+    const __m128i downLeft = loadWidened(below - 1), down = loadWidened(below), downRight = loadWidened(below + 1);
+
+    const __m128i gx = _mm_add_epi16(_mm_add_epi16(_mm_sub_epi16(upRight, upLeft), _mm_sub_epi16(downRight, downLeft)),
+                                     _mm_slli_epi16(_mm_sub_epi16(right, left), 1));
+    const __m128i gy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(downLeft, downRight), _mm_slli_epi16(down, 1)),
+                                     _mm_add_epi16(_mm_add_epi16(upLeft, upRight), _mm_slli_epi16(up, 1)));
+    low = _mm_unpacklo_epi16(gx, gy);
+    high = _mm_unpackhi_epi16(gx, gy);
+}
+
+// 4个32位平方和开方、乘以强度并截断为整数
+PIXELKERNELS_TARGET("sse4.1")
+inline __m128i sobelMagnitude(__m128i squared, __m128d intensity)
+{
+    const __m128d low = _mm_mul_pd(_mm_sqrt_pd(_mm_cvtepi32_pd(squared)), intensity);
+    const __m128d high = _mm_mul_pd(_mm_sqrt_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(squared, squared))), intensity);
+    return _mm_unpacklo_epi64(_mm_cvttpd_epi32(low), _mm_cvttpd_epi32(high));
+}
+
+// 8个强度值（16位，已截断到0-255）展开为8个不透明灰度像素
+PIXELKERNELS_TARGET("sse4.1")
+inline void storeGrayPixels(uint32_t* dst, __m128i values)
+{
+    const __m128i bytes = _mm_packus_epi16(values, values);
+    const __m128i pairs = _mm_unpacklo_epi8(bytes, bytes);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_or_si128(_mm_unpacklo_epi16(pairs, pairs), alpha));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_or_si128(_mm_unpackhi_epi16(pairs, pairs), alpha));
+}
+
+PIXELKERNELS_TARGET("sse4.1")
+void sobelRowGraySse41(const uint8_t* above, const uint8_t* row, const uint8_t* below, int count, double intensity, uint32_t* dst)
+{
+    const __m128d scale = _mm_set1_pd(intensity);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i low, high;
+        sobelGradients(above + i, row + i, below + i, low, high);
+        const __m128i magnitude = _mm_packs_epi32(sobelMagnitude(_mm_madd_epi16(low, low), scale),
+                                                  sobelMagnitude(_mm_madd_epi16(high, high), scale));
+        storeGrayPixels(dst + i, _mm_max_epi16(magnitude, _mm_setzero_si128()));
+    }
+    sobelRowTail(above, row, below, i, count, intensity, dst);
+}
+
+// ========== AVX2实现 ==========
+
+// 剩余不足一个向量宽度的部分交给SSE4.1实现；调用前清除YMM高位，
+// 避免AVX与传统SSE指令切换时的状态转换开销
+PIXELKERNELS_TARGET("avx2")
+inline __m128i foldAvx(__m256i v)
+{
+    return _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+PIXELKERNELS_TARGET("avx2")
+inline __m128i foldAvx64(__m256i v)
+{
+    return _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+PIXELKERNELS_TARGET("avx2")
+inline __m256i maddBytesAvx(__m256i a, __m256i b)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i low = _mm256_madd_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero));
+    const __m256i high = _mm256_madd_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero));
+    return _mm256_add_epi32(low, high);
+}
+
+PIXELKERNELS_TARGET("avx2")
+inline __m256i absDiffBytesAvx(__m256i a, __m256i b)
+{
+    return _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+}
+
+PIXELKERNELS_TARGET("avx2")
+uint32_t dotU8Avx2(const uint8_t* a, const uint8_t* b, int count)
+{
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        acc = _mm256_add_epi32(acc, maddBytesAvx(va, vb));
+    }
+    const uint32_t vectorSum = horizontalSum32(foldAvx(acc));
+    _mm256_zeroupper();
+    return vectorSum + dotU8Sse41(a + i, b + i, count - i);
+}
+
+PIXELKERNELS_TARGET("avx2")
+uint32_t sadU8Avx2(const uint8_t* a, const uint8_t* b, int count)
+{
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(va, vb));
+    }
+    const uint32_t vectorSum = static_cast<uint32_t>(horizontalSum64(foldAvx64(acc)));
+    _mm256_zeroupper();
+    return vectorSum + sadU8Sse41(a + i, b + i, count - i);
+}
+
+PIXELKERNELS_TARGET("avx2")
+uint32_t ssdU8Avx2(const uint8_t* a, const uint8_t* b, int count)
+{
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        const __m256i diff = absDiffBytesAvx(va, vb);
+        acc = _mm256_add_epi32(acc, maddBytesAvx(diff, diff));
+    }
+    const uint32_t vectorSum = horizontalSum32(foldAvx(acc));
+    _mm256_zeroupper();
+    return vectorSum + ssdU8Sse41(a + i, b + i, count - i);
+}
+
+PIXELKERNELS_TARGET("avx2")
+uint32_t sadArgbAvx2(const uint32_t* a, const uint32_t* b, int count)
+{
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>(RgbMask));
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i va = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), mask);
+        const __m256i vb = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)), mask);
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(va, vb));
+    }
+    const uint32_t vectorSum = static_cast<uint32_t>(horizontalSum64(foldAvx64(acc)));
+    _mm256_zeroupper();
+    return vectorSum + sadArgbSse41(a + i, b + i, count - i);
+}
+
+PIXELKERNELS_TARGET("avx2")
+uint64_t ssdArgbAvx2(const uint32_t* a, const uint32_t* b, int count)
+{
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>(RgbMask));
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i va = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), mask);
+        const __m256i vb = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)), mask);
+        const __m256i diff = absDiffBytesAvx(va, vb);
+        const __m256i squares = maddBytesAvx(diff, diff);
+        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(squares)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(squares, 1)));
+    }
+    const uint64_t vectorSum = horizontalSum64(foldAvx64(acc));
+    _mm256_zeroupper();
+    return vectorSum + ssdArgbSse41(a + i, b + i, count - i);
+}
+
+PIXELKERNELS_TARGET("avx2")
+uint64_t dotArgbAvx2(const uint32_t* a, const uint32_t* b, int count)
+{
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>(RgbMask));
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i va = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), mask);
+        const __m256i vb = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)), mask);
+        const __m256i products = maddBytesAvx(va, vb);
+        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(products)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(products, 1)));
+    }
+    const uint64_t vectorSum = horizontalSum64(foldAvx64(acc));
+    _mm256_zeroupper();
+    return vectorSum + dotArgbSse41(a + i, b + i, count - i);
+}
+
+// 8个32位元素的前缀和：两个128位通道各自求前缀和，再把低通道的总和加到高通道
+PIXELKERNELS_TARGET("avx2")
+inline __m256i prefixSum32Avx(__m256i v)
+{
+    v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+    v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+    const __m256i lowTotal = _mm256_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3));
+    return _mm256_add_epi32(v, _mm256_permute2x128_si256(lowTotal, lowTotal, 0x08));
+}
+
+PIXELKERNELS_TARGET("avx2")
+void integralRowU8Avx2(const uint8_t* src, int count, const uint32_t* sumAbove, const uint64_t* squaredAbove,
+                       uint32_t* sum, uint64_t* squaredSum)
+{
+    // 每次8个像素，进位为上一组最后一个元素的广播
+    const __m256i lastElement = _mm256_set1_epi32(7);
+    __m256i carry = _mm256_setzero_si256();
+    __m256i squaredCarry = _mm256_setzero_si256();
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i values = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+
+        const __m256i prefix = _mm256_add_epi32(prefixSum32Avx(values), carry);
+        carry = _mm256_permutevar8x32_epi32(prefix, lastElement);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sum + i),
+                            _mm256_add_epi32(prefix, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sumAbove + i))));
+
+        const __m256i squaredPrefix = prefixSum32Avx(_mm256_madd_epi16(values, values));
+        const __m256i low = _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(squaredPrefix)), squaredCarry);
+        const __m256i high = _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_extracti128_si256(squaredPrefix, 1)), squaredCarry);
+        squaredCarry = _mm256_permute4x64_epi64(high, _MM_SHUFFLE(3, 3, 3, 3));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(squaredSum + i),
+                            _mm256_add_epi64(low, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(squaredAbove + i))));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(squaredSum + i + 4),
+                            _mm256_add_epi64(high, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(squaredAbove + i + 4))));
+    }
+    const uint32_t sumCarry = static_cast<uint32_t>(_mm256_cvtsi256_si32(carry));
+    const uint64_t squaredSumCarry = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm256_castsi256_si128(squaredCarry)));
+    _mm256_zeroupper();
+    integralRowTail(src, i, count, sumAbove, squaredAbove, sum, squaredSum, sumCarry, squaredSumCarry);
+}
+
+PIXELKERNELS_TARGET("avx2")
+void pairRowU8Avx2(const uint8_t* src, int count, uint32_t* pairs)
+{
+    int i = 0;
+    for (; i + 9 <= count; i += 8) {
+        const __m256i low = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+        const __m256i high = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i + 1)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pairs + i), _mm256_or_si256(low, _mm256_slli_epi32(high, 16)));
+    }
+    _mm256_zeroupper();
+    pairRowTail(src, i, count, pairs);
+}
+
+// 与SSE4.1实现相同的寄存器分块，每次32个位置
+PIXELKERNELS_TARGET("avx2")
+void correlateRowU8Avx2(const uint32_t* sourcePairs, int count, const uint32_t* templatePairs, int taps, uint32_t* acc)
+{
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i acc0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i acc1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i + 8));
+        __m256i acc2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i + 16));
+        __m256i acc3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i + 24));
+        for (int k = 0; k < taps; k += 2) {
+            const __m256i weights = _mm256_set1_epi32(static_cast<int>(templatePairs[k]));
+            const uint32_t* s = sourcePairs + i + k;
+            acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s)), weights));
+            acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 8)), weights));
+            acc2 = _mm256_add_epi32(acc2, _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 16)), weights));
+            acc3 = _mm256_add_epi32(acc3, _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 24)), weights));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), acc0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i + 8), acc1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i + 16), acc2);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i + 24), acc3);
+    }
+    for (; i + 8 <= count; i += 8) {
+        __m256i sum = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        for (int k = 0; k < taps; k += 2) {
+            const __m256i weights = _mm256_set1_epi32(static_cast<int>(templatePairs[k]));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourcePairs + i + k)), weights));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), sum);
+    }
+    _mm256_zeroupper();
+    correlateRowTail(sourcePairs, i, count, templatePairs, taps, acc);
+}
+
+// 4组各8个32位的全1/全0结果压缩为32个字节；打包指令按128位通道进行，最后按32位重排恢复顺序
+PIXELKERNELS_TARGET("avx2")
+inline void storeMaskAvx(uint8_t* mask, __m256i a, __m256i b, __m256i c, __m256i d)
+{
+    const __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(mask),
+                        _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)));
+}
+
+PIXELKERNELS_TARGET("avx2")
+inline __m256i rgbRangeTestAvx(__m256i pixels, __m256i low, __m256i high)
+{
+    const __m256i inside = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(pixels, low), pixels),
+                                            _mm256_cmpeq_epi8(_mm256_min_epu8(pixels, high), pixels));
+    return _mm256_cmpeq_epi32(inside, _mm256_set1_epi32(-1));
+}
+
+PIXELKERNELS_TARGET("avx2")
+void rgbRangeMaskAvx2(const uint32_t* src, int count, uint32_t low, uint32_t high, uint8_t* mask)
+{
+    const __m256i vlow = _mm256_set1_epi32(static_cast<int>(low & RgbMask));
+    const __m256i vhigh = _mm256_set1_epi32(static_cast<int>(high | ~RgbMask));
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i* p = reinterpret_cast<const __m256i*>(src + i);
+        storeMaskAvx(mask + i, rgbRangeTestAvx(_mm256_loadu_si256(p), vlow, vhigh),
+                     rgbRangeTestAvx(_mm256_loadu_si256(p + 1), vlow, vhigh),
+                     rgbRangeTestAvx(_mm256_loadu_si256(p + 2), vlow, vhigh),
+                     rgbRangeTestAvx(_mm256_loadu_si256(p + 3), vlow, vhigh));
+    }
+    _mm256_zeroupper();
+    rgbRangeMaskSse41(src + i, count - i, low, high, mask + i);
+}
+
+PIXELKERNELS_TARGET("avx2")
+inline __m256i hsvRangeTestAvx(__m256i pixels, const HsvRange& range)
+{
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m256i r = _mm256_and_si256(_mm256_srli_epi32(pixels, 16), byteMask);
+    const __m256i g = _mm256_and_si256(_mm256_srli_epi32(pixels, 8), byteMask);
+    const __m256i b = _mm256_and_si256(pixels, byteMask);
+    const __m256i maxChannel = _mm256_max_epi32(r, _mm256_max_epi32(g, b));
+    const __m256i delta = _mm256_sub_epi32(maxChannel, _mm256_min_epi32(r, _mm256_min_epi32(g, b)));
+
+    __m256i reject = _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_set1_epi32(range.valueLow), maxChannel),
+                                     _mm256_cmpgt_epi32(maxChannel, _mm256_set1_epi32(range.valueHigh)));
+    const __m256i scaledDelta = _mm256_sub_epi32(_mm256_slli_epi32(delta, 8), delta);
+    reject = _mm256_or_si256(reject, _mm256_cmpgt_epi32(_mm256_madd_epi16(maxChannel, _mm256_set1_epi32(range.saturationLow)),
+                                                        scaledDelta));
+    reject = _mm256_or_si256(reject, _mm256_cmpgt_epi32(scaledDelta,
+                                                        _mm256_madd_epi16(maxChannel, _mm256_set1_epi32(range.saturationHigh))));
+    const __m256i achromatic = _mm256_cmpeq_epi32(delta, _mm256_setzero_si256());
+    if (range.saturationLow > 0) {
+        reject = _mm256_or_si256(reject, achromatic);
+    }
+
+    const __m256i redMax = _mm256_cmpeq_epi32(maxChannel, r);
+    const __m256i greenMax = _mm256_andnot_si256(redMax, _mm256_cmpeq_epi32(maxChannel, g));
+    __m256i numerator = _mm256_blendv_epi8(_mm256_sub_epi32(r, g), _mm256_sub_epi32(b, r), greenMax);
+    numerator = _mm256_blendv_epi8(numerator, _mm256_sub_epi32(g, b), redMax);
+    __m256 hue = _mm256_div_ps(_mm256_cvtepi32_ps(numerator), _mm256_cvtepi32_ps(delta));
+    __m256 offset = _mm256_blendv_ps(_mm256_set1_ps(4.0f), _mm256_set1_ps(2.0f), _mm256_castsi256_ps(greenMax));
+    offset = _mm256_blendv_ps(offset, _mm256_and_ps(_mm256_cmp_ps(hue, _mm256_setzero_ps(), _CMP_LT_OQ), _mm256_set1_ps(6.0f)),
+                              _mm256_castsi256_ps(redMax));
+    hue = _mm256_add_ps(hue, offset);
+
+    const __m256 aboveLow = _mm256_cmp_ps(hue, _mm256_set1_ps(range.hueLow), _CMP_GE_OQ);
+    const __m256 belowHigh = _mm256_cmp_ps(hue, _mm256_set1_ps(range.hueHigh), _CMP_LT_OQ);
+    const __m256 inHue = range.hueLow <= range.hueHigh ? _mm256_and_ps(aboveLow, belowHigh) : _mm256_or_ps(aboveLow, belowHigh);
+    const __m256i hueMatch = _mm256_or_si256(_mm256_castps_si256(inHue), achromatic);
+    return _mm256_andnot_si256(reject, hueMatch);
+}
+
+PIXELKERNELS_TARGET("avx2")
+void hsvRangeMaskAvx2(const uint32_t* src, int count, const HsvRange& range, uint8_t* mask)
+{
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i* p = reinterpret_cast<const __m256i*>(src + i);
+        storeMaskAvx(mask + i, hsvRangeTestAvx(_mm256_loadu_si256(p), range), hsvRangeTestAvx(_mm256_loadu_si256(p + 1), range),
+                     hsvRangeTestAvx(_mm256_loadu_si256(p + 2), range), hsvRangeTestAvx(_mm256_loadu_si256(p + 3), range));
+    }
+    _mm256_zeroupper();
+    hsvRangeMaskSse41(src + i, count - i, range, mask + i);
+}
+
+// 每次4个抽头：两个128位通道分别处理前后两对像素，最后把两个通道的累加值相加
+PIXELKERNELS_TARGET("avx2")
+void convolveRowArgbAvx2(const uint32_t* src, int count, const int16_t* weights, int taps, uint32_t* dst, size_t dstStride)
+{
+    const std::vector<int32_t> pairs = packWeightPairs(weights, taps);
+    const int quadTaps = taps & ~3;
+    std::vector<int32_t> quadWeights(quadTaps * 2);   // 每4个抽头8个32位数：低128位为前一对权重，高128位为后一对
+    for (int k = 0; k < quadTaps; k += 4) {
+        std::fill_n(quadWeights.begin() + k * 2, 4, pairs[k / 2]);
+        std::fill_n(quadWeights.begin() + k * 2 + 4, 4, pairs[k / 2 + 1]);
+    }
+    const __m256i interleave = _mm256_setr_epi8(0, -1, 4, -1, 1, -1, 5, -1, 2, -1, 6, -1, 3, -1, 7, -1,
+                                                8, -1, 12, -1, 9, -1, 13, -1, 10, -1, 14, -1, 11, -1, 15, -1);
+
+    for (int i = 0; i < count; ++i) {
+        const uint32_t* pixels = src + i;
+        __m256i acc = _mm256_setzero_si256();
+        for (int k = 0; k < quadTaps; k += 4) {
+            const __m256i quad = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + k)));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_shuffle_epi8(quad, interleave),
+                                                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&quadWeights[k * 2]))));
+        }
+        const __m128i folded = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        dst[i * dstStride] = convolvePixelTail(pixels, weights, pairs.data(), quadTaps, taps, folded);
+    }
+    _mm256_zeroupper();
+}
+
+// 与SSE4.1实现相同：解包、乘加与打包都在128位通道内进行，结果顺序不变
+PIXELKERNELS_TARGET("avx2")
+inline void sharpenChannelsAvx(__m256i center, __m256i left, __m256i right, __m256i up, __m256i down, __m256i weights,
+                               __m256i& low, __m256i& high)
+{
+    const __m256i laplacian = _mm256_sub_epi16(_mm256_sub_epi16(_mm256_slli_epi16(center, 2), _mm256_add_epi16(left, right)),
+                                               _mm256_add_epi16(up, down));
+    low = _mm256_srai_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(laplacian, center), weights), 8);
+    high = _mm256_srai_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(laplacian, center), weights), 8);
+}
+
+PIXELKERNELS_TARGET("avx2")
+void sharpenRowArgbAvx2(const uint32_t* above, const uint32_t* row, const uint32_t* below, int count, int weight, uint32_t* dst)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i weights = _mm256_set1_epi32(static_cast<int>((256u << 16) | static_cast<uint32_t>(weight)));
+    const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i center = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        const __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i - 1));
+        const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i + 1));
+        const __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above + i));
+        const __m256i down = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(below + i));
+
+        __m256i a, b, c, d;
+        sharpenChannelsAvx(_mm256_unpacklo_epi8(center, zero), _mm256_unpacklo_epi8(left, zero),
+                           _mm256_unpacklo_epi8(right, zero), _mm256_unpacklo_epi8(up, zero),
+                           _mm256_unpacklo_epi8(down, zero), weights, a, b);
+        sharpenChannelsAvx(_mm256_unpackhi_epi8(center, zero), _mm256_unpackhi_epi8(left, zero),
+                           _mm256_unpackhi_epi8(right, zero), _mm256_unpackhi_epi8(up, zero),
+                           _mm256_unpackhi_epi8(down, zero), weights, c, d);
+        const __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_blendv_epi8(packed, center, alphaMask));
+    }
+    _mm256_zeroupper();
+    sharpenRowArgbSse41(above + i, row + i, below + i, count - i, weight, dst + i);
+}
+
+PIXELKERNELS_TARGET("avx2")
+void sharpenRowU8Avx2(const uint8_t* above, const uint8_t* row, const uint8_t* below, int count, int weight, uint8_t* dst)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i weights = _mm256_set1_epi32(static_cast<int>((256u << 16) | static_cast<uint32_t>(weight)));
+
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i center = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        const __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i - 1));
+        const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i + 1));
+        const __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above + i));
+        const __m256i down = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(below + i));
+
+        __m256i a, b, c, d;
+        sharpenChannelsAvx(_mm256_unpacklo_epi8(center, zero), _mm256_unpacklo_epi8(left, zero),
+                           _mm256_unpacklo_epi8(right, zero), _mm256_unpacklo_epi8(up, zero),
+                           _mm256_unpacklo_epi8(down, zero), weights, a, b);
+        sharpenChannelsAvx(_mm256_unpackhi_epi8(center, zero), _mm256_unpackhi_epi8(left, zero),
+                           _mm256_unpackhi_epi8(right, zero), _mm256_unpackhi_epi8(up, zero),
+                           _mm256_unpackhi_epi8(down, zero), weights, c, d);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                            _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d)));
+    }
+    _mm256_zeroupper();
+    sharpenRowU8Sse41(above + i, row + i, below + i, count - i, weight, dst + i);
+}
+
+// 梯度与SSE4.1实现相同，开方每次处理4个双精度数
+PIXELKERNELS_TARGET("avx2")
+inline __m128i sobelMagnitudeAvx(__m128i squared, __m256d intensity)
+{
+    return _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_sqrt_pd(_mm256_cvtepi32_pd(squared)), intensity));
+}
+
+PIXELKERNELS_TARGET("avx2")
+void sobelRowGrayAvx2(const uint8_t* above, const uint8_t* row, const uint8_t* below, int count, double intensity, uint32_t* dst)
+{
+    const __m256d scale = _mm256_set1_pd(intensity);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i low, high;
+        sobelGradients(above + i, row + i, below + i, low, high);
+        const __m128i values = _mm_packs_epi32(sobelMagnitudeAvx(_mm_madd_epi16(low, low), scale),
+                                               sobelMagnitudeAvx(_mm_madd_epi16(high, high), scale));
+        storeGrayPixels(dst + i, _mm_max_epi16(values, _mm_setzero_si128()));
+    }
+    _mm256_zeroupper();
+    sobelRowTail(above, row, below, i, count, intensity, dst);
+}
+
+#endif // PIXELKERNELS_X86
+
+// ========== 分派表 ==========
+
+struct KernelTable {
+    Backend backend;
+    uint32_t (*dotU8)(const uint8_t*, const uint8_t*, int);
+    uint32_t (*sadU8)(const uint8_t*, const uint8_t*, int);
+    uint32_t (*ssdU8)(const uint8_t*, const uint8_t*, int);
+    uint32_t (*sadArgb)(const uint32_t*, const uint32_t*, int);
+    uint64_t (*ssdArgb)(const uint32_t*, const uint32_t*, int);
+    uint64_t (*dotArgb)(const uint32_t*, const uint32_t*, int);
+    void (*integralRowU8)(const uint8_t*, int, const uint32_t*, const uint64_t*, uint32_t*, uint64_t*);
+    void (*pairRowU8)(const uint8_t*, int, uint32_t*);
+    void (*correlateRowU8)(const uint32_t*, int, const uint32_t*, int, uint32_t*);
+    void (*rgbRangeMask)(const uint32_t*, int, uint32_t, uint32_t, uint8_t*);
+    void (*hsvRangeMask)(const uint32_t*, int, const HsvRange&, uint8_t*);
+    void (*convolveRowArgb)(const uint32_t*, int, const int16_t*, int, uint32_t*, size_t);
+    void (*sharpenRowArgb)(const uint32_t*, const uint32_t*, const uint32_t*, int, int, uint32_t*);
+    void (*sharpenRowU8)(const uint8_t*, const uint8_t*, const uint8_t*, int, int, uint8_t*);
+    void (*sobelRowGray)(const uint8_t*, const uint8_t*, const uint8_t*, int, double, uint32_t*);
+};
+
+const KernelTable ScalarTable = {
+    Backend::Scalar, dotU8Scalar, sadU8Scalar, ssdU8Scalar, sadArgbScalar, ssdArgbScalar, dotArgbScalar,
+    integralRowU8Scalar, pairRowU8Scalar, correlateRowU8Scalar, rgbRangeMaskScalar, hsvRangeMaskScalar,
+    convolveRowArgbScalar, sharpenRowArgbScalar, sharpenRowU8Scalar, sobelRowGrayScalar
+};
+
+#ifdef PIXELKERNELS_X86
+const KernelTable Sse41Table = {
+    Backend::SSE41, dotU8Sse41, sadU8Sse41, ssdU8Sse41, sadArgbSse41, ssdArgbSse41, dotArgbSse41,
+    integralRowU8Sse41, pairRowU8Sse41, correlateRowU8Sse41, rgbRangeMaskSse41, hsvRangeMaskSse41,
+    convolveRowArgbSse41, sharpenRowArgbSse41, sharpenRowU8Sse41, sobelRowGraySse41
+};
+
+const KernelTable Avx2Table = {
+    Backend::AVX2, dotU8Avx2, sadU8Avx2, ssdU8Avx2, sadArgbAvx2, ssdArgbAvx2, dotArgbAvx2,
+    integralRowU8Avx2, pairRowU8Avx2, correlateRowU8Avx2, rgbRangeMaskAvx2, hsvRangeMaskAvx2,
+    convolveRowArgbAvx2, sharpenRowArgbAvx2, sharpenRowU8Avx2, sobelRowGrayAvx2
+};
+#endif
+
+const KernelTable* tableFor(Backend backend)
+{
+#ifdef PIXELKERNELS_X86
+    switch (backend) {
+        case Backend::AVX2: return &Avx2Table;
+        case Backend::SSE41: return &Sse41Table;
+        default: break;
+    }
+#else
+    (void)backend;
+#endif
+    return &ScalarTable;
+}
+
+bool cpuSupports(Backend backend)
+{
+    if (backend == Backend::Scalar) {
+        return true;
+    }
+#ifdef PIXELKERNELS_X86
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (backend == Backend::SSE41) {
+        return __builtin_cpu_supports("sse4.1");
+    }
+    return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    if (backend == Backend::SSE41) {
+        return sse41;
+    }
+    // AVX2需要CPU支持且操作系统保存YMM寄存器
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+#else
+    return false;
+#endif
+}
+
+std::atomic<const KernelTable*>& activeTable()
+{
+    static std::atomic<const KernelTable*> table{tableFor(detectBackend())};
+    return table;
+}
+
+}
+
+// ========== 内核入口 ==========
+
+uint32_t dotU8(const uint8_t* a, const uint8_t* b, int count)
+{
+    return activeTable().load(std::memory_order_relaxed)->dotU8(a, b, count);
+}
+
+uint32_t sadU8(const uint8_t* a, const uint8_t* b, int count)
+{
+    return activeTable().load(std::memory_order_relaxed)->sadU8(a, b, count);
+}
+
+uint32_t ssdU8(const uint8_t* a, const uint8_t* b, int count)
+{
+    return activeTable().load(std::memory_order_relaxed)->ssdU8(a, b, count);
+}
+
+uint32_t sadArgb(const uint32_t* a, const uint32_t* b, int count)
+{
+    return activeTable().load(std::memory_order_relaxed)->sadArgb(a, b, count);
+}
+
+uint64_t ssdArgb(const uint32_t* a, const uint32_t* b, int count)
+{
+    return activeTable().load(std::memory_order_relaxed)->ssdArgb(a, b, count);
+}
+
+uint64_t dotArgb(const uint32_t* a, const uint32_t* b, int count)
+{
+    return activeTable().load(std::memory_order_relaxed)->dotArgb(a, b, count);
+}
+
+void integralRowU8(const uint8_t* src, int count, const uint32_t* sumAbove, const uint64_t* squaredAbove,
+                   uint32_t* sum, uint64_t* squaredSum)
+{
+    activeTable().load(std::memory_order_relaxed)->integralRowU8(src, count, sumAbove, squaredAbove, sum, squaredSum);
+}
+
+void pairRowU8(const uint8_t* src, int count, uint32_t* pairs)
+{
+    activeTable().load(std::memory_order_relaxed)->pairRowU8(src, count, pairs);
+}
+
+void correlateRowU8(const uint32_t* sourcePairs, int count, const uint32_t* templatePairs, int taps, uint32_t* acc)
+{
+    activeTable().load(std::memory_order_relaxed)->correlateRowU8(sourcePairs, count, templatePairs, taps, acc);
+}
+
+void rgbRangeMask(const uint32_t* src, int count, uint32_t low, uint32_t high, uint8_t* mask)
+{
+    activeTable().load(std::memory_order_relaxed)->rgbRangeMask(src, count, low, high, mask);
+}
+
+void hsvRangeMask(const uint32_t* src, int count, const HsvRange& range, uint8_t* mask)
+{
+    activeTable().load(std::memory_order_relaxed)->hsvRangeMask(src, count, range, mask);
+}
+
+void convolveRowArgb(const uint32_t* src, int count, const int16_t* weights, int taps, uint32_t* dst, size_t dstStride)
+{
+    activeTable().load(std::memory_order_relaxed)->convolveRowArgb(src, count, weights, taps, dst, dstStride);
+}
+
+void sharpenRowArgb(const uint32_t* above, const uint32_t* row, const uint32_t* below, int count, int weight, uint32_t* dst)
+{
+    activeTable().load(std::memory_order_relaxed)->sharpenRowArgb(above, row, below, count, weight, dst);
+}
+
+void sharpenRowU8(const uint8_t* above, const uint8_t* row, const uint8_t* below, int count, int weight, uint8_t* dst)
+{
+    activeTable().load(std::memory_order_relaxed)->sharpenRowU8(above, row, below, count, weight, dst);
+}
+
+void sobelRowGray(const uint8_t* above, const uint8_t* row, const uint8_t* below, int count, double intensity, uint32_t* dst)
+{
+    activeTable().load(std::memory_order_relaxed)->sobelRowGray(above, row, below, count, intensity, dst);
+}
+
+// ========== 后端选择 ==========
+
+Backend activeBackend()
+{
+    return activeTable().load()->backend;
+}
+
+Backend detectBackend()
+{
+    static const Backend detected = cpuSupports(Backend::AVX2) ? Backend::AVX2
+                                  : cpuSupports(Backend::SSE41) ? Backend::SSE41
+                                  : Backend::Scalar;
+    return detected;
+}
+
+bool isBackendSupported(Backend backend)
+{
+    return tableFor(backend)->backend == backend && cpuSupports(backend);
+}
+
+bool setBackend(Backend backend)
+{
+    if (!isBackendSupported(backend)) {
+        return false;
+    }
+    activeTable().store(tableFor(backend));
+    return true;
+}
+
+QString backendName(Backend backend)
+{
+    switch (backend) {
+        case Backend::AVX2: return "AVX2";
+        case Backend::SSE41: return "SSE4.1";
+        default: return "Scalar";
+    }
+}
+
+// ========== 微基准测试 ==========
+
+std::vector<BenchmarkResult> runBenchmark(int rowLength, int totalPixels)
+{
+    std::vector<BenchmarkResult> results;
+    if (rowLength <= 0 || totalPixels < rowLength) {
+        return results;
+    }
+
+    // 伪随机测试数据（固定种子，保证各后端输入一致）
+    std::vector<uint8_t> grayA(rowLength), grayB(rowLength);
+    std::vector<uint32_t> argbA(rowLength), argbB(rowLength);
+    uint32_t seed = 12345u;
+    for (int i = 0; i < rowLength; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        grayA[i] = static_cast<uint8_t>(seed >> 24);
+        grayB[i] = static_cast<uint8_t>(seed >> 16);
+        argbA[i] = seed;
+        argbB[i] = seed * 2654435761u;
+    }
+
+    std::vector<uint8_t> mask(rowLength);
+    HsvRange hsvRange;
+    hsvRange.hueLow = 5.5f;
+    hsvRange.hueHigh = 0.5f;
+    hsvRange.saturationLow = 64;
+
+    // 9抽头二项式核，输出比输入少8个像素
+    const int16_t convolutionWeights[] = {64, 512, 1792, 3584, 4480, 3584, 1792, 512, 64};
+    const int convolutionTaps = 9;
+    std::vector<uint32_t> convolved(rowLength);
+
+    // 行互相关：16抽头模板在rowLength个位置上累加，吞吐量按位置计
+    const int correlationTaps = 16;
+    std::vector<uint8_t> correlationSource(rowLength + correlationTaps - 1);
+    for (size_t i = 0; i < correlationSource.size(); ++i) {
+        correlationSource[i] = grayA[i % rowLength];
+    }
+    std::vector<uint32_t> sourcePairs(correlationSource.size());
+    std::vector<uint32_t> templatePairs(correlationTaps);
+    pairRowU8(correlationSource.data(), static_cast<int>(correlationSource.size()), sourcePairs.data());
+    pairRowU8(grayB.data(), std::min(rowLength, correlationTaps), templatePairs.data());
+    std::vector<uint32_t> correlation(rowLength);
+
+    const int calls = totalPixels / rowLength;
+    const Backend previous = activeBackend();
+
+    auto measure = [&](const QString& kernel, Backend backend, auto&& body) {
+        volatile uint64_t sink = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int call = 0; call < calls; ++call) {
+            sink = sink + body();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        (void)sink;
+
+        BenchmarkResult result;
+        result.kernel = kernel;
+        result.backend = backend;
+        result.pixelsPerSecond = seconds > 0.0 ? static_cast<double>(calls) * rowLength / seconds : 0.0;
+        results.push_back(result);
+    };
+
+    for (Backend backend : {Backend::Scalar, Backend::SSE41, Backend::AVX2}) {
+        if (!setBackend(backend)) {
+            continue;
+        }
+        measure("dotU8", backend, [&]() { return dotU8(grayA.data(), grayB.data(), rowLength); });
+        measure("sadU8", backend, [&]() { return sadU8(grayA.data(), grayB.data(), rowLength); });
+        measure("ssdU8", backend, [&]() { return ssdU8(grayA.data(), grayB.data(), rowLength); });
+        measure("sadArgb", backend, [&]() { return sadArgb(argbA.data(), argbB.data(), rowLength); });
+        measure("ssdArgb", backend, [&]() { return ssdArgb(argbA.data(), argbB.data(), rowLength); });
+        measure("dotArgb", backend, [&]() { return dotArgb(argbA.data(), argbB.data(), rowLength); });
+        measure("rgbRangeMask", backend, [&]() {
+            rgbRangeMask(argbA.data(), rowLength, 0x00404040u, 0x00C0C0C0u, mask.data());
+            return mask[0];
+        });
+        measure("hsvRangeMask", backend, [&]() {
+            hsvRangeMask(argbA.data(), rowLength, hsvRange, mask.data());
+            return mask[0];
+        });
+        measure("convolveRowArgb", backend, [&]() {
+            convolveRowArgb(argbA.data(), std::max(0, rowLength - convolutionTaps + 1), convolutionWeights, convolutionTaps,
+                            convolved.data(), 1);
+            return convolved[0];
+        });
+        measure("correlateRowU8", backend, [&]() {
+            correlateRowU8(sourcePairs.data(), rowLength, templatePairs.data(), std::min(rowLength, correlationTaps),
+                           correlation.data());
+            return correlation[0];
+        });
+    }
+
+    setBackend(previous);
+    return results;
+}
+
+}
@@ -0,0 +1,352 @@
+#include "core/ReplayCaptureSource.h"
+#include <QDir>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const QStringList ImageNameFilters = {"*.png", "*.jpg", "*.jpeg", "*.bmp"};
+
+// 帧文件中每帧的头部
+struct FrameHeader {
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t format = 0;
+    int32_t stride = 0;
+    int64_t timestamp = 0;
+};
+static_assert(sizeof(FrameHeader) == 24, "FrameHeader must match the file layout");
+
+const int MagicBytes = 8;
+
+// Frame可以直接共享像素的格式，其他格式转换为ARGB32
+QImage toFrameFormat(const QImage& image)
+{
+    switch (image.format()) {
+    case QImage::Format_ARGB32:
+    case QImage::Format_RGB32:
+    case QImage::Format_Grayscale8:
+        return image;
+    default:
+        return image.convertToFormat(QImage::Format_ARGB32);
+    }
+}
+
+Frame::PixelFormat pixelFormatOf(const QImage& image)
+{
+    switch (image.format()) {
+    case QImage::Format_RGB32:
+        return Frame::PixelFormat::Bgrx32;
+    case QImage::Format_Grayscale8:
+        return Frame::PixelFormat::Gray8;
+    default:
+        return Frame::PixelFormat::Bgra32;
+    }
+}
+
+}
+
+ReplayCaptureSource::ReplayCaptureSource(double fps, Pacing pacing)
+    : frameRate(fps > 0.0 ? fps : 30.0)
+    , pacing(pacing)
+    , loop(false)
+    , running(false)
+    , nextIndex(0)
+    , startTimestamp(0)
+    , lastTick(-1)
+    , frameSequence(0)
+    , currentFormat(Frame::PixelFormat::Bgra32)
+{
+}
+
+// ========== 打开 ==========
+
+int ReplayCaptureSource::openImageSequence(const QString& directory, bool preload)
+{
+    const QDir dir(directory);
+    if (!dir.exists()) {
+        return -1;
+    }
+
+    QStringList files;
+    for (const QString& fileName : dir.entryList(ImageNameFilters, QDir::Files, QDir::Name)) {
+        files.append(dir.filePath(fileName));
+    }
+    return openImageFiles(files, preload);
+}
+
+int ReplayCaptureSource::openImageFiles(const QStringList& files, bool preload)
+{
+    close();
+    if (files.isEmpty()) {
+        return -1;
+    }
+
+    if (preload) {
+        preloadedImages.reserve(files.size());
+        for (const QString& path : files) {
+            QImage image;
+            if (!image.load(path)) {
+                close();
+                return -1;
+            }
+            preloadedImages.push_back(toFrameFormat(image));
+        }
+        currentSize = preloadedImages.front().size();
+        currentFormat = pixelFormatOf(preloadedImages.front());
+    } else {
+        // 只解码第一帧以得到尺寸与格式
+        QImage first;
+        if (!first.load(files.front())) {
+            return -1;
+        }
+        first = toFrameFormat(first);
+        currentSize = first.size();
+        currentFormat = pixelFormatOf(first);
+    }
+    imageFiles = files;
+    return frameCount();
+}
+
+int ReplayCaptureSource::openRecording(const QString& path)
+{
+    close();
+    recording.setFileName(path);
+    if (!recording.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    char magic[MagicBytes];
+    if (recording.read(magic, MagicBytes) != MagicBytes || std::memcmp(magic, FrameRecorder::Magic, MagicBytes) != 0) {
+        close();
+        return -1;
+    }
+
+    // 建立帧索引，末尾不完整的帧被忽略
+    const qint64 fileSize = recording.size();
+    FrameHeader header;
+    while (recording.read(reinterpret_cast<char*>(&header), sizeof(header)) == sizeof(header)) {
+        if (header.width <= 0 || header.height <= 0 || header.format < 0 || header.format > 2) {
+            break;
+        }
+        const auto format = static_cast<Frame::PixelFormat>(header.format);
+        if (header.stride < static_cast<int64_t>(header.width) * Frame::bytesPerPixel(format)) {
+            break;
+        }
+        const qint64 offset = recording.pos();
+        const qint64 bytes = static_cast<qint64>(header.stride) * header.height;
+        if (offset + bytes > fileSize || !recording.seek(offset + bytes)) {
+            break;
+        }
+
+        RecordedFrame frame;
+        frame.offset = offset;
+        frame.width = header.width;
+        frame.height = header.height;
+        frame.stride = header.stride;
+        frame.format = format;
+        recordedFrames.push_back(frame);
+    }
+
+    if (!recordedFrames.empty()) {
+        currentSize = QSize(recordedFrames.front().width, recordedFrames.front().height);
+        currentFormat = recordedFrames.front().format;
+    }
+    return frameCount();
+}
+
+void ReplayCaptureSource::close()
+{
+    stop();
+    imageFiles.clear();
+    preloadedImages.clear();
+    if (recording.isOpen()) {
+        recording.close();
+    }
+    recordedFrames.clear();
+    nextIndex = 0;
+    lastTick = -1;
+    frameSequence = 0;
+    currentSize = QSize();
+}
+
+// ========== 回放配置 ==========
+
+void ReplayCaptureSource::setFrameRate(double fps)
+{
+    if (fps <= 0.0) {
+        return;
+    }
+    // 回放中改变帧率时从下一帧继续
+    if (running && pacing == Pacing::RealTime) {
+        nextIndex = static_cast<int>(lastTick + 1);
+        startTimestamp = Frame::currentTimestamp() - static_cast<qint64>(nextIndex * 1e9 / fps);
+        lastTick = nextIndex - 1;
+    }
+    frameRate = fps;
+}
+
+int ReplayCaptureSource::frameCount() const
+{
+    return recordedFrames.empty() ? static_cast<int>(imageFiles.size()) : static_cast<int>(recordedFrames.size());
+}
+
+void ReplayCaptureSource::seek(int index)
+{
+    const int count = frameCount();
+    nextIndex = count > 0 ? std::max(0, std::min(index, count)) : 0;
+    frameSequence = nextIndex;
+    if (running && pacing == Pacing::RealTime) {
+        startTimestamp = Frame::currentTimestamp() - static_cast<qint64>(nextIndex * 1e9 / frameRate);
+        lastTick = nextIndex - 1;
+    }
+}
+
+bool ReplayCaptureSource::atEnd() const
+{
+    if (loop) {
+        return false;
+    }
+    const qint64 next = pacing == Pacing::RealTime && running ? lastTick + 1 : nextIndex;
+    return next >= frameCount();
+}
+
+// ========== CaptureSource ==========
+
+bool ReplayCaptureSource::start()
+{
+    if (frameCount() == 0) {
+        return false;
+    }
+    running = true;
+    startTimestamp = Frame::currentTimestamp() - static_cast<qint64>(nextIndex * 1e9 / frameRate);
+    lastTick = nextIndex - 1;
+    return true;
+}
+
+void ReplayCaptureSource::stop()
+{
+    // RealTime模式下次start时从停止的位置继续
+    if (running && pacing == Pacing::RealTime) {
+        nextIndex = static_cast<int>(std::min<qint64>(lastTick + 1, frameCount()));
+    }
+    running = false;
+}
+
+Frame ReplayCaptureSource::nextFrame()
+{
+    const int count = frameCount();
+    if (!running || count == 0) {
+        return Frame();
+    }
+
+    qint64 position;
+    if (pacing == Pacing::RealTime) {
+        // 当前时刻应显示的帧，跟不上帧率时跳过中间的帧
+        const double elapsed = (Frame::currentTimestamp() - startTimestamp) / 1e9;
+        const qint64 tick = static_cast<qint64>(std::floor(elapsed * frameRate));
+        if (tick <= lastTick || (!loop && tick >= count)) {
+            return Frame();
+        }
+        lastTick = tick;
+        position = tick;
+    } else {
+        if (nextIndex >= count) {
+            if (!loop) {
+                return Frame();
+            }
+            nextIndex = 0;
+        }
+        position = static_cast<qint64>(frameSequence);
+        ++nextIndex;
+    }
+
+    frameSequence = static_cast<quint64>(position) + 1;
+    return loadFrame(static_cast<int>(position % count), frameSequence);
+}
+
+Frame ReplayCaptureSource::loadFrame(int index, quint64 sequence)
+{
+    const qint64 timestamp = Frame::currentTimestamp();
+
+    if (!recordedFrames.empty()) {
+        const RecordedFrame& recorded = recordedFrames[index];
+        const qint64 bytes = static_cast<qint64>(recorded.stride) * recorded.height;
+        std::shared_ptr<uint8_t> buffer = framePool.acquire(static_cast<size_t>(bytes));
+        if (!recording.seek(recorded.offset) ||
+            recording.read(reinterpret_cast<char*>(buffer.get()), bytes) != bytes) {
+            return Frame();
+        }
+        currentSize = QSize(recorded.width, recorded.height);
+        currentFormat = recorded.format;
+        return Frame(std::move(buffer), recorded.width, recorded.height, recorded.stride, recorded.format,
+                     sequence, timestamp);
+    }
+
+    QImage image;
+    if (!preloadedImages.empty()) {
+        image = preloadedImages[index];
+    } else if (image.load(imageFiles[index])) {
+        image = toFrameFormat(image);
+    } else {
+        return Frame();
+    }
+    currentSize = image.size();
+    currentFormat = pixelFormatOf(image);
+    return Frame::fromImage(image, sequence, timestamp);
+}
+
+// ========== FrameRecorder ==========
+
+FrameRecorder::~FrameRecorder()
+{
+    close();
+}
+
+bool FrameRecorder::open(const QString& path)
+{
+    close();
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    if (file.write(Magic, MagicBytes) != MagicBytes) {
+        file.close();
+        return false;
+    }
+    framesWritten = 0;
+    return true;
+}
+
+bool FrameRecorder::write(const Frame& frame)
+{
+    if (!file.isOpen() || frame.isNull()) {
+        return false;
+    }
+
+    FrameHeader header;
+    header.width = frame.width();
+    header.height = frame.height();
+    header.format = static_cast<int32_t>(frame.format());
+    header.stride = frame.width() * Frame::bytesPerPixel(frame.format());
+    header.timestamp = frame.timestamp();
+    if (file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+
+    // 逐行写入，去掉行尾的对齐填充
+    for (int y = 0; y < frame.height(); ++y) {
+        if (file.write(reinterpret_cast<const char*>(frame.constScanLine(y)), header.stride) != header.stride) {
+            return false;
+        }
+    }
+    ++framesWritten;
+    return true;
+}
+
+void FrameRecorder::close()
+{
+    if (file.isOpen()) {
+        file.close();
+    }
+}
@@ -0,0 +1,191 @@
+#include "core/ScreenStateClassifier.h"
+#include "core/TemplateMatcher.h"
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+
+namespace {
+
+// 缩略图每个格子在每个方向上最多取的样本数
+const int ThumbnailSamples = 4;
+
+const QStringList ImageNameFilters = {"*.png", "*.jpg", "*.jpeg", "*.bmp"};
+
+// 按格子求颜色均值的缩略图
+QImage colorThumbnail(const QImage& image)
+{
+    const int size = ScreenStateClassifier::ThumbnailSize;
+    const QImage color = TemplateMatcher::toColorBuffer(image);
+    const int imageWidth = color.width();
+    const int imageHeight = color.height();
+
+    QImage thumbnail(size, size, QImage::Format_RGB32);
+    for (int cellY = 0; cellY < size; ++cellY) {
+        const int top = cellY * imageHeight / size;
+        const int bottom = std::max(top + 1, (cellY + 1) * imageHeight / size);
+        const int stepY = std::max(1, (bottom - top) / ThumbnailSamples);
+        QRgb* dst = reinterpret_cast<QRgb*>(thumbnail.scanLine(cellY));
+
+        for (int cellX = 0; cellX < size; ++cellX) {
+            const int left = cellX * imageWidth / size;
+            const int right = std::max(left + 1, (cellX + 1) * imageWidth / size);
+            const int stepX = std::max(1, (right - left) / ThumbnailSamples);
+
+            int red = 0, green = 0, blue = 0, count = 0;
+            for (int y = top; y < bottom; y += stepY) {
+                const QRgb* row = reinterpret_cast<const QRgb*>(color.constScanLine(y));
+                for (int x = left; x < right; x += stepX) {
+                    red += qRed(row[x]);
+                    green += qGreen(row[x]);
+                    blue += qBlue(row[x]);
+                    ++count;
+                }
+            }
+            dst[cellX] = qRgb(red / count, green / count, blue / count);
+        }
+    }
+    return thumbnail;
+}
+
+}
+
+ScreenStateClassifier::ScreenStateClassifier()
+    : ScreenStateClassifier(Parameters())
+{
+}
+
+ScreenStateClassifier::ScreenStateClassifier(const Parameters& parameters)
+    : parameters(parameters)
+{
+}
+
+// ========== 参考图管理 ==========
+
+int ScreenStateClassifier::loadDirectory(const QString& directory)
+{
+    const QDir root(directory);
+    if (!root.exists()) {
+        return -1;
+    }
+
+    int loaded = 0;
+    auto loadFile = [this, &loaded](const QString& label, const QString& path) {
+        QImage image;
+        if (image.load(path) && addReference(label, image, path)) {
+            ++loaded;
+        }
+    };
+
+    for (const QString& fileName : root.entryList(ImageNameFilters, QDir::Files, QDir::Name)) {
+        loadFile(QFileInfo(fileName).completeBaseName(), root.filePath(fileName));
+    }
+    for (const QString& subdirectory : root.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+        const QDir labelDir(root.filePath(subdirectory));
+        for (const QString& fileName : labelDir.entryList(ImageNameFilters, QDir::Files, QDir::Name)) {
+            loadFile(subdirectory, labelDir.filePath(fileName));
+        }
+    }
+    return loaded;
+}
+
+bool ScreenStateClassifier::addReference(const QString& label, const QImage& image, const QString& source)
+{
+    if (label.isEmpty() || !ImageProcessor::isValidImage(image)) {
+        return false;
+    }
+
+    Reference reference;
+    reference.label = label;
+    reference.source = source;
+    reference.descriptor = describe(image);
+
+    hashIndex.insert(reference.descriptor.hash, reference.label);
+    references.push_back(std::move(reference));
+    return true;
+}
+
+void ScreenStateClassifier::clear()
+{
+    references.clear();
+    hashIndex.clear();
+}
+
+QStringList ScreenStateClassifier::labels() const
+{
+    QStringList result;
+    for (const Reference& reference : references) {
+        if (!result.contains(reference.label)) {
+            result.append(reference.label);
+        }
+    }
+    return result;
+}
+
+// ========== 分类 ==========
+
+ScreenStateClassifier::Classification ScreenStateClassifier::classify(const QImage& frame) const
+{
+    if (!ImageProcessor::isValidImage(frame) || references.empty()) {
+        return Classification();
+    }
+    return classify(describe(frame));
+}
+
+ScreenStateClassifier::Classification ScreenStateClassifier::classify(const Descriptor& descriptor) const
+{
+    Classification best;
+    const auto candidates = hashIndex.search(descriptor.hash, parameters.maxHashDistance);
+
+    // 随机哈希之间的距离约为32位，距离达到32时哈希部分不再提供任何相似度
+    for (const auto& candidate : candidates) {
+        const Reference& reference = references[candidate.index];
+        const double hashSimilarity = std::max(0.0, 1.0 - candidate.distance / 32.0);
+        const double confidence = parameters.hashWeight * hashSimilarity +
+                                  (1.0 - parameters.hashWeight) * histogramSimilarity(descriptor, reference.descriptor);
+        if (best.hashDistance < 0 || confidence > best.confidence) {
+            best.confidence = confidence;
+            best.hashDistance = candidate.distance;
+            best.label = reference.label;
+            best.reference = reference.source;
+        }
+    }
+
+    if (best.confidence < parameters.minConfidence) {
+        best.label.clear();
+    }
+    return best;
+}
+
+ScreenStateClassifier::Descriptor ScreenStateClassifier::describe(const QImage& image)
+{
+    Descriptor descriptor;
+    if (!ImageProcessor::isValidImage(image)) {
+        return descriptor;
+    }
+
+    const QImage thumbnail = colorThumbnail(image);
+    descriptor.hash = ImageProcessorUtils::dctHash(thumbnail);
+
+    const int regionSize = ThumbnailSize / RegionGrid;
+    const int shift = 8 - HistogramBits;
+    for (int y = 0; y < ThumbnailSize; ++y) {
+        const QRgb* row = reinterpret_cast<const QRgb*>(thumbnail.constScanLine(y));
+        for (int x = 0; x < ThumbnailSize; ++x) {
+            const int region = (y / regionSize) * RegionGrid + x / regionSize;
+            const int bin = ((qRed(row[x]) >> shift) << (2 * HistogramBits)) |
+                            ((qGreen(row[x]) >> shift) << HistogramBits) |
+                            (qBlue(row[x]) >> shift);
+            ++descriptor.histograms[region * HistogramBins + bin];
+        }
+    }
+    return descriptor;
+}
+
+double ScreenStateClassifier::histogramSimilarity(const Descriptor& first, const Descriptor& second)
+{
+    uint32_t common = 0;
+    for (size_t i = 0; i < first.histograms.size(); ++i) {
+        common += std::min(first.histograms[i], second.histograms[i]);
+    }
+    return static_cast<double>(common) / (ThumbnailSize * ThumbnailSize);
+}
@@ -0,0 +1,243 @@
+#include "core/TaskPool.h"
+#include <algorithm>
+
+namespace {
+
+// 当前线程所属的线程池及其槽位，工作线程内提交的任务放入本线程的队列
+thread_local const void* currentPool = nullptr;
+thread_local int currentIndex = -1;
+
+}
+
+TaskPool::TaskPool(int threadCount)
+{
+    workers.reserve(MaxThreads);
+    for (int i = 0; i < MaxThreads; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    setThreadCount(threadCount);
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        for (const std::unique_ptr<Worker>& worker : workers) {
+            std::lock_guard<std::mutex> queueLock(worker->mutex);
+            for (std::deque<Entry>& queue : worker->queues) {
+                unfinished -= static_cast<int>(queue.size());
+                pending.fetch_sub(static_cast<int>(queue.size()), std::memory_order_relaxed);
+                queue.clear();
+            }
+        }
+    }
+    wakeCondition.notify_all();
+    idleCondition.notify_all();
+    for (const std::unique_ptr<Worker>& worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void TaskPool::setThreadCount(int threadCount)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            return;
+        }
+        activeCount = std::clamp(threadCount, 1, MaxThreads);
+        nextQueue %= activeCount;
+        startWorkers(activeCount);
+    }
+    // 唤醒空闲线程，下标超出的线程据此退出
+    wakeCondition.notify_all();
+}
+
+int TaskPool::threadCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return activeCount;
+}
+
+void TaskPool::startWorkers(int count)
+{
+    for (int i = 0; i < count; ++i) {
+        Worker& worker = *workers[i];
+        if (worker.alive) {
+            continue;
+        }
+        // 已退出的线程只剩返回，join不会等待
+        if (worker.thread.joinable()) {
+            worker.thread.join();
+        }
+        worker.alive = true;
+        worker.thread = std::thread(&TaskPool::run, this, i);
+    }
+    slotCount.store(std::max(slotCount.load(std::memory_order_relaxed), count), std::memory_order_release);
+}
+
+void TaskPool::submit(Task task, TaskPriority priority, const CancellationToken& token)
+{
+    if (!task) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            return;
+        }
+        int index;
+        if (currentPool == this && currentIndex < activeCount) {
+            index = currentIndex;
+        } else {
+            index = nextQueue;
+            nextQueue = (nextQueue + 1) % activeCount;
+        }
+        {
+            Worker& worker = *workers[index];
+            std::lock_guard<std::mutex> queueLock(worker.mutex);
+            worker.queues[static_cast<int>(priority)].push_back(Entry{std::move(task), token});
+        }
+        ++unfinished;
+        pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    wakeCondition.notify_one();
+}
+
+void TaskPool::waitForIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idleCondition.wait(lock, [this] { return unfinished == 0; });
+}
+
+void TaskPool::parallelFor(int count, const std::function<void(int)>& body)
+{
+    if (count <= 1) {
+        if (count == 1) {
+            body(0);
+        }
+        return;
+    }
+
+    // 下标按原子计数领取；汇合状态由共享指针持有，晚于返回才开始的辅助任务领不到下标，不会访问body
+    struct Join {
+        std::atomic<int> next{0};
+        std::mutex mutex;
+        std::condition_variable condition;
+        int finished = 0;
+    };
+    const std::shared_ptr<Join> join = std::make_shared<Join>();
+    const std::function<void(int)>* const function = &body;
+    auto work = [join, function, count]() {
+        for (int index = join->next++; index < count; index = join->next++) {
+            (*function)(index);
+            std::lock_guard<std::mutex> lock(join->mutex);
+            if (++join->finished == count) {
+                join->condition.notify_all();
+            }
+        }
+    };
+
+    const int helpers = std::min(count - 1, threadCount());
+    for (int i = 0; i < helpers; ++i) {
+        submit(work, TaskPriority::High);
+    }
+    work();
+
+    std::unique_lock<std::mutex> lock(join->mutex);
+    join->condition.wait(lock, [&join, count] { return join->finished == count; });
+}
+
+TaskPool& TaskPool::shared()
+{
+    static TaskPool pool(std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+    return pool;
+}
+
+int TaskPool::forEachBand(int height, int threadCount, int minRows, const std::function<void(int, int, int)>& body)
+{
+    const int bandCount = std::max(1, std::min(nestedThreadCount(threadCount), height / std::max(1, minRows)));
+    auto bandStart = [height, bandCount](int band) {
+        return static_cast<int>(static_cast<int64_t>(height) * band / bandCount);
+    };
+    shared().parallelFor(bandCount, [&](int band) {
+        body(band, bandStart(band), bandStart(band + 1));
+    });
+    return bandCount;
+}
+
+bool TaskPool::isWorkerThread()
+{
+    return currentPool != nullptr;
+}
+
+int TaskPool::nestedThreadCount(int threadCount)
+{
+    return isWorkerThread() ? 1 : threadCount;
+}
+
+bool TaskPool::takeTask(int index, Entry& entry)
+{
+    const int slots = slotCount.load(std::memory_order_acquire);
+    for (int priority = PriorityCount - 1; priority >= 0; --priority) {
+        // 自己的队列：从头部取，保持提交顺序
+        {
+            Worker& worker = *workers[index];
+            std::lock_guard<std::mutex> queueLock(worker.mutex);
+            std::deque<Entry>& queue = worker.queues[priority];
+            if (!queue.empty()) {
+                entry = std::move(queue.front());
+                queue.pop_front();
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        // 其他线程的队列：从尾部窃取
+        for (int offset = 1; offset < slots; ++offset) {
+            Worker& victim = *workers[(index + offset) % slots];
+            std::lock_guard<std::mutex> queueLock(victim.mutex);
+            std::deque<Entry>& queue = victim.queues[priority];
+            if (!queue.empty()) {
+                entry = std::move(queue.back());
+                queue.pop_back();
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TaskPool::run(int index)
+{
+    currentPool = this;
+    currentIndex = index;
+
+    for (;;) {
+        Entry entry;
+        if (takeTask(index, entry)) {
+            if (!entry.token.isCancelled()) {
+                entry.task();
+            }
+            // 先释放任务捕获的数据，再计为完成
+            entry = Entry();
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--unfinished == 0) {
+                idleCondition.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if (stopping || index >= activeCount) {
+            workers[index]->alive = false;
+            return;
+        }
+        wakeCondition.wait(lock, [this, index] {
+            return stopping || index >= activeCount || pending.load(std::memory_order_relaxed) > 0;
+        });
+    }
+}
@@ -0,0 +1,1095 @@
+#include "core/TemplateMatcher.h"
+#include "core/PixelKernels.h"
+#include "core/FftCorrelation.h"
+#include <QColor>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace TemplateMatcher {
+
+namespace {
+
+std::atomic<CorrelationBackend> activeCorrelationBackend{CorrelationBackend::Automatic};
+
+// 耗时估算系数（纳秒），由benchmarkCorrelation在x86-64(AVX2)上标定：
+// 空间域每个位置约 像素数*SpatialPixelCost + SpatialPositionCost（整行位置一起按模板行累加，含评分），
+// 频域约 FrequencyCost*P*log2(P)（P为变换点数，含评分扫描）
+constexpr double SpatialPixelCost = 0.033;
+constexpr double SpatialPositionCost = 30.0;
+constexpr double FrequencyCost = 16.0;
+
+// 频域按水平条带分块计算，每块变换点数上限（复数缓冲区约为16字节*点数）
+constexpr int FrequencyTilePoints = 1 << 20;
+
+// 两行灰度像素的点积（单行最大 255*255*width，宽度小于66051时uint32不会溢出）
+// 由PixelKernels按CPU特性分派到SSE4.1/AVX2实现
+inline uint32_t dotRow(const uint8_t* a, const uint8_t* b, int count)
+{
+    return PixelKernels::dotU8(a, b, count);
+}
+
+// 源图像窗口与模板的互相关 Σ s*t
+int64_t crossCorrelation(const PreparedSource& source, const PreparedTemplate& templ, int x, int y)
+{
+    const int w = templ.gray.width;
+    const int h = templ.gray.height;
+
+    // 纯色模板：Σ s*t = t * Σ s，直接由积分图得到
+    if (templ.isFlat()) {
+        if (templ.isMasked()) {
+            int64_t windowSum = 0;
+            for (const QRect& block : templ.blocks) {
+                windowSum += source.integral.rectSum(x + block.x(), y + block.y(), block.width(), block.height());
+            }
+            const PixelSpan& first = templ.spans.front();
+            return windowSum * templ.gray.row(first.row)[first.start];
+        }
+        return source.integral.rectSum(x, y, w, h) * templ.gray.pixels[0];
+    }
+
+    // 掩码模板在掩码外的灰度已置0，整行点积即为有效像素的 Σ s*t
+    int64_t cross = 0;
+    for (int ty = 0; ty < h; ++ty) {
+        cross += dotRow(source.gray.row(y + ty) + x, templ.gray.row(ty), w);
+    }
+    return cross;
+}
+
+// 频域每块覆盖positions的全部列，返回每块的位置行数（各块行数均衡）
+// 一块容纳不下两倍模板高度的窗口时分块不划算，返回0
+int frequencyBandRows(const PreparedTemplate& templ, const QRect& positions)
+{
+    const int h = templ.gray.height;
+    const int fastWidth = FftCorrelation::nextFastSize(positions.width() + templ.gray.width - 1);
+    int windowHeight = FrequencyTilePoints / fastWidth;
+    while (windowHeight > 0 && FftCorrelation::nextFastSize(windowHeight) != windowHeight) {
+        --windowHeight;
+    }
+    if (windowHeight < 2 * h - 1) {
+        return 0;
+    }
+
+    const int maxRows = windowHeight - h + 1;
+    const int bands = (positions.height() + maxRows - 1) / maxRows;
+    return (positions.height() + bands - 1) / bands;
+}
+
+// 逐行给出positions内所有位置的互相关，供按行扫描的搜索使用
+// 空间域：源图像各行打包成像素对后保存在模板高度行数的环形缓冲区中，每行只打包一次；
+// 同一输出行的所有位置一起按模板行累加（32位），在溢出之前并入64位结果
+// 频域：按需计算下一条带（frequencyBandRows行位置）的互相关，内存与位置总数无关；
+// 纯色模板由积分图逐位置得到
+class CrossCorrelationRows {
+public:
+    CrossCorrelationRows(const PreparedSource& source, const PreparedTemplate& templ, const QRect& positions)
+        : source(source)
+        , templ(templ)
+        , positions(positions)
+        , bandRows(usesFrequencyDomain(templ, positions) ? frequencyBandRows(templ, positions) : 0)
+        , bandTop(0)
+        , rowsPerFlush(1)
+        , nextSourceRow(0)
+    {
+        if (positions.isEmpty() || bandRows > 0) {
+            return;
+        }
+        cross.resize(positions.width());
+        if (templ.isFlat()) {
+            return;
+        }
+
+        const int w = templ.gray.width;
+        const int h = templ.gray.height;
+        templatePairs.resize(static_cast<size_t>(w) * h);
+        for (int ty = 0; ty < h; ++ty) {
+            PixelKernels::pairRowU8(templ.gray.row(ty), w, &templatePairs[static_cast<size_t>(ty) * w]);
+        }
+        sourcePairs.resize(static_cast<size_t>(positions.width() + w - 1) * h);
+        partial.resize(positions.width());
+        // 每个模板行最多贡献 255*255*w
+        rowsPerFlush = static_cast<int>(std::max<uint64_t>(1, std::numeric_limits<uint32_t>::max() / (65025ull * w)));
+        nextSourceRow = positions.top();
+    }
+
+    // positions内第y行的互相关，下标为x - positions.left()；y须递增
+    const int64_t* row(int y)
+    {
+        const int count = positions.width();
+        if (bandRows > 0) {
+            if (band.empty() || y >= bandTop + static_cast<int>(band.size() / count)) {
+                const int rows = std::min(bandRows, positions.bottom() - y + 1);
+                band = FftCorrelation::crossCorrelate(
+                    source.gray.row(y) + positions.left(), source.gray.width,
+                    count + templ.gray.width - 1, rows + templ.gray.height - 1,
+                    templ.gray.pixels.data(), templ.gray.width, templ.gray.width, templ.gray.height);
+                bandTop = y;
+            }
+            return band.data() + static_cast<size_t>(y - bandTop) * count;
+        }
+        if (templ.isFlat()) {
+            for (int i = 0; i < count; ++i) {
+                cross[i] = crossCorrelation(source, templ, positions.left() + i, y);
+            }
+            return cross.data();
+        }
+
+        const int w = templ.gray.width;
+        const int h = templ.gray.height;
+        const int span = count + w - 1;
+        for (int sourceRow = std::max(nextSourceRow, y); sourceRow < y + h; ++sourceRow) {
+            PixelKernels::pairRowU8(source.gray.row(sourceRow) + positions.left(), span,
+                                    &sourcePairs[static_cast<size_t>(sourceRow % h) * span]);
+        }
+        nextSourceRow = y + h;
+
+        std::fill(cross.begin(), cross.end(), 0);
+        std::fill(partial.begin(), partial.end(), 0u);
+        for (int ty = 0; ty < h; ++ty) {
+            PixelKernels::correlateRowU8(&sourcePairs[static_cast<size_t>((y + ty) % h) * span], count,
+                                         &templatePairs[static_cast<size_t>(ty) * w], w, partial.data());
+            if ((ty + 1) % rowsPerFlush == 0 || ty + 1 == h) {
+                for (int i = 0; i < count; ++i) {
+                    cross[i] += partial[i];
+                }
+                std::fill(partial.begin(), partial.end(), 0u);
+            }
+        }
+        return cross.data();
+    }
+
+private:
+    const PreparedSource& source;
+    const PreparedTemplate& templ;
+    const QRect positions;
+    const int bandRows;                   // 频域每块的位置行数，0表示使用空间域
+    std::vector<int64_t> band;            // 频域：从bandTop行开始的一块互相关
+    int bandTop;
+    std::vector<uint32_t> templatePairs;  // 模板各行的像素对
+    std::vector<uint32_t> sourcePairs;    // 环形缓冲区：源图像第r行保存在第r%h行
+    std::vector<uint32_t> partial;
+    std::vector<int64_t> cross;
+    int rowsPerFlush;
+    int nextSourceRow;
+};
+
+// 源图像窗口中参与评分像素的和与平方和（掩码模板按合并后的矩形块累加）
+void windowSums(const PreparedSource& source, const PreparedTemplate& templ, int x, int y,
+                int64_t& sum, int64_t& squaredSum)
+{
+    if (!templ.isMasked()) {
+        sum = source.integral.rectSum(x, y, templ.gray.width, templ.gray.height);
+        squaredSum = source.integral.rectSquaredSum(x, y, templ.gray.width, templ.gray.height);
+        return;
+    }
+
+    sum = 0;
+    squaredSum = 0;
+    for (const QRect& block : templ.blocks) {
+        sum += source.integral.rectSum(x + block.x(), y + block.y(), block.width(), block.height());
+        squaredSum += source.integral.rectSquaredSum(x + block.x(), y + block.y(), block.width(), block.height());
+    }
+}
+
+double scoreFromCross(const PreparedSource& source, const PreparedTemplate& templ,
+                      int x, int y, int64_t cross, MatchMethod method)
+{
+    const double n = static_cast<double>(templ.pixelCount());
+    int64_t windowSum = 0;
+    int64_t windowSquaredSum = 0;
+    windowSums(source, templ, x, y, windowSum, windowSquaredSum);
+
+    // 纯色模板的相关系数无定义，退化为平方差
+    if (method == MatchMethod::SquaredDifference || templ.isFlat()) {
+        const double ssd = static_cast<double>(windowSquaredSum - 2 * cross + templ.squaredSum);
+        return 1.0 - ssd / (n * 255.0 * 255.0);
+    }
+
+    const double windowVariance = static_cast<double>(windowSquaredSum)
+                                - static_cast<double>(windowSum) * windowSum / n;
+    if (windowVariance <= 1e-6) {
+        return 0.0;
+    }
+
+    const double numerator = static_cast<double>(cross) - static_cast<double>(windowSum) * templ.mean;
+    const double score = numerator / (std::sqrt(windowVariance) * templ.deviation);
+    return std::clamp(score, -1.0, 1.0);
+}
+
+// 计算模板灰度统计量
+void computeStatistics(PreparedTemplate& templ)
+{
+    templ.sum = 0;
+    templ.squaredSum = 0;
+    if (templ.isMasked()) {
+        for (const PixelSpan& span : templ.spans) {
+            const uint8_t* row = templ.gray.row(span.row) + span.start;
+            for (int i = 0; i < span.length; ++i) {
+                templ.sum += row[i];
+                templ.squaredSum += static_cast<int64_t>(row[i]) * row[i];
+            }
+        }
+    } else {
+        for (uint8_t value : templ.gray.pixels) {
+            templ.sum += value;
+            templ.squaredSum += static_cast<int64_t>(value) * value;
+        }
+    }
+    if (templ.pixelCount() == 0) {
+        return;
+    }
+
+    const int64_t n = templ.pixelCount();
+    templ.mean = static_cast<double>(templ.sum) / n;
+    // n*Σt² - (Σt)² 为精确整数，为0时模板为纯色
+    const int64_t varianceNumerator = n * templ.squaredSum - templ.sum * templ.sum;
+    templ.deviation = varianceNumerator > 0 ? std::sqrt(static_cast<double>(varianceNumerator) / n) : 0.0;
+}
+
+// 由模板alpha或外部掩码生成有效像素平面（1为有效），没有被排除的像素时返回空平面
+GrayPlane buildMaskPlane(const QImage& templateColor, const QImage& mask)
+{
+    GrayPlane plane;
+    if (mask.isNull() && !templateColor.hasAlphaChannel()) {
+        return plane;
+    }
+
+    plane.width = templateColor.width();
+    plane.height = templateColor.height();
+    plane.pixels.resize(static_cast<size_t>(plane.width) * plane.height);
+
+    bool excluded = false;
+    if (!mask.isNull()) {
+        const GrayPlane maskGray = toGrayPlane(mask.size() == templateColor.size()
+                                               ? mask
+                                               : mask.scaled(templateColor.size()));
+        for (size_t i = 0; i < plane.pixels.size(); ++i) {
+            plane.pixels[i] = maskGray.pixels[i] >= MaskThreshold ? 1 : 0;
+            excluded = excluded || plane.pixels[i] == 0;
+        }
+    } else {
+        for (int y = 0; y < plane.height; ++y) {
+            const QRgb* src = reinterpret_cast<const QRgb*>(templateColor.constScanLine(y));
+            uint8_t* dst = plane.pixels.data() + static_cast<size_t>(y) * plane.width;
+            for (int x = 0; x < plane.width; ++x) {
+                dst[x] = qAlpha(src[x]) >= MaskThreshold ? 1 : 0;
+                excluded = excluded || dst[x] == 0;
+            }
+        }
+    }
+
+    if (!excluded) {
+        return GrayPlane();
+    }
+    return plane;
+}
+
+// 掩码降采样：2x2块全部有效时粗层像素才有效，避免透明背景混入粗层灰度
+GrayPlane downsampleMask(const GrayPlane& mask)
+{
+    GrayPlane half;
+    half.width = mask.width / 2;
+    half.height = mask.height / 2;
+    half.pixels.resize(static_cast<size_t>(half.width) * half.height);
+    for (int y = 0; y < half.height; ++y) {
+        const uint8_t* upper = mask.row(2 * y);
+        const uint8_t* lower = mask.row(2 * y + 1);
+        uint8_t* dst = half.pixels.data() + static_cast<size_t>(y) * half.width;
+        for (int x = 0; x < half.width; ++x) {
+            dst[x] = upper[2 * x] & upper[2 * x + 1] & lower[2 * x] & lower[2 * x + 1];
+        }
+    }
+    return half;
+}
+
+// 将掩码平面压缩为有效像素段及合并后的矩形块，并计算模板统计量
+void applyMask(PreparedTemplate& templ, const GrayPlane& mask)
+{
+    templ.masked = !mask.isEmpty();
+    templ.spans.clear();
+    templ.blocks.clear();
+    templ.validPixelCount = 0;
+    if (templ.masked) {
+        // 上一行结束时仍可向下延伸的矩形块下标
+        std::vector<size_t> openBlocks;
+        std::vector<size_t> nextOpenBlocks;
+        for (int y = 0; y < mask.height; ++y) {
+            const uint8_t* row = mask.row(y);
+            nextOpenBlocks.clear();
+            int x = 0;
+            while (x < mask.width) {
+                if (!row[x]) {
+                    ++x;
+                    continue;
+                }
+                PixelSpan span;
+                span.row = y;
+                span.start = x;
+                while (x < mask.width && row[x]) {
+                    ++x;
+                }
+                span.length = x - span.start;
+                templ.validPixelCount += span.length;
+                templ.spans.push_back(span);
+
+                auto open = std::find_if(openBlocks.begin(), openBlocks.end(), [&](size_t index) {
+                    const QRect& block = templ.blocks[index];
+                    return block.x() == span.start && block.width() == span.length;
+                });
+                if (open != openBlocks.end()) {
+                    templ.blocks[*open].setBottom(y);
+                    nextOpenBlocks.push_back(*open);
+                } else {
+                    templ.blocks.emplace_back(span.start, y, span.length, 1);
+                    nextOpenBlocks.push_back(templ.blocks.size() - 1);
+                }
+            }
+            openBlocks.swap(nextOpenBlocks);
+        }
+
+        // 掩码外的灰度置0，互相关可按整行计算而无需逐像素判断
+        for (size_t i = 0; i < templ.gray.pixels.size(); ++i) {
+            if (!mask.pixels[i]) {
+                templ.gray.pixels[i] = 0;
+            }
+        }
+    }
+    computeStatistics(templ);
+}
+
+// 将原始分辨率的搜索区域映射到第level层，右下边界向上取整：
+// 降采样后峰值可能落在相邻的粗层位置上，区域贴着右下边缘时向下取整会把它排除在外
+QRect scaleSearchArea(const QRect& searchArea, int level)
+{
+    if (searchArea.isNull() || level == 0) {
+        return searchArea;
+    }
+    const int round = (1 << level) - 1;
+    return QRect(QPoint(searchArea.left() >> level, searchArea.top() >> level),
+                 QPoint((searchArea.right() + round) >> level, (searchArea.bottom() + round) >> level));
+}
+
+// 保留得分最高且相互距离大于minDistance的若干候选
+void insertCandidate(std::vector<MatchCandidate>& candidates, const MatchCandidate& candidate,
+                     size_t capacity, int minDistance)
+{
+    for (MatchCandidate& existing : candidates) {
+        if (std::abs(existing.location.x() - candidate.location.x()) <= minDistance &&
+            std::abs(existing.location.y() - candidate.location.y()) <= minDistance) {
+            if (candidate.score > existing.score) {
+                existing = candidate;
+                std::sort(candidates.begin(), candidates.end(),
+                          [](const MatchCandidate& a, const MatchCandidate& b) { return a.score > b.score; });
+            }
+            return;
+        }
+    }
+
+    if (candidates.size() >= capacity) {
+        if (candidate.score <= candidates.back().score) {
+            return;
+        }
+        candidates.pop_back();
+    }
+
+    auto position = std::upper_bound(candidates.begin(), candidates.end(), candidate,
+                                     [](const MatchCandidate& a, const MatchCandidate& b) { return a.score > b.score; });
+    candidates.insert(position, candidate);
+}
+
+// 在positions内逐行扫描，保留得分最高且相互距离大于minDistance的capacity个候选
+// capacity为1时即得分最高的位置，得分相同时取扫描顺序靠前者
+std::vector<MatchCandidate> collectCandidates(const PreparedSource& source, const PreparedTemplate& templ,
+                                              const QRect& positions, size_t capacity, int minDistance,
+                                              MatchMethod method)
+{
+    std::vector<MatchCandidate> candidates;
+    CrossCorrelationRows crossRows(source, templ, positions);
+    for (int y = positions.top(); y <= positions.bottom(); ++y) {
+        const int64_t* cross = crossRows.row(y);
+        for (int x = positions.left(); x <= positions.right(); ++x) {
+            const double score = scoreFromCross(source, templ, x, y, cross[x - positions.left()], method);
+            if (candidates.size() < capacity || score > candidates.back().score) {
+                MatchCandidate candidate;
+                candidate.location = QPoint(x, y);
+                candidate.score = score;
+                insertCandidate(candidates, candidate, capacity, minDistance);
+            }
+        }
+    }
+    return candidates;
+}
+
+// 原始分辨率上相互分开的峰值间距，避免候选集中在同一个峰值的相邻像素上
+int peakDistance(const PreparedTemplate& templ)
+{
+    return std::max(1, std::min(templ.gray.width, templ.gray.height) / 4);
+}
+
+// 原始分辨率上得分最高的若干候选（按得分从高到低）：金字塔可用时由最粗层候选逐层细化得到，否则全范围扫描
+std::vector<MatchCandidate> searchCandidates(const PreparedSource& source, const PreparedTemplate& templ,
+                                             const PyramidParameters& parameters,
+                                             const QRect& searchArea, MatchMethod method)
+{
+    const size_t capacity = static_cast<size_t>(std::max(1, parameters.candidateCount));
+    const QRect positions = validPositions(source, templ, searchArea);
+    const int levels = usablePyramidLevels(source, templ, parameters.levels);
+    if (positions.isEmpty()) {
+        return {};
+    }
+    if (levels == 0) {
+        return collectCandidates(source, templ, positions, capacity, peakDistance(templ), method);
+    }
+
+    // 最粗层：在整个（缩放后的）搜索区域内收集候选
+    const PreparedSource& coarseSource = source.level(levels);
+    const PreparedTemplate& coarseTemplate = templ.level(levels);
+    const QRect coarsePositions = validPositions(coarseSource, coarseTemplate, scaleSearchArea(searchArea, levels));
+    if (coarsePositions.isEmpty()) {
+        return {};
+    }
+    std::vector<MatchCandidate> candidates =
+        collectCandidates(coarseSource, coarseTemplate, coarsePositions, capacity, 1, method);
+
+    // 逐层细化：坐标放大2倍后在邻域内重新搜索
+    const int radius = std::max(1, parameters.refineRadius);
+    for (int level = levels - 1; level >= 0; --level) {
+        const PreparedSource& levelSource = source.level(level);
+        const PreparedTemplate& levelTemplate = templ.level(level);
+        const QRect levelPositions = validPositions(levelSource, levelTemplate, scaleSearchArea(searchArea, level));
+
+        for (MatchCandidate& candidate : candidates) {
+            const QPoint center = candidate.location * 2;
+            const QRect neighbourhood = QRect(center.x() - radius, center.y() - radius,
+                                              2 * radius + 2, 2 * radius + 2).intersected(levelPositions);
+            if (neighbourhood.isEmpty()) {
+                candidate.score = -1.0;
+                continue;
+            }
+            candidate = findBestMatch(levelSource, levelTemplate, neighbourhood, method);
+        }
+    }
+
+    // 细化中丢失的候选被移除；全部丢失时退回全分辨率搜索
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                    [](const MatchCandidate& candidate) { return candidate.score <= -1.0; }),
+                     candidates.end());
+    if (candidates.empty()) {
+        return collectCandidates(source, templ, positions, capacity, peakDistance(templ), method);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const MatchCandidate& a, const MatchCandidate& b) { return a.score > b.score; });
+    return candidates;
+}
+
+// 颜色差评分重排的邻域半径：灰度度量的峰值与颜色差评分的峰值在平滑区域可能相差一个像素
+constexpr int ColorRerankRadius = 1;
+
+// 在每个候选周围按原有的颜色差评分重新选择位置，与原有实现一样取颜色差评分最高者，得分相同时取扫描顺序靠前者
+// 返回结果的score为该位置的匹配度量得分，confidence为颜色差评分
+MatchCandidate rerankByColor(const PreparedSource& source, const PreparedTemplate& templ,
+                             const std::vector<MatchCandidate>& candidates, const QRect& positions,
+                             MatchMethod method)
+{
+    MatchCandidate best;
+    for (const MatchCandidate& candidate : candidates) {
+        const QRect neighbourhood = QRect(candidate.location.x() - ColorRerankRadius,
+                                          candidate.location.y() - ColorRerankRadius,
+                                          2 * ColorRerankRadius + 1, 2 * ColorRerankRadius + 1).intersected(positions);
+        for (int y = neighbourhood.top(); y <= neighbourhood.bottom(); ++y) {
+            for (int x = neighbourhood.left(); x <= neighbourhood.right(); ++x) {
+                const double confidence = colorScoreAt(source.color, templ, x, y);
+                const bool earlier = y < best.location.y() || (y == best.location.y() && x < best.location.x());
+                if (confidence > best.confidence || (confidence == best.confidence && earlier)) {
+                    best.location = QPoint(x, y);
+                    best.confidence = confidence;
+                }
+            }
+        }
+    }
+    if (best.confidence >= 0.0) {
+        best.score = scoreAt(source, templ, best.location.x(), best.location.y(), method);
+    }
+    return best;
+}
+
+}
+
+// ========== 互相关方式 ==========
+
+void setCorrelationBackend(CorrelationBackend backend)
+{
+    activeCorrelationBackend.store(backend);
+}
+
+CorrelationBackend correlationBackend()
+{
+    return activeCorrelationBackend.load();
+}
+
+bool usesFrequencyDomain(const PreparedTemplate& templ, const QRect& positions)
+{
+    // 纯色模板的互相关由积分图O(1)得到
+    if (!templ.isValid() || templ.isFlat() || positions.isEmpty()) {
+        return false;
+    }
+
+    const int windowWidth = positions.width() + templ.gray.width - 1;
+    const int bandRows = frequencyBandRows(templ, positions);
+    if (bandRows == 0) {
+        return false;
+    }
+
+    switch (correlationBackend()) {
+        case CorrelationBackend::Spatial: return false;
+        case CorrelationBackend::Frequency: return true;
+        default: break;
+    }
+
+    const double positionCount = static_cast<double>(positions.width()) * positions.height();
+    const double spatialCost = positionCount * (SpatialPixelCost * templ.gray.width * templ.gray.height
+                                                + SpatialPositionCost);
+    const int bands = (positions.height() + bandRows - 1) / bandRows;
+    const double frequencyCost = FrequencyCost * bands
+                               * FftCorrelation::transformCost(windowWidth, bandRows + templ.gray.height - 1);
+    return frequencyCost < spatialCost;
+}
+
+std::vector<CorrelationBenchmark> benchmarkCorrelation(const QSize& sourceSize, const std::vector<QSize>& templateSizes)
+{
+    std::vector<CorrelationBenchmark> results;
+    if (sourceSize.isEmpty()) {
+        return results;
+    }
+
+    // 固定种子的伪随机图像，保证两种方式输入一致且模板不是纯色
+    QImage sourceImage(sourceSize, QImage::Format_Grayscale8);
+    uint32_t seed = 2166136261u;
+    for (int y = 0; y < sourceImage.height(); ++y) {
+        uchar* line = sourceImage.scanLine(y);
+        for (int x = 0; x < sourceImage.width(); ++x) {
+            seed = seed * 1664525u + 1013904223u;
+            line[x] = static_cast<uchar>(seed >> 24);
+        }
+    }
+    const PreparedSource source = prepareSource(sourceImage);
+    const CorrelationBackend previous = correlationBackend();
+
+    for (const QSize& templateSize : templateSizes) {
+        if (templateSize.isEmpty() || templateSize.width() > sourceSize.width() ||
+            templateSize.height() > sourceSize.height()) {
+            continue;
+        }
+        const PreparedTemplate templ = prepareTemplate(sourceImage.copy(QRect(QPoint(0, 0), templateSize)));
+
+        CorrelationBenchmark result;
+        result.templateSize = templateSize;
+        setCorrelationBackend(CorrelationBackend::Automatic);
+        result.automaticUsesFrequency = usesFrequencyDomain(templ, validPositions(source, templ));
+
+        QElapsedTimer timer;
+        setCorrelationBackend(CorrelationBackend::Spatial);
+        timer.start();
+        findBestMatch(source, templ);
+        result.spatialMs = timer.nsecsElapsed() / 1e6;
+
+        setCorrelationBackend(CorrelationBackend::Frequency);
+        timer.restart();
+        findBestMatch(source, templ);
+        result.frequencyMs = timer.nsecsElapsed() / 1e6;
+
+        results.push_back(result);
+    }
+
+    setCorrelationBackend(previous);
+    return results;
+}
+
+// ========== 预处理 ==========
+
+QImage toColorBuffer(const QImage& image)
+{
+    if (image.format() == QImage::Format_ARGB32 || image.format() == QImage::Format_RGB32) {
+        return image;
+    }
+    return image.convertToFormat(QImage::Format_ARGB32);
+}
+
+GrayPlane toGrayPlane(const QImage& image)
+{
+    GrayPlane plane;
+    if (image.isNull()) {
+        return plane;
+    }
+
+    plane.width = image.width();
+    plane.height = image.height();
+    plane.pixels.resize(static_cast<size_t>(plane.width) * plane.height);
+
+    if (image.format() == QImage::Format_Grayscale8) {
+        for (int y = 0; y < plane.height; ++y) {
+            std::copy_n(image.constScanLine(y), plane.width, plane.pixels.data() + static_cast<size_t>(y) * plane.width);
+        }
+        return plane;
+    }
+
+    const QImage color = toColorBuffer(image);
+    for (int y = 0; y < plane.height; ++y) {
+        const QRgb* src = reinterpret_cast<const QRgb*>(color.constScanLine(y));
+        uint8_t* dst = plane.pixels.data() + static_cast<size_t>(y) * plane.width;
+        for (int x = 0; x < plane.width; ++x) {
+            dst[x] = static_cast<uint8_t>(qGray(src[x]));
+        }
+    }
+    return plane;
+}
+
+IntegralTables buildIntegral(const GrayPlane& plane)
+{
+    return IntegralImage::build(plane.pixels.data(), plane.width, plane.height, plane.width);
+}
+
+GrayPlane downsample(const GrayPlane& plane)
+{
+    GrayPlane half;
+    half.width = plane.width / 2;
+    half.height = plane.height / 2;
+    if (half.isEmpty()) {
+        half.width = 0;
+        half.height = 0;
+        return half;
+    }
+
+    half.pixels.resize(static_cast<size_t>(half.width) * half.height);
+    for (int y = 0; y < half.height; ++y) {
+        const uint8_t* upper = plane.row(2 * y);
+        const uint8_t* lower = plane.row(2 * y + 1);
+        uint8_t* dst = half.pixels.data() + static_cast<size_t>(y) * half.width;
+        for (int x = 0; x < half.width; ++x) {
+            dst[x] = static_cast<uint8_t>((upper[2 * x] + upper[2 * x + 1] + lower[2 * x] + lower[2 * x + 1] + 2) >> 2);
+        }
+    }
+    return half;
+}
+
+PreparedTemplate prepareTemplate(const QImage& templateImage, int pyramidLevels, const QImage& mask)
+{
+    PreparedTemplate templ;
+    if (templateImage.isNull()) {
+        return templ;
+    }
+
+    templ.color = toColorBuffer(templateImage);
+    templ.gray = toGrayPlane(templ.color);
+    GrayPlane levelMask = buildMaskPlane(templ.color, mask);
+    applyMask(templ, levelMask);
+    if (!templ.isValid()) {
+        return templ;
+    }
+
+    // 模板过小（或掩码模板在粗层上没有有效像素）时停止构建更粗的层
+    const GrayPlane* previous = &templ.gray;
+    for (int level = 1; level <= pyramidLevels; ++level) {
+        GrayPlane half = downsample(*previous);
+        if (half.width < MinPyramidTemplateSize || half.height < MinPyramidTemplateSize) {
+            break;
+        }
+        PreparedTemplate coarse;
+        coarse.gray = std::move(half);
+        if (templ.isMasked()) {
+            levelMask = downsampleMask(levelMask);
+        }
+        applyMask(coarse, levelMask);
+        if (!coarse.isValid()) {
+            break;
+        }
+        templ.pyramid.push_back(std::move(coarse));
+        previous = &templ.pyramid.back().gray;
+    }
+    return templ;
+}
+
+PreparedSource prepareSource(const QImage& sourceImage, int pyramidLevels)
+{
+    PreparedSource source;
+    if (sourceImage.isNull()) {
+        return source;
+    }
+
+    source.color = toColorBuffer(sourceImage);
+    source.gray = toGrayPlane(source.color);
+    source.integral = buildIntegral(source.gray);
+
+    const GrayPlane* previous = &source.gray;
+    for (int level = 1; level <= pyramidLevels; ++level) {
+        GrayPlane half = downsample(*previous);
+        if (half.isEmpty()) {
+            break;
+        }
+        PreparedSource coarse;
+        coarse.gray = std::move(half);
+        coarse.integral = buildIntegral(coarse.gray);
+        source.pyramid.push_back(std::move(coarse));
+        previous = &source.pyramid.back().gray;
+    }
+    return source;
+}
+
+int usablePyramidLevels(const PreparedSource& source, const PreparedTemplate& templ, int requestedLevels)
+{
+    int levels = std::min({requestedLevels,
+                           static_cast<int>(source.pyramid.size()),
+                           static_cast<int>(templ.pyramid.size())});
+    // 最粗层上模板仍需能放入源图像
+    while (levels > 0 && validPositions(source.level(levels), templ.level(levels)).isEmpty()) {
+        --levels;
+    }
+    return std::max(levels, 0);
+}
+
+// ========== 评分 ==========
+
+double scoreAt(const PreparedSource& source, const PreparedTemplate& templ,
+               int x, int y, MatchMethod method)
+{
+    if (!source.isValid() || !templ.isValid() || x < 0 || y < 0 ||
+        x + templ.gray.width > source.gray.width || y + templ.gray.height > source.gray.height) {
+        return -1.0;
+    }
+
+    return scoreFromCross(source, templ, x, y, crossCorrelation(source, templ, x, y), method);
+}
+
+double colorScoreAt(const QImage& source, const QImage& templ, int x, int y)
+{
+    return colorScore(source, QPoint(x, y), templ, QPoint(0, 0), templ.size());
+}
+
+double colorScoreAt(const QImage& source, const PreparedTemplate& templ, int x, int y)
+{
+    if (!templ.isMasked()) {
+        return colorScoreAt(source, templ.color, x, y);
+    }
+    if (!templ.isValid() || !source.rect().contains(QRect(QPoint(x, y), templ.color.size()))) {
+        return -1.0;
+    }
+
+    const QImage sourceColor = toColorBuffer(source);
+    uint64_t difference = 0;
+    for (const PixelSpan& span : templ.spans) {
+        const QRgb* a = reinterpret_cast<const QRgb*>(sourceColor.constScanLine(y + span.row)) + x + span.start;
+        const QRgb* b = reinterpret_cast<const QRgb*>(templ.color.constScanLine(span.row)) + span.start;
+        difference += PixelKernels::sadArgb(a, b, span.length);
+    }
+    return 1.0 - static_cast<double>(difference) / (3.0 * 255.0 * templ.validPixelCount);
+}
+
+double colorScore(const QImage& first, const QPoint& firstOrigin,
+                  const QImage& second, const QPoint& secondOrigin, const QSize& size)
+{
+    if (size.isEmpty() ||
+        !first.rect().contains(QRect(firstOrigin, size)) || !second.rect().contains(QRect(secondOrigin, size))) {
+        return -1.0;
+    }
+
+    const QImage firstColor = toColorBuffer(first);
+    const QImage secondColor = toColorBuffer(second);
+
+    uint64_t difference = 0;
+    for (int row = 0; row < size.height(); ++row) {
+        const QRgb* a = reinterpret_cast<const QRgb*>(firstColor.constScanLine(firstOrigin.y() + row)) + firstOrigin.x();
+        const QRgb* b = reinterpret_cast<const QRgb*>(secondColor.constScanLine(secondOrigin.y() + row)) + secondOrigin.x();
+        difference += PixelKernels::sadArgb(a, b, size.width());
+    }
+
+    const double totalPixels = static_cast<double>(size.width()) * size.height();
+    return 1.0 - static_cast<double>(difference) / (3.0 * 255.0 * totalPixels);
+}
+
+// ========== 搜索 ==========
+
+QRect validPositions(const PreparedSource& source, const PreparedTemplate& templ, const QRect& searchArea)
+{
+    if (!source.isValid() || !templ.isValid()) {
+        return QRect();
+    }
+
+    const int maxX = source.gray.width - templ.gray.width;
+    const int maxY = source.gray.height - templ.gray.height;
+    if (maxX < 0 || maxY < 0) {
+        return QRect();
+    }
+
+    QRect positions(0, 0, maxX + 1, maxY + 1);
+    if (!searchArea.isNull()) {
+        positions = positions.intersected(searchArea);
+    }
+    return positions;
+}
+
+MatchCandidate findBestMatch(const PreparedSource& source, const PreparedTemplate& templ,
+                             const QRect& searchArea, MatchMethod method)
+{
+    const QRect positions = validPositions(source, templ, searchArea);
+    if (positions.isEmpty()) {
+        return MatchCandidate();
+    }
+    return collectCandidates(source, templ, positions, 1, 1, method).front();
+}
+
+MatchCandidate findBestMatchPyramid(const PreparedSource& source, const PreparedTemplate& templ,
+                                    const PyramidParameters& parameters,
+                                    const QRect& searchArea, MatchMethod method)
+{
+    if (usablePyramidLevels(source, templ, parameters.levels) == 0) {
+        return findBestMatch(source, templ, searchArea, method);
+    }
+
+    MatchCandidate best;
+    for (const MatchCandidate& candidate : searchCandidates(source, templ, parameters, searchArea, method)) {
+        if (candidate.score > best.score) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+double overlapRatio(const QPoint& a, const QPoint& b, int width, int height)
+{
+    const int overlapWidth = width - std::abs(a.x() - b.x());
+    const int overlapHeight = height - std::abs(a.y() - b.y());
+    if (overlapWidth <= 0 || overlapHeight <= 0) {
+        return 0.0;
+    }
+
+    const double intersection = static_cast<double>(overlapWidth) * overlapHeight;
+    return intersection / (2.0 * width * height - intersection);
+}
+
+std::vector<MatchCandidate> findAllMatches(const PreparedSource& source, const PreparedTemplate& templ,
+                                           const MultiMatchParameters& parameters,
+                                           const QRect& searchArea, MatchMethod method)
+{
+    std::vector<MatchCandidate> kept;
+    const QRect positions = validPositions(source, templ, searchArea);
+    if (positions.isEmpty()) {
+        return kept;
+    }
+
+    const int w = templ.gray.width;
+    const int h = templ.gray.height;
+    const bool limited = parameters.maxResults > 0;
+    const size_t maxResults = static_cast<size_t>(std::max(0, parameters.maxResults));
+    std::vector<size_t> overlapping;
+
+    CrossCorrelationRows crossRows(source, templ, positions);
+
+    // 得分最低的已保留结果，达到上限后新结果须超过它才能替换它
+    const auto weakest = [&kept]() {
+        return std::min_element(kept.begin(), kept.end(),
+            [](const MatchCandidate& a, const MatchCandidate& b) { return a.score < b.score; });
+    };
+
+    for (int y = positions.top(); y <= positions.bottom(); ++y) {
+        // 已达上限且最低得分已是度量上限（两种度量均不超过1）时，后续位置不可能再替换任何结果
+        if (limited && kept.size() >= maxResults && weakest()->score >= 1.0) {
+            break;
+        }
+
+        const int64_t* cross = crossRows.row(y);
+        for (int x = positions.left(); x <= positions.right(); ++x) {
+            const double score = scoreFromCross(source, templ, x, y, cross[x - positions.left()], method);
+            if (score < parameters.candidateThreshold) {
+                continue;
+            }
+
+            // 与已保留结果比较：被得分更高的重叠结果抑制
+            const QPoint location(x, y);
+            overlapping.clear();
+            bool suppressed = false;
+            for (size_t i = 0; i < kept.size(); ++i) {
+                if (overlapRatio(kept[i].location, location, w, h) > parameters.maxOverlap) {
+                    if (kept[i].score >= score) {
+                        suppressed = true;
+                        break;
+                    }
+                    overlapping.push_back(i);
+                }
+            }
+            if (suppressed) {
+                continue;
+            }
+            // 已达上限时不重叠的结果只能替换得分最低者（得分相同时保留扫描顺序靠前者）
+            const bool replacesWeakest = limited && overlapping.empty() && kept.size() >= maxResults;
+            if (replacesWeakest && weakest()->score >= score) {
+                continue;
+            }
+
+            const double confidence = colorScoreAt(source.color, templ, x, y);
+            if (confidence < parameters.minConfidence) {
+                continue;
+            }
+
+            if (replacesWeakest) {
+                kept.erase(weakest());
+            }
+            for (auto it = overlapping.rbegin(); it != overlapping.rend(); ++it) {
+                kept.erase(kept.begin() + static_cast<std::ptrdiff_t>(*it));
+            }
+            MatchCandidate candidate;
+            candidate.location = location;
+            candidate.score = score;
+            candidate.confidence = confidence;
+            kept.push_back(candidate);
+        }
+    }
+
+    std::sort(kept.begin(), kept.end(),
+              [](const MatchCandidate& a, const MatchCandidate& b) { return a.score > b.score; });
+    return kept;
+}
+
+QRect positionsInRegion(const QRect& region, int templateWidth, int templateHeight)
+{
+    const int width = region.width() - templateWidth + 1;
+    const int height = region.height() - templateHeight + 1;
+    if (width <= 0 || height <= 0) {
+        return QRect();
+    }
+    return QRect(region.left(), region.top(), width, height);
+}
+
+MatchCandidate findBestMatchWithHint(const PreparedSource& source, const PreparedTemplate& templ,
+                                     const SearchHint& hint, const PyramidParameters& parameters,
+                                     const QRect& searchArea, MatchMethod method, bool* hintUsed)
+{
+    if (hintUsed) {
+        *hintUsed = false;
+    }
+
+    QRect positions = validPositions(source, templ, searchArea);
+    if (positions.isEmpty()) {
+        return MatchCandidate();
+    }
+
+    // 先在上次命中位置附近以原始分辨率搜索
+    if (hint.valid) {
+        const int radius = std::max(0, hint.radius);
+        const QRect neighbourhood = QRect(hint.location.x() - radius, hint.location.y() - radius,
+                                          2 * radius + 1, 2 * radius + 1).intersected(positions);
+        if (!neighbourhood.isEmpty()) {
+            const size_t capacity = static_cast<size_t>(std::max(1, parameters.candidateCount));
+            const MatchCandidate local = rerankByColor(
+                source, templ, collectCandidates(source, templ, neighbourhood, capacity, peakDistance(templ), method),
+                neighbourhood, method);
+            if (local.confidence >= hint.minConfidence) {
+                if (hintUsed) {
+                    *hintUsed = true;
+                }
+                return local;
+            }
+        }
+    }
+
+    // 提示失效，回退到整个搜索区域
+    return rerankByColor(source, templ, searchCandidates(source, templ, parameters, positions, method),
+                         positions, method);
+}
+
+
+MatchCandidate findBestMatchSequential(const QImage& source, const PreparedTemplate& templ,
+                                       double rejectConfidence, const QRect& searchArea,
+                                       SequentialStatistics* statistics)
+{
+    MatchCandidate best;
+    const int w = templ.color.width();
+    const int h = templ.color.height();
+    QRect positions = positionsInRegion(source.rect(), w, h);
+    if (!searchArea.isNull()) {
+        positions = positions.intersected(searchArea);
+    }
+    if (!templ.isValid() || positions.isEmpty()) {
+        return best;
+    }
+
+    // 普通模板每行即为一个像素段，与掩码模板共用同一扫描路径
+    std::vector<PixelSpan> rows;
+    if (!templ.isMasked()) {
+        rows.resize(h);
+        for (int row = 0; row < h; ++row) {
+            rows[row].row = row;
+            rows[row].length = w;
+        }
+    }
+    const std::vector<PixelSpan>& spans = templ.isMasked() ? templ.spans : rows;
+
+    const int64_t pixelCount = templ.pixelCount();
+    const double normalizer = 3.0 * 255.0 * static_cast<double>(pixelCount);
+
+    // 误差上限：部分误差超过该值的位置不可能成为结果
+    // 找到第一个完整比较的位置后收紧为"严格小于当前最优"，与全量搜索取最先出现的最优位置一致
+    uint64_t bound = std::numeric_limits<uint64_t>::max();
+    if (rejectConfidence > 0.0) {
+        bound = static_cast<uint64_t>(std::floor((1.0 - std::min(rejectConfidence, 1.0)) * normalizer));
+    }
+
+    std::vector<const uint32_t*> templateRows(h);
+    for (int row = 0; row < h; ++row) {
+        templateRows[row] = reinterpret_cast<const uint32_t*>(templ.color.constScanLine(row));
+    }
+
+    SequentialStatistics local;
+    bool perfect = false;
+    for (int y = positions.top(); y <= positions.bottom() && !perfect; ++y) {
+        for (int x = positions.left(); x <= positions.right(); ++x) {
+            uint64_t error = 0;
+            int64_t compared = 0;
+            bool rejected = false;
+            for (const PixelSpan& span : spans) {
+                error += PixelKernels::sadArgb(
+                    reinterpret_cast<const uint32_t*>(source.constScanLine(y + span.row)) + x + span.start,
+                    templateRows[span.row] + span.start, span.length);
+                compared += span.length;
+                if (error > bound) {
+                    rejected = true;
+                    break;
+                }
+            }
+
+            ++local.positions;
+            local.comparedPixels += compared;
+            if (rejected) {
+                ++local.rejectedPositions;
+                local.skippedPixels += pixelCount - compared;
+                continue;
+            }
+
+            best.location = QPoint(x, y);
+            best.score = 1.0 - static_cast<double>(error) / normalizer;
+            best.confidence = best.score;
+
+            // 完全一致时后续位置不可能更优，剩余位置全部跳过
+            if (error == 0) {
+                const int64_t remaining = static_cast<int64_t>(positions.bottom() - y) * positions.width()
+                                        + (positions.right() - x);
+                local.skippedPixels += remaining * pixelCount;
+                perfect = true;
+                break;
+            }
+            bound = error - 1;
+        }
+    }
+
+    if (statistics) {
+        statistics->positions += local.positions;
+        statistics->rejectedPositions += local.rejectedPositions;
+        statistics->comparedPixels += local.comparedPixels;
+        statistics->skippedPixels += local.skippedPixels;
+    }
+    return best;
+}
+
+}
@@ -0,0 +1,167 @@
+#include "core/TemplateSet.h"
+#include "core/TaskPool.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+TemplateSet::TemplateSet(const ImageProcessor::TemplateMatchOptions& options)
+    : matchOptions(options)
+    , threadCount(std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+// ========== 模板管理 ==========
+
+bool TemplateSet::addTemplate(const QString& templateId, const QImage& templateImage, const QRect& searchRegion,
+                              const QImage& mask)
+{
+    if (templateId.isEmpty() || !ImageProcessor::isValidImage(templateImage)) {
+        return false;
+    }
+
+    Entry entry;
+    entry.id = templateId;
+    entry.image = templateImage;
+    entry.mask = mask;
+    entry.prepared = ImageProcessor::prepareMatchTemplate(templateImage, mask, matchOptions);
+    entry.searchRegion = searchRegion;
+    if (!entry.prepared.isValid()) {
+        return false;
+    }
+
+    auto existing = std::find_if(entries.begin(), entries.end(),
+                                 [&templateId](const Entry& e) { return e.id == templateId; });
+    if (existing != entries.end()) {
+        *existing = std::move(entry);
+    } else {
+        entries.push_back(std::move(entry));
+    }
+    return true;
+}
+
+bool TemplateSet::removeTemplate(const QString& templateId)
+{
+    auto existing = std::find_if(entries.begin(), entries.end(),
+                                 [&templateId](const Entry& e) { return e.id == templateId; });
+    if (existing == entries.end()) {
+        return false;
+    }
+    entries.erase(existing);
+    return true;
+}
+
+void TemplateSet::clear()
+{
+    entries.clear();
+}
+
+bool TemplateSet::contains(const QString& templateId) const
+{
+    return std::any_of(entries.begin(), entries.end(),
+                       [&templateId](const Entry& e) { return e.id == templateId; });
+}
+
+QStringList TemplateSet::templateIds() const
+{
+    QStringList ids;
+    for (const Entry& entry : entries) {
+        ids.append(entry.id);
+    }
+    return ids;
+}
+
+void TemplateSet::clearHints()
+{
+    for (Entry& entry : entries) {
+        entry.hasLastHit = false;
+    }
+}
+
+// ========== 匹配配置 ==========
+
+void TemplateSet::setMatchOptions(const ImageProcessor::TemplateMatchOptions& options)
+{
+    const bool preparationChanged = options.pyramidLevels != matchOptions.pyramidLevels ||
+                                    options.useTemplateAlpha != matchOptions.useTemplateAlpha;
+    matchOptions = options;
+
+    if (preparationChanged) {
+        for (Entry& entry : entries) {
+            entry.prepared = ImageProcessor::prepareMatchTemplate(entry.image, entry.mask, matchOptions);
+        }
+    }
+}
+
+void TemplateSet::setThreadCount(int count)
+{
+    if (count > 0) {
+        threadCount = count;
+    }
+}
+
+// ========== 匹配 ==========
+
+TemplateMatcher::PreparedSource TemplateSet::prepareFrame(const QImage& frame) const
+{
+    return TemplateMatcher::prepareSource(frame, matchOptions.pyramidLevels);
+}
+
+std::vector<TemplateSet::MatchResult> TemplateSet::matchAll(const QImage& frame) const
+{
+    if (!ImageProcessor::isValidImage(frame) || entries.empty()) {
+        return {};
+    }
+    return matchAll(prepareFrame(frame));
+}
+
+std::vector<TemplateSet::MatchResult> TemplateSet::matchAll(const TemplateMatcher::PreparedSource& preparedFrame) const
+{
+    std::vector<MatchResult> results(entries.size());
+    if (!preparedFrame.isValid() || entries.empty()) {
+        return {};
+    }
+
+    // 工作线程按原子计数领取模板，避免按固定分块时大小模板耗时不均
+    std::atomic<size_t> nextIndex{0};
+    auto worker = [&]() {
+        for (size_t index = nextIndex++; index < entries.size(); index = nextIndex++) {
+            results[index] = matchEntry(entries[index], preparedFrame);
+        }
+    };
+
+    const size_t workerCount = std::min(static_cast<size_t>(TaskPool::nestedThreadCount(threadCount)), entries.size());
+    TaskPool::shared().parallelFor(static_cast<int>(workerCount), [&worker](int) { worker(); });
+
+    return results;
+}
+
+TemplateSet::MatchResult TemplateSet::matchEntry(const Entry& entry, const TemplateMatcher::PreparedSource& preparedFrame) const
+{
+    MatchResult result;
+    result.templateId = entry.id;
+
+    // 模板的搜索区域换算为左上角取值范围
+    const QRect frameRect = preparedFrame.color.rect();
+    const QRect region = entry.searchRegion.isNull() ? frameRect : entry.searchRegion.intersected(frameRect);
+    const QRect searchArea = TemplateMatcher::positionsInRegion(region, entry.prepared.gray.width, entry.prepared.gray.height);
+    if (searchArea.isEmpty()) {
+        entry.hasLastHit = false;
+        return result;
+    }
+
+    TemplateMatcher::SearchHint hint;
+    hint.valid = matchOptions.useLastHitHint && entry.hasLastHit;
+    hint.location = entry.lastHit;
+    hint.radius = matchOptions.hintRadius;
+    hint.minConfidence = matchOptions.minConfidence;
+
+    const TemplateMatcher::MatchCandidate candidate = TemplateMatcher::findBestMatchWithHint(
+        preparedFrame, entry.prepared, hint, matchOptions.pyramidParameters(), searchArea, matchOptions.method);
+
+    result.bestMatch = candidate.location;
+    result.confidence = candidate.confidence;
+
+    entry.hasLastHit = result.confidence >= matchOptions.minConfidence;
+    entry.lastHit = result.bestMatch;
+    return result;
+}
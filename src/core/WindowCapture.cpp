@@ -1,4 +1,5 @@
 #include "core/WindowCapture.h"
+#include "core/GdiCaptureSource.h"
 #include <QTimer>
 #include <QDebug>
 #include <QApplication>
@@ -7,7 +8,6 @@
 #ifdef _WIN32
 #include <dwmapi.h>
 #pragma comment(lib, "dwmapi.lib")
-#pragma comment(lib, "gdi32.lib")
 #pragma comment(lib, "user32.lib")
 #endif
 
@@ -52,23 +52,44 @@ bool WindowCapture::initializeCapture(HWND hwnd)
         return false;
     }
 
+    // 默认使用GDI后端，初始化后即可同步截图
+    captureSource = std::make_unique<GdiCaptureSource>(hwnd);
+    captureSource->start();
+
     setState(CaptureState::Stopped);
     return true;
 }
 
+void WindowCapture::setCaptureSource(std::unique_ptr<CaptureSource> source)
+{
+    if (currentState == CaptureState::Running) {
+        stopCapture();
+    }
+    if (captureSource) {
+        captureSource->stop();
+    }
+    captureSource = std::move(source);
+}
+
 bool WindowCapture::startCapture()
 {
     if (currentState != CaptureState::Stopped) {
         return false;
     }
 
-    if (!hasValidTarget()) {
-        handleError("No valid target window");
+    if (!captureSource) {
+        handleError("No capture source");
         return false;
     }
 
     setState(CaptureState::Starting);
 
+    if (!captureSource->isRunning() && !captureSource->start()) {
+        handleError(QString("Failed to start capture source: %1").arg(captureSource->name()));
+        setState(CaptureState::Stopped);
+        return false;
+    }
+
     if (asyncCaptureEnabled) {
         captureTimer->start(1000 / frameRate);
     }
@@ -100,6 +121,10 @@ void WindowCapture::cleanup()
     }
     
     cleanupGraphicsCapture();
+    if (captureSource) {
+        captureSource->stop();
+        captureSource.reset();
+    }
     targetWindow = nullptr;
     pixelBuffer.clear();
 }
@@ -124,13 +149,18 @@ void WindowCapture::setFrameRate(int fps)
     }
 }
 
-QImage WindowCapture::captureFrame()
+Frame WindowCapture::grabFrame()
 {
-    if (!hasValidTarget() || !isWindowValid()) {
-        return QImage();
+    if (!captureSource) {
+        return Frame();
     }
 
-    return captureWindowInternal();
+    return captureSource->nextFrame();
+}
+
+QImage WindowCapture::captureFrame()
+{
+    return grabFrame().image();
 }
 
 bool WindowCapture::captureFrameToBuffer(uint8_t* buffer, size_t bufferSize, int& width, int& height)
@@ -139,7 +169,7 @@ bool WindowCapture::captureFrameToBuffer(uint8_t* buffer, size_t bufferSize, int
         return false;
     }
 
-    QImage frame = captureFrame();
+    Frame frame = grabFrame();
     if (frame.isNull()) {
         return false;
     }
@@ -147,18 +177,46 @@ bool WindowCapture::captureFrameToBuffer(uint8_t* buffer, size_t bufferSize, int
     width = frame.width();
     height = frame.height();
     
-    size_t requiredSize = width * height * 4; // BGRA format
+    const size_t rowBytes = static_cast<size_t>(width) * 4; // BGRX format
+    size_t requiredSize = rowBytes * height;
     if (bufferSize < requiredSize) {
         return false;
     }
 
-    // 转换格式并复制到缓冲区
-    QImage convertedFrame = frame.convertToFormat(QImage::Format_ARGB32);
-    memcpy(buffer, convertedFrame.constBits(), requiredSize);
+    // 32位帧（BGRX/BGRA）逐行直接复制；其他格式（如回放灰度图像序列得到的Gray8帧）先转换为32位
+    QImage converted;
+    if (Frame::bytesPerPixel(frame.format()) != 4) {
+        converted = frame.image().convertToFormat(QImage::Format_RGB32);
+        if (converted.isNull()) {
+            return false;
+        }
+    }
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = converted.isNull() ? frame.constScanLine(y) : converted.constScanLine(y);
+        memcpy(buffer + y * rowBytes, row, rowBytes);
+    }
     
     return true;
 }
 
+FramePool::Statistics WindowCapture::getFramePoolStatistics() const
+{
+    return captureSource ? captureSource->framePoolStatistics() : FramePool::Statistics();
+}
+
+void WindowCapture::setFramePoolCapacity(int buffersPerClass)
+{
+    if (auto* gdiSource = dynamic_cast<GdiCaptureSource*>(captureSource.get())) {
+        gdiSource->setFramePoolCapacity(buffersPerClass);
+    }
+}
+
+int WindowCapture::getSurfaceRebuildCount() const
+{
+    auto* gdiSource = dynamic_cast<GdiCaptureSource*>(captureSource.get());
+    return gdiSource ? gdiSource->getSurfaceRebuildCount() : 0;
+}
+
 QSize WindowCapture::getWindowSize() const
 {
     if (!targetWindow) {
@@ -206,13 +264,14 @@ void WindowCapture::onCaptureTimer()
         return;
     }
 
-    QImage frame = captureFrame();
+    Frame frame = grabFrame();
     if (!frame.isNull()) {
-        emit frameReady(frame);
+        emit frameAvailable(frame);
+        emit frameReady(frame.image());
         
         // 如果需要，也发送原始数据
         const uint8_t* data = frame.constBits();
-        size_t dataSize = frame.sizeInBytes();
+        size_t dataSize = static_cast<size_t>(frame.stride()) * frame.height();
         emit frameCaptured(frame.width(), frame.height(), data, dataSize);
     }
 }
@@ -239,89 +298,6 @@ bool WindowCapture::createCaptureSession()
     return true;
 }
 
-QImage WindowCapture::captureWindowInternal()
-{
-    if (!targetWindow || !isWindowValid()) {
-        return QImage();
-    }
-
-#ifdef _WIN32
-    // 获取窗口大小
-    RECT windowRect;
-    if (!GetWindowRect(targetWindow, &windowRect)) {
-        return QImage();
-    }
-
-    int width = windowRect.right - windowRect.left;
-    int height = windowRect.bottom - windowRect.top;
-
-    if (width <= 0 || height <= 0) {
-        return QImage();
-    }
-
-    // 创建设备上下文
-    HDC windowDC = GetWindowDC(targetWindow);
-    if (!windowDC) {
-        return QImage();
-    }
-
-    HDC memoryDC = CreateCompatibleDC(windowDC);
-    if (!memoryDC) {
-        ReleaseDC(targetWindow, windowDC);
-        return QImage();
-    }
-
-    // 创建位图
-    HBITMAP bitmap = CreateCompatibleBitmap(windowDC, width, height);
-    if (!bitmap) {
-        DeleteDC(memoryDC);
-        ReleaseDC(targetWindow, windowDC);
-        return QImage();
-    }
-
-    // 选择位图到内存DC
-    HGDIOBJ oldBitmap = SelectObject(memoryDC, bitmap);
-
-    // 使用PrintWindow捕获窗口内容（比BitBlt更好，支持最小化窗口）
-    BOOL result = PrintWindow(targetWindow, memoryDC, PW_CLIENTONLY);
-    if (!result) {
-        // 如果PrintWindow失败，尝试使用BitBlt
-        result = BitBlt(memoryDC, 0, 0, width, height, windowDC, 0, 0, SRCCOPY);
-    }
-
-    QImage image;
-    if (result) {
-        // 获取位图数据
-        BITMAPINFO bmi = {};
-        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-        bmi.bmiHeader.biWidth = width;
-        bmi.bmiHeader.biHeight = -height; // 负值表示自顶向下
-        bmi.bmiHeader.biPlanes = 1;
-        bmi.bmiHeader.biBitCount = 32;
-        bmi.bmiHeader.biCompression = BI_RGB;
-
-        // 分配缓冲区
-        std::vector<uint8_t> buffer(width * height * 4);
-        
-        if (GetDIBits(memoryDC, bitmap, 0, height, buffer.data(), &bmi, DIB_RGB_COLORS)) {
-            // 创建QImage并转换格式
-            image = QImage(buffer.data(), width, height, QImage::Format_ARGB32);
-            image = image.rgbSwapped(); // BGR -> RGB
-        }
-    }
-
-    // 清理资源
-    SelectObject(memoryDC, oldBitmap);
-    DeleteObject(bitmap);
-    DeleteDC(memoryDC);
-    ReleaseDC(targetWindow, windowDC);
-
-    return image;
-#else
-    return QImage();
-#endif
-}
-
 void WindowCapture::setState(CaptureState newState)
 {
     if (currentState != newState) {
@@ -0,0 +1,86 @@
+#ifndef TESTSUPPORT_H
+#define TESTSUPPORT_H
+
+#include <QImage>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * TestSupport - 单元测试辅助
+ *
+ * 每个测试是一个只链接QtDemoCore的普通可执行文件，由CTest运行：
+ * 1. CHECK/CHECK_NEAR失败时打印文件、行号与表达式并计数，不中断后续检查
+ * 2. main以finish()的结果返回，有失败时CTest判定该测试失败
+ * 3. 测试图像由固定种子生成；需要截图风格输入的测试读取tests/data中的合成图像（路径为QTDEMO_TEST_DATA）
+ */
+namespace TestSupport {
+
+inline int& failureCount()
+{
+    static int count = 0;
+    return count;
+}
+
+inline void reportFailure(const char* file, int line, const char* expression)
+{
+    std::printf("FAIL %s:%d: %s\n", file, line, expression);
+    ++failureCount();
+}
+
+inline int finish(const char* testName)
+{
+    std::printf("%s: %s (%d failures)\n", testName, failureCount() == 0 ? "PASS" : "FAIL", failureCount());
+    return failureCount() == 0 ? 0 : 1;
+}
+
+// 线性同余伪随机数，各平台结果一致
+class Random {
+public:
+    explicit Random(uint32_t seed) : state(seed) {}
+    uint32_t next()
+    {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+    int range(int low, int high) { return low + static_cast<int>(next() % static_cast<uint32_t>(high - low + 1)); }
+
+private:
+    uint32_t state;
+};
+
+// 平滑渐变叠加随机噪声的彩色图像，任意两个位置的局部纹理都不相同
+inline QImage makeTexture(int width, int height, uint32_t seed)
+{
+    Random random(seed);
+    QImage image(width, height, QImage::Format_ARGB32);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const int base = static_cast<int>(128 + 60 * std::sin(x * 0.05) + 40 * std::cos(y * 0.07));
+            image.setPixel(x, y, qRgb(qBound(0, base + random.range(0, 29), 255),
+                                      (x * 3 + y) % 256,
+                                      random.range(0, 255)));
+        }
+    }
+    return image;
+}
+
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            TestSupport::reportFailure(__FILE__, __LINE__, #condition); \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        if (!(std::fabs(static_cast<double>(actual) - static_cast<double>(expected)) <= (tolerance))) { \
+            std::printf("     %s = %.9g, expected %.9g\n", #actual, static_cast<double>(actual), \
+                        static_cast<double>(expected)); \
+            TestSupport::reportFailure(__FILE__, __LINE__, #actual " ~= " #expected); \
+        } \
+    } while (0)
+
+#endif // TESTSUPPORT_H
@@ -0,0 +1,238 @@
+#include "TestSupport.h"
+#include "core/AnalysisScheduler.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 处理调度器线程的事件（结果回调），直到条件满足或超时
+template <typename Predicate>
+bool processEventsUntil(Predicate predicate, int timeoutMs = 5000)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!predicate()) {
+        if (timer.elapsed() > timeoutMs) {
+            return false;
+        }
+        QCoreApplication::processEvents();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+/**
+ * Gate - 阻塞分析函数，直到测试放行
+ *
+ * 分析函数进入时记录帧序号，测试据此确认哪一帧正在分析
+ */
+class Gate {
+public:
+    void enter(quint64 frameNumber)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        entered.push_back(frameNumber);
+        condition.notify_all();
+        condition.wait(lock, [this] { return opened; });
+    }
+
+    void open()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        opened = true;
+        condition.notify_all();
+    }
+
+    bool waitEntered(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return condition.wait_for(lock, std::chrono::seconds(5), [this, count] { return entered.size() >= count; });
+    }
+
+    std::vector<quint64> enteredFrames()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entered;
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<quint64> entered;
+    bool opened = false;
+};
+
+QImage solidFrame(QRgb color)
+{
+    QImage frame(64, 48, QImage::Format_RGB32);
+    frame.fill(color);
+    return frame;
+}
+
+// ========== 信箱 ==========
+
+// 分析阻塞期间提交的帧只保留最新的一帧，其余计为丢弃；结果在调度器线程中回调
+void testLatestFrameWins()
+{
+    ImageProcessor processor;
+    processor.setProcessingThreads(2);
+    AnalysisScheduler scheduler(&processor);
+
+    Gate gate;
+    std::vector<quint64> reported;
+    std::vector<QRgb> reportedColors;
+    std::vector<std::thread::id> reportThreads;
+    CHECK(scheduler.addJob("slow", [&](const QImage& frame, quint64 frameNumber) -> std::function<void()> {
+        gate.enter(frameNumber);
+        const QRgb color = frame.pixel(0, 0);
+        return [&, frameNumber, color]() {
+            reported.push_back(frameNumber);
+            reportedColors.push_back(color);
+            reportThreads.push_back(std::this_thread::get_id());
+        };
+    }));
+    CHECK(!scheduler.addJob("slow", [](const QImage&, quint64) { return std::function<void()>(); }));
+    CHECK(!scheduler.addJob("empty", AnalysisScheduler::Analysis()));
+
+    CHECK(scheduler.submitFrame(solidFrame(qRgb(1, 0, 0))) == 1);
+    CHECK(gate.waitEntered(1));
+    for (int i = 2; i <= 5; ++i) {
+        CHECK(scheduler.submitFrame(solidFrame(qRgb(i, 0, 0))) == static_cast<quint64>(i));
+    }
+
+    AnalysisScheduler::Statistics statistics = scheduler.statistics("slow");
+    CHECK(statistics.framesSubmitted == 5);
+    CHECK(statistics.framesDropped == 3);
+    CHECK(statistics.framesAnalyzed == 0);
+    CHECK(statistics.queueDepth == 1);
+    CHECK(statistics.inFlight == 1);
+    CHECK(scheduler.queueDepth() == 1);
+
+    // 放行前等待一段时间，第1帧的延迟至少为这段时间
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    gate.open();
+    CHECK(processEventsUntil([&] { return reported.size() >= 2; }));
+
+    // 只分析了第1帧与最新的第5帧
+    CHECK(gate.enteredFrames() == std::vector<quint64>({1, 5}));
+    CHECK(reported == std::vector<quint64>({1, 5}));
+    CHECK(reportedColors == std::vector<QRgb>({qRgb(1, 0, 0), qRgb(5, 0, 0)}));
+    for (std::thread::id id : reportThreads) {
+        CHECK(id == std::this_thread::get_id());
+    }
+
+    statistics = scheduler.statistics("slow");
+    CHECK(statistics.framesSubmitted == 5);
+    CHECK(statistics.framesAnalyzed == 2);
+    CHECK(statistics.framesDropped == 3);
+    CHECK(statistics.queueDepth == 0);
+    CHECK(statistics.inFlight == 0);
+    CHECK(statistics.maxLatencyMs >= 30.0);
+    CHECK(statistics.maxLatencyMs >= statistics.averageLatencyMs);
+    CHECK(scheduler.queueDepth() == 0);
+
+    // 空闲时提交的帧立即分析，不计丢弃
+    CHECK(scheduler.submitFrame(solidFrame(qRgb(6, 0, 0))) == 6);
+    CHECK(processEventsUntil([&] { return reported.size() >= 3; }));
+    CHECK(reported.back() == 6);
+    CHECK(scheduler.statistics("slow").framesDropped == 3);
+
+    scheduler.resetStatistics();
+    statistics = scheduler.statistics("slow");
+    CHECK(statistics.framesSubmitted == 0 && statistics.framesAnalyzed == 0 && statistics.framesDropped == 0);
+    CHECK(statistics.maxLatencyMs == 0.0);
+}
+
+// 多个任务的统计之和；移除任务后正在分析的帧不再回调
+void testTotalsAndRemoval()
+{
+    ImageProcessor processor;
+    processor.setProcessingThreads(2);
+    AnalysisScheduler scheduler(&processor);
+
+    Gate gate;
+    std::atomic<bool> slowFinished{false};
+    int slowReports = 0;
+    int fastReports = 0;
+    scheduler.addJob("slow", [&](const QImage&, quint64 frameNumber) -> std::function<void()> {
+        gate.enter(frameNumber);
+        slowFinished = true;
+        return [&slowReports]() { ++slowReports; };
+    });
+    scheduler.addJob("fast", [&](const QImage&, quint64) -> std::function<void()> {
+        return [&fastReports]() { ++fastReports; };
+    }, TaskPriority::High);
+    CHECK(scheduler.jobIds() == QStringList({"slow", "fast"}));
+
+    scheduler.submitFrame(solidFrame(qRgb(0, 0, 0)));
+    CHECK(gate.waitEntered(1));
+    CHECK(processEventsUntil([&] { return fastReports == 1; }));
+    scheduler.submitFrame(solidFrame(qRgb(0, 0, 0)));
+    scheduler.submitFrame(solidFrame(qRgb(0, 0, 0)));
+    CHECK(processEventsUntil([&] { return fastReports == 3; }));
+
+    const AnalysisScheduler::Statistics total = scheduler.totalStatistics();
+    CHECK(total.framesSubmitted == 6);
+    CHECK(total.framesAnalyzed == 3);
+    CHECK(total.framesDropped == 1);
+    CHECK(total.queueDepth == 1);
+    CHECK(total.inFlight == 1);
+
+    // 移除慢任务：信箱中的帧被丢弃，正在分析的帧结束后不回调
+    CHECK(scheduler.removeJob("slow"));
+    CHECK(!scheduler.removeJob("slow"));
+    CHECK(!scheduler.contains("slow"));
+    gate.open();
+    CHECK(processEventsUntil([&] { return slowFinished.load(); }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    QCoreApplication::processEvents();
+    CHECK(slowReports == 0);
+    CHECK(gate.enteredFrames().size() == 1);
+    CHECK(scheduler.queueDepth() == 0);
+}
+
+// ========== 模板任务 ==========
+
+// 任务持有添加时的模板集副本，之后修改原模板集不影响任务
+void testTemplateJobSnapshot()
+{
+    ImageProcessor processor;
+    AnalysisScheduler scheduler(&processor);
+
+    const QImage frame = TestSupport::makeTexture(160, 120, 3);
+    TemplateSet templates;
+    CHECK(templates.addTemplate("button", frame.copy(40, 30, 24, 16)));
+
+    std::vector<TemplateSet::MatchResult> results;
+    int reports = 0;
+    CHECK(scheduler.addTemplateJob("buttons", templates, [&](quint64, const std::vector<TemplateSet::MatchResult>& r) {
+        results = r;
+        ++reports;
+    }));
+    CHECK(templates.addTemplate("icon", frame.copy(100, 70, 20, 20)));
+
+    scheduler.submitFrame(frame);
+    CHECK(processEventsUntil([&] { return reports == 1; }));
+    CHECK(results.size() == 1);
+    if (results.size() == 1) {
+        CHECK(results[0].templateId == "button");
+        CHECK(results[0].bestMatch == QPoint(40, 30));
+    }
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    testLatestFrameWins();
+    testTotalsAndRemoval();
+    testTemplateJobSnapshot();
+    return TestSupport::finish("test_analysis_scheduler");
+}
@@ -0,0 +1,285 @@
+#include "TestSupport.h"
+#include "core/ColorSignature.h"
+#include "core/ImageProcessor.h"
+#include "core/TemplateMatcher.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+using Blobs = std::vector<ImageProcessor::ColorBlob>;
+
+void fillRect(QImage& image, const QRect& rect, QRgb color)
+{
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        for (int x = rect.left(); x <= rect.right(); ++x) {
+            image.setPixel(x, y, color);
+        }
+    }
+}
+
+std::vector<QRect> blobBounds(const Blobs& blobs)
+{
+    std::vector<QRect> bounds;
+    for (const ImageProcessor::ColorBlob& blob : blobs) {
+        bounds.push_back(blob.bounds);
+    }
+    return bounds;
+}
+
+// ========== 颜色区域 ==========
+
+// 饱和色块的色相：A≈350°，B≈5°，C≈30°，D≈200°；E饱和度低，F明度低
+const QRect BlobA(20, 20, 30, 20);
+const QRect BlobB(70, 20, 20, 20);
+const QRect BlobC(110, 20, 25, 20);
+const QRect BlobD(150, 20, 10, 10);
+
+QImage hueFrame()
+{
+    QImage frame(320, 200, QImage::Format_RGB32);
+    frame.fill(qRgb(40, 40, 40));
+    fillRect(frame, BlobA, qRgb(255, 0, 42));
+    fillRect(frame, BlobB, qRgb(255, 21, 0));
+    fillRect(frame, BlobC, qRgb(255, 128, 0));
+    fillRect(frame, BlobD, qRgb(0, 170, 255));
+    fillRect(frame, QRect(180, 20, 15, 15), qRgb(200, 180, 185));
+    fillRect(frame, QRect(200, 20, 15, 15), qRgb(60, 0, 5));
+    return frame;
+}
+
+// 跨越0度的色相区间：ColorRange::hsv的规范化与内核扇区区间的转换
+void testHueWrapAround()
+{
+    using ColorRange = ImageProcessor::ColorRange;
+    const ColorRange red = ColorRange::hsv(0, 15, 100, 100);
+    CHECK(red.space == ColorRange::Space::Hsv);
+    CHECK(red.hueLow == 345 && red.hueHigh == 15);
+    const ColorRange shifted = ColorRange::hsv(-10, 15);
+    CHECK(shifted.hueLow == 335 && shifted.hueHigh == 5);
+    const ColorRange all = ColorRange::hsv(0, 180);
+    CHECK(all.hueLow == 0 && all.hueHigh == 359);
+
+    const QImage frame = hueFrame();
+    ImageProcessor processor;
+    auto find = [&](ColorRange range) {
+        range.saturationLow = 100;
+        range.valueLow = 100;
+        Blobs blobs;
+        CHECK(processor.findColorBlobs(frame, range, blobs) == ImageProcessor::ProcessResult::Success);
+        return blobBounds(blobs);
+    };
+    auto manual = [](int hueLow, int hueHigh) {
+        ColorRange range;
+        range.space = ColorRange::Space::Hsv;
+        range.hueLow = hueLow;
+        range.hueHigh = hueHigh;
+        return range;
+    };
+
+    // 按像素数降序：A 600、C 500、B 400、D 100
+    CHECK(find(red) == std::vector<QRect>({BlobA, BlobB}));
+    CHECK(find(shifted) == std::vector<QRect>({BlobA, BlobB}));
+    CHECK(find(ColorRange::hsv(350, 3)) == std::vector<QRect>({BlobA}));
+    CHECK(find(ColorRange::hsv(370, 10)) == std::vector<QRect>({BlobB}));
+    CHECK(find(ColorRange::hsv(30, 10)) == std::vector<QRect>({BlobC}));
+    CHECK(find(all) == std::vector<QRect>({BlobA, BlobC, BlobB, BlobD}));
+    CHECK(find(manual(190, 40)) == std::vector<QRect>({BlobA, BlobC, BlobB, BlobD}));
+    CHECK(find(manual(40, 190)).empty());
+    CHECK(find(manual(355, 355)).empty());
+    // 直接设置的区间超出0-359时同样按360取模
+    CHECK(find(manual(-20, 20)) == std::vector<QRect>({BlobA, BlobB}));
+    CHECK(find(manual(330, 375)) == std::vector<QRect>({BlobA, BlobB}));
+
+    // 饱和度与明度下限为0时，灰色背景、低饱和与低明度的色块也在全色相范围内
+    Blobs blobs;
+    CHECK(processor.findColorBlobs(frame, ColorRange::hsv(0, 180), blobs) == ImageProcessor::ProcessResult::Success);
+    int pixels = 0;
+    for (const ImageProcessor::ColorBlob& blob : blobs) {
+        pixels += blob.pixelCount;
+    }
+    CHECK(pixels == frame.width() * frame.height());
+}
+
+// searchRect内的结果为帧坐标：与在裁剪出的图像上查找后平移一致，被裁剪的区域只计算区域内的部分
+void testSearchRectOffset()
+{
+    ImageProcessor processor;
+    const QImage frame = hueFrame();
+    ImageProcessor::ColorBlobOptions options;
+    options.searchRect = QRect(30, 25, 100, 100);
+    Blobs blobs;
+    CHECK(processor.findColorBlobs(frame, ImageProcessor::ColorRange::hsv(350, 3, 100, 100), blobs, options) ==
+          ImageProcessor::ProcessResult::Success);
+    CHECK(blobs.size() == 1);
+    if (blobs.size() == 1) {
+        CHECK(blobs[0].bounds == QRect(30, 25, 20, 15));
+        CHECK(blobs[0].pixelCount == 300);
+        CHECK_NEAR(blobs[0].centroid.x(), 39.5, 1e-9);
+        CHECK_NEAR(blobs[0].centroid.y(), 32.0, 1e-9);
+    }
+
+    // 纹理上的大量不规则区域
+    const QImage texture = TestSupport::makeTexture(260, 190, 8);
+    const ImageProcessor::ColorRange range = ImageProcessor::ColorRange::rgb(QColor(160, 128, 128), 60);
+    for (const QRect& searchRect : {QRect(37, 23, 150, 101), QRect(200, 150, 200, 200), QRect(0, 0, 260, 190)}) {
+        const QRect area = searchRect.intersected(texture.rect());
+        Blobs cropped;
+        CHECK(processor.findColorBlobs(texture.copy(area), range, cropped) == ImageProcessor::ProcessResult::Success);
+        CHECK(!cropped.empty());
+        for (int threads : {1, 4}) {
+            ImageProcessor::ColorBlobOptions searchOptions;
+            searchOptions.searchRect = searchRect;
+            searchOptions.threadCount = threads;
+            Blobs found;
+            CHECK(processor.findColorBlobs(texture, range, found, searchOptions) == ImageProcessor::ProcessResult::Success);
+            bool same = found.size() == cropped.size();
+            for (size_t i = 0; same && i < found.size(); ++i) {
+                same = found[i].bounds == cropped[i].bounds.translated(area.topLeft()) &&
+                       found[i].pixelCount == cropped[i].pixelCount &&
+                       std::abs(found[i].centroid.x() - (cropped[i].centroid.x() + area.x())) < 1e-9 &&
+                       std::abs(found[i].centroid.y() - (cropped[i].centroid.y() + area.y())) < 1e-9;
+            }
+            CHECK(same);
+        }
+    }
+
+    options.searchRect = QRect(400, 0, 10, 10);
+    CHECK(processor.findColorBlobs(frame, ImageProcessor::ColorRange::hsv(0, 180), blobs, options) ==
+          ImageProcessor::ProcessResult::InvalidInput);
+    CHECK(blobs.empty());
+}
+
+// ========== 多点颜色特征 ==========
+
+// 23x17的纹理块平铺成的帧：每个特征在整数个块的偏移处重复匹配
+QImage tiledFrame(int width, int height)
+{
+    const QImage block = TestSupport::makeTexture(23, 17, 9);
+    QImage frame(width, height, QImage::Format_RGB32);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            frame.setPixel(x, y, block.pixel(x % block.width(), y % block.height()));
+        }
+    }
+    return frame;
+}
+
+// 逐个锚点调用matchAt，光栅顺序
+std::vector<QPoint> bruteForceAnchors(const QImage& colorBuffer, const std::vector<ColorSignature::Point>& points,
+                                      const QRect& searchArea, int maxResults)
+{
+    std::vector<QPoint> anchors;
+    const QRect area = searchArea.intersected(colorBuffer.rect());
+    for (int y = area.top(); y <= area.bottom(); ++y) {
+        for (int x = area.left(); x <= area.right(); ++x) {
+            if (ColorSignature::matchAt(colorBuffer, points, QPoint(x, y))) {
+                anchors.emplace_back(x, y);
+            }
+        }
+    }
+    if (maxResults > 0 && anchors.size() > static_cast<size_t>(maxResults)) {
+        anchors.resize(maxResults);
+    }
+    return anchors;
+}
+
+// 使用索引的查找与不使用索引的逐位置扫描、逐锚点matchAt结果完全相同：
+// 偏移有正有负，搜索区域部分在帧外，maxResults截取光栅顺序的前几个
+void testSignatureIndexMatchesScan()
+{
+    const QImage frame = TemplateMatcher::toColorBuffer(tiledFrame(200, 150));
+    const ColorSignature::FrameIndex index = ColorSignature::buildIndex(frame, 1);
+    const ColorSignature::FrameIndex banded = ColorSignature::buildIndex(frame, 4);
+    CHECK(index.binStart == banded.binStart && index.positions == banded.positions);
+    const ColorSignature::FrameIndex noIndex;
+
+    TestSupport::Random random(13);
+    const std::vector<QRect> searchAreas = {frame.rect(), QRect(-10, -8, 90, 70), QRect(40, 30, 100, 80),
+                                            QRect(150, 100, 100, 100), QRect(60, 60, 1, 1)};
+    int indexedCases = 0;
+    int matchedCases = 0;
+    for (int s = 0; s < 40; ++s) {
+        const QPoint anchor(random.range(15, 184), random.range(15, 134));
+        std::vector<ColorSignature::Point> points(random.range(3, 8));
+        for (ColorSignature::Point& point : points) {
+            point.offset = QPoint(random.range(-15, 15), random.range(-15, 15));
+            point.color = frame.pixel(anchor + point.offset);
+            point.tolerance = random.range(0, 24);
+        }
+        // 部分特征中有一个点的颜色与期望相差较大，只在少数位置或不在任何位置匹配
+        if (s % 5 == 4) {
+            points.back().color ^= 0x00808080u;
+        }
+
+        for (const QRect& searchArea : searchAreas) {
+            const QRect area = searchArea.intersected(frame.rect());
+            size_t fewest = static_cast<size_t>(-1);
+            for (const ColorSignature::Point& point : points) {
+                fewest = std::min(fewest, index.candidateCount(point));
+            }
+            if (fewest > 0 && fewest < static_cast<size_t>(area.width()) * area.height()) {
+                ++indexedCases;
+            }
+            for (int maxResults : {0, 1, 3}) {
+                const std::vector<QPoint> expected = bruteForceAnchors(frame, points, searchArea, maxResults);
+                const std::vector<QPoint> indexed = ColorSignature::find(frame, index, points, searchArea, maxResults);
+                const std::vector<QPoint> scanned = ColorSignature::find(frame, noIndex, points, searchArea, maxResults);
+                CHECK(indexed == expected);
+                CHECK(scanned == expected);
+                if (indexed != expected) {
+                    std::printf("     signature %d, area %d,%d %dx%d, maxResults %d: %zu anchors, expected %zu\n", s,
+                                searchArea.x(), searchArea.y(), searchArea.width(), searchArea.height(), maxResults,
+                                indexed.size(), expected.size());
+                }
+                matchedCases += expected.size() > 1 ? 1 : 0;
+            }
+        }
+    }
+    // 大部分情况走索引路径，且有多个匹配
+    CHECK(indexedCases > 100);
+    CHECK(matchedCases > 100);
+}
+
+// ImageProcessor的封装：搜索区域、索引缓存与逐锚点结果一致
+void testFindColorSignature()
+{
+    ImageProcessor processor;
+    const QImage frame = tiledFrame(180, 120);
+    const QImage colorBuffer = TemplateMatcher::toColorBuffer(frame);
+    const QPoint anchor(50, 40);
+    std::vector<ColorSignature::Point> points;
+    for (const QPoint& offset : {QPoint(0, 0), QPoint(-7, -3), QPoint(11, -9), QPoint(-12, 8), QPoint(5, 14)}) {
+        points.push_back(ColorSignature::Point{offset, frame.pixel(anchor + offset), 4});
+    }
+
+    for (const QRect& searchRect : {QRect(), QRect(-20, -20, 100, 90), QRect(60, 30, 100, 80)}) {
+        const QRect area = searchRect.isNull() ? frame.rect() : searchRect;
+        for (int maxResults : {0, 2}) {
+            std::vector<QPoint> anchors;
+            CHECK(processor.findColorSignature(frame, points, anchors, searchRect, maxResults) ==
+                  ImageProcessor::ProcessResult::Success);
+            CHECK(anchors == bruteForceAnchors(colorBuffer, points, area, maxResults));
+        }
+    }
+    std::vector<QPoint> anchors;
+    CHECK(processor.findColorSignature(frame, points, anchors) == ImageProcessor::ProcessResult::Success);
+    CHECK(std::find(anchors.begin(), anchors.end(), anchor) != anchors.end());
+    CHECK(std::find(anchors.begin(), anchors.end(), anchor + QPoint(23, 17)) != anchors.end());
+    CHECK(processor.matchColorSignature(frame, points, anchor));
+    // 有点落在帧外的锚点不匹配
+    CHECK(!processor.matchColorSignature(frame, points, QPoint(5, 40)));
+    CHECK(processor.findColorSignature(frame, {}, anchors) == ImageProcessor::ProcessResult::InvalidInput);
+    CHECK(anchors.empty());
+}
+
+}
+
+int main()
+{
+    testHueWrapAround();
+    testSearchRectOffset();
+    testSignatureIndexMatchesScan();
+    testFindColorSignature();
+    return TestSupport::finish("test_color_search");
+}
@@ -0,0 +1,315 @@
+#include "TestSupport.h"
+#include "core/ConnectedComponents.h"
+#include "core/ImageProcessor.h"
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace {
+
+using ConnectedComponents::Component;
+using ConnectedComponents::Connectivity;
+using ConnectedComponents::Labeling;
+
+/**
+ * Mask - 测试用二值掩码
+ *
+ * 每行末尾留有填充字节（stride > width），填充中写入非0值，检查标记时不会越过行宽
+ */
+struct Mask {
+    int width = 0;
+    int height = 0;
+    size_t stride = 0;
+    std::vector<uint8_t> data;
+
+    Mask(int width, int height) : width(width), height(height), stride(static_cast<size_t>(width) + 5),
+                                  data(stride * height, 0)
+    {
+        for (int y = 0; y < height; ++y) {
+            std::fill_n(data.begin() + y * stride + width, 5, 0xFF);
+        }
+    }
+
+    bool at(int x, int y) const { return data[y * stride + x] != 0; }
+    void set(int x, int y) { data[y * stride + x] = 1; }
+    void fill(int x, int y, int w, int h)
+    {
+        for (int row = y; row < y + h; ++row) {
+            for (int column = x; column < x + w; ++column) {
+                set(column, row);
+            }
+        }
+    }
+};
+
+// 逐像素广度优先搜索，连通域按首个像素的光栅顺序编号
+std::vector<Component> referenceComponents(const Mask& mask, Connectivity connectivity)
+{
+    std::vector<int> labels(static_cast<size_t>(mask.width) * mask.height, -1);
+    std::vector<Component> components;
+    for (int y = 0; y < mask.height; ++y) {
+        for (int x = 0; x < mask.width; ++x) {
+            if (!mask.at(x, y) || labels[y * mask.width + x] >= 0) {
+                continue;
+            }
+            const int index = static_cast<int>(components.size());
+            Component component;
+            component.bounds = QRect(x, y, 1, 1);
+            std::deque<QPoint> queue{QPoint(x, y)};
+            labels[y * mask.width + x] = index;
+            while (!queue.empty()) {
+                const QPoint p = queue.front();
+                queue.pop_front();
+                component.bounds = component.bounds.united(QRect(p, QSize(1, 1)));
+                ++component.pixelCount;
+                component.sumX += p.x();
+                component.sumY += p.y();
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        if ((dx == 0 && dy == 0) || (connectivity == Connectivity::Four && dx != 0 && dy != 0)) {
+                            continue;
+                        }
+                        const int nx = p.x() + dx;
+                        const int ny = p.y() + dy;
+                        if (nx < 0 || ny < 0 || nx >= mask.width || ny >= mask.height || !mask.at(nx, ny) ||
+                            labels[ny * mask.width + nx] >= 0) {
+                            continue;
+                        }
+                        labels[ny * mask.width + nx] = index;
+                        queue.push_back(QPoint(nx, ny));
+                    }
+                }
+            }
+            components.push_back(component);
+        }
+    }
+    return components;
+}
+
+bool sameComponents(const std::vector<Component>& actual, const std::vector<Component>& expected)
+{
+    if (actual.size() != expected.size()) {
+        std::printf("     %zu components, expected %zu\n", actual.size(), expected.size());
+        return false;
+    }
+    for (size_t i = 0; i < actual.size(); ++i) {
+        if (actual[i].bounds != expected[i].bounds || actual[i].pixelCount != expected[i].pixelCount ||
+            actual[i].sumX != expected[i].sumX || actual[i].sumY != expected[i].sumY) {
+            std::printf("     component %zu differs\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 行程覆盖且只覆盖前景像素，每个行程的标签与其像素所属的连通域一致
+bool consistentRuns(const Mask& mask, const Labeling& labeling)
+{
+    int64_t pixels = 0;
+    for (size_t i = 0; i < labeling.runs.size(); ++i) {
+        const ConnectedComponents::Run& run = labeling.runs[i];
+        if (i > 0) {
+            const ConnectedComponents::Run& previous = labeling.runs[i - 1];
+            if (run.row < previous.row || (run.row == previous.row && run.start <= previous.end)) {
+                return false;
+            }
+        }
+        for (int x = run.start; x < run.end; ++x) {
+            if (!mask.at(x, run.row)) {
+                return false;
+            }
+        }
+        if (!labeling.components[labeling.runLabels[i]].bounds.contains(QRect(run.start, run.row, run.end - run.start, 1))) {
+            return false;
+        }
+        pixels += run.end - run.start;
+    }
+    int64_t expected = 0;
+    for (int y = 0; y < mask.height; ++y) {
+        for (int x = 0; x < mask.width; ++x) {
+            expected += mask.at(x, y) ? 1 : 0;
+        }
+    }
+    return pixels == expected && labeling.runLabels.size() == labeling.runs.size();
+}
+
+// 与逐像素参考结果一致，且与线程数无关
+void checkMask(const Mask& mask)
+{
+    for (Connectivity connectivity : {Connectivity::Four, Connectivity::Eight}) {
+        const std::vector<Component> expected = referenceComponents(mask, connectivity);
+        for (int threads : {1, 2, 4, 7}) {
+            const Labeling labeling = ConnectedComponents::label(mask.data.data(), mask.width, mask.height, mask.stride,
+                                                                 connectivity, threads);
+            CHECK(sameComponents(labeling.components, expected));
+            CHECK(consistentRuns(mask, labeling));
+        }
+    }
+}
+
+// ========== 连通域标记 ==========
+
+// 高256行、4线程时条带接缝位于第64、128、192行；各形状都跨越接缝
+void testSeamShapes()
+{
+    Mask mask(256, 256);
+    // 贯穿所有条带的竖条
+    mask.fill(5, 0, 3, 256);
+    // 对角线：8连通时为一个连通域，4连通时每个像素单独成为连通域
+    for (int y = 50; y <= 150; ++y) {
+        mask.set(y - 40, y);
+    }
+    // U形：两臂从第一个条带开始，直到最后一个条带才在底部相连，合并须回溯到更早的标签
+    mask.fill(130, 20, 3, 180);
+    mask.fill(170, 20, 3, 180);
+    mask.fill(130, 197, 43, 3);
+    // 接缝两侧只在对角相接的两块
+    mask.fill(190, 60, 10, 4);
+    mask.fill(200, 64, 10, 4);
+    // 紧贴接缝上下的水平线，彼此不相连
+    mask.fill(215, 127, 20, 1);
+    mask.fill(215, 129, 20, 1);
+    // 单像素与整行
+    mask.set(255, 191);
+    mask.fill(0, 255, 256, 1);
+    checkMask(mask);
+
+    const Labeling eight = ConnectedComponents::label(mask.data.data(), mask.width, mask.height, mask.stride,
+                                                      Connectivity::Eight, 4);
+    const Labeling four = ConnectedComponents::label(mask.data.data(), mask.width, mask.height, mask.stride,
+                                                     Connectivity::Four, 4);
+    // U形为同一个连通域
+    bool foundU = false;
+    for (const Component& component : eight.components) {
+        foundU = foundU || component.bounds == QRect(130, 20, 43, 180);
+    }
+    CHECK(foundU);
+    CHECK(four.components.size() > eight.components.size() + 90);
+}
+
+// 随机掩码：大量形状不规则的连通域跨越接缝
+void testRandomMasks()
+{
+    TestSupport::Random random(11);
+    for (int density : {30, 50, 62}) {
+        Mask mask(157, 301);
+        for (int y = 0; y < mask.height; ++y) {
+            for (int x = 0; x < mask.width; ++x) {
+                if (random.range(0, 99) < density) {
+                    mask.set(x, y);
+                }
+            }
+        }
+        checkMask(mask);
+    }
+}
+
+void testEdgeCases()
+{
+    Mask empty(64, 128);
+    checkMask(empty);
+    CHECK(ConnectedComponents::label(empty.data.data(), 64, 128, empty.stride).components.empty());
+
+    Mask full(37, 200);
+    full.fill(0, 0, 37, 200);
+    checkMask(full);
+
+    CHECK(ConnectedComponents::label(nullptr, 10, 10, 10).components.empty());
+    CHECK(ConnectedComponents::label(full.data.data(), 0, 10, full.stride).runs.empty());
+
+    Component component;
+    CHECK(component.centroid().isNull());
+    component.pixelCount = 4;
+    component.sumX = 10;
+    component.sumY = 6;
+    CHECK_NEAR(component.centroid().x(), 2.5, 1e-12);
+    CHECK_NEAR(component.centroid().y(), 1.5, 1e-12);
+}
+
+// ========== 矩形检测 ==========
+
+void fillRect(QImage& image, const QRect& rect, QRgb color)
+{
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        for (int x = rect.left(); x <= rect.right(); ++x) {
+            image.setPixel(x, y, color);
+        }
+    }
+}
+
+// 深色背景上的面板：实心面板、带嵌套子面板的面板、3像素宽的空心边框、过小的面板与非矩形
+void testDetectRectangles()
+{
+    QImage frame(640, 400, QImage::Format_RGB32);
+    frame.fill(qRgb(30, 30, 40));
+
+    const QRect solid(40, 30, 200, 120);
+    const QRect outer(300, 60, 280, 260);
+    const QRect nested(340, 120, 120, 80);
+    const QRect nestedInner(360, 140, 40, 30);
+    const QRect frameBorder(60, 200, 180, 150);
+    fillRect(frame, solid, qRgb(200, 200, 210));
+    fillRect(frame, outer, qRgb(120, 140, 160));
+    fillRect(frame, nested, qRgb(230, 220, 90));
+    fillRect(frame, nestedInner, qRgb(20, 60, 20));
+    for (int border = 0; border < 3; ++border) {
+        const QRect ring = frameBorder.adjusted(border, border, -border, -border);
+        fillRect(frame, QRect(ring.left(), ring.top(), ring.width(), 1), qRgb(250, 250, 250));
+        fillRect(frame, QRect(ring.left(), ring.bottom(), ring.width(), 1), qRgb(250, 250, 250));
+        fillRect(frame, QRect(ring.left(), ring.top(), 1, ring.height()), qRgb(250, 250, 250));
+        fillRect(frame, QRect(ring.right(), ring.top(), 1, ring.height()), qRgb(250, 250, 250));
+    }
+    fillRect(frame, QRect(260, 20, 8, 8), qRgb(250, 250, 250));
+    // 圆形不是矩形
+    for (int y = -25; y <= 25; ++y) {
+        for (int x = -25; x <= 25; ++x) {
+            if (x * x + y * y <= 625) {
+                frame.setPixel(590 + x, 350 + y, qRgb(250, 100, 100));
+            }
+        }
+    }
+
+    const std::vector<QRect> expected = {solid, outer, nested, nestedInner, frameBorder};
+    std::vector<QRect> sortedExpected = expected;
+    std::sort(sortedExpected.begin(), sortedExpected.end(), [](const QRect& a, const QRect& b) {
+        return a.top() != b.top() ? a.top() < b.top() : a.left() < b.left();
+    });
+
+    ImageProcessor processor;
+    for (int threads : {1, 4}) {
+        ImageProcessor::RectangleDetectionOptions options;
+        options.threadCount = threads;
+        std::vector<QRect> rectangles;
+        CHECK(processor.detectRectangles(frame, rectangles, options) == ImageProcessor::ProcessResult::Success);
+        CHECK(rectangles == sortedExpected);
+        if (rectangles != sortedExpected) {
+            for (const QRect& rect : rectangles) {
+                std::printf("     found %d,%d %dx%d\n", rect.x(), rect.y(), rect.width(), rect.height());
+            }
+        }
+    }
+
+    // 阈值模式：亮于阈值的区域为前景，嵌套的深色子面板在前景中形成孔洞，不影响外层面板
+    ImageProcessor::RectangleDetectionOptions threshold;
+    threshold.useEdges = false;
+    threshold.grayThreshold = 180;
+    threshold.threadCount = 4;
+    std::vector<QRect> bright;
+    CHECK(processor.detectRectangles(frame, bright, threshold) == ImageProcessor::ProcessResult::Success);
+    CHECK(bright == std::vector<QRect>({solid, nested, frameBorder}));
+
+    std::vector<QRect> none;
+    CHECK(processor.detectRectangles(QImage(), none) == ImageProcessor::ProcessResult::InvalidInput);
+    CHECK(none.empty());
+}
+
+}
+
+int main()
+{
+    testSeamShapes();
+    testRandomMasks();
+    testEdgeCases();
+    testDetectRectangles();
+    return TestSupport::finish("test_connected_components");
+}
@@ -0,0 +1,261 @@
+#include "TestSupport.h"
+#include "core/CaptureSource.h"
+#include "core/Frame.h"
+#include "core/FramePool.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+/**
+ * FakeCaptureSource - 测试用截图后端
+ *
+ * 与GDI后端相同：每帧从自己的帧缓冲池取缓冲区，直接写入像素后包装为Frame。
+ * 窗口尺寸可以在两帧之间改变，像素值为帧序号，便于检查帧内容没有被后续帧覆盖
+ */
+class FakeCaptureSource : public CaptureSource
+{
+public:
+    explicit FakeCaptureSource(const QSize& size) : size(size) {}
+
+    bool start() override { running = true; return true; }
+    void stop() override { running = false; }
+    bool isRunning() const override { return running; }
+
+    Frame nextFrame() override
+    {
+        if (!running) {
+            return Frame();
+        }
+        const qsizetype stride = static_cast<qsizetype>(size.width()) * 4;
+        std::shared_ptr<uint8_t> buffer = pool.acquire(static_cast<size_t>(stride) * size.height());
+        ++sequence;
+        for (int y = 0; y < size.height(); ++y) {
+            std::fill_n(reinterpret_cast<uint32_t*>(buffer.get() + y * stride), size.width(),
+                        static_cast<uint32_t>(sequence));
+        }
+        return Frame(std::move(buffer), size.width(), size.height(), stride, Frame::PixelFormat::Bgrx32,
+                     sequence, Frame::currentTimestamp());
+    }
+
+    QSize frameSize() const override { return size; }
+    Frame::PixelFormat pixelFormat() const override { return Frame::PixelFormat::Bgrx32; }
+    QString name() const override { return "Fake"; }
+    FramePool::Statistics framePoolStatistics() const override { return pool.statistics(); }
+
+    void resize(const QSize& newSize) { size = newSize; }
+
+private:
+    FramePool pool;
+    QSize size;
+    bool running = false;
+    quint64 sequence = 0;
+};
+
+// 帧的所有像素都等于其序号
+bool frameIntact(const Frame& frame)
+{
+    for (int y = 0; y < frame.height(); ++y) {
+        const uint32_t* row = reinterpret_cast<const uint32_t*>(frame.constScanLine(y));
+        for (int x = 0; x < frame.width(); ++x) {
+            if (row[x] != static_cast<uint32_t>(frame.sequence())) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ========== 尺寸档位 ==========
+
+void testSizeClasses()
+{
+    CHECK(FramePool::sizeClass(1) == FramePool::MinClassBytes);
+    CHECK(FramePool::sizeClass(FramePool::MinClassBytes) == FramePool::MinClassBytes);
+    CHECK(FramePool::sizeClass(4097) == 5120);
+    CHECK(FramePool::sizeClass(1920 * 1080 * 4) == 8 * 1024 * 1024);
+
+    // 档位不小于请求，浪费不超过25%，且随请求单调不减
+    size_t previous = 0;
+    for (size_t bytes = 4096; bytes < (static_cast<size_t>(64) << 20); bytes = bytes * 9 / 8 + 17) {
+        const size_t classBytes = FramePool::sizeClass(bytes);
+        CHECK(classBytes >= bytes);
+        CHECK(classBytes <= bytes + bytes / 4);
+        CHECK(classBytes >= previous);
+        previous = classBytes;
+    }
+}
+
+// ========== 复用与统计 ==========
+
+void testReuse()
+{
+    FramePool pool;
+    uint8_t* first = nullptr;
+    {
+        std::shared_ptr<uint8_t> buffer = pool.acquire(100000);
+        first = buffer.get();
+        CHECK(reinterpret_cast<uintptr_t>(first) % FramePool::Alignment == 0);
+        CHECK(pool.statistics().buffersInUse == 1);
+        CHECK(pool.statistics().bytesInUse == FramePool::sizeClass(100000));
+    }
+    CHECK(pool.statistics().freeBuffers == 1);
+    CHECK(pool.statistics().recycled == 1);
+
+    // 同一档位内略小的请求复用同一块缓冲区
+    std::shared_ptr<uint8_t> again = pool.acquire(99000);
+    CHECK(again.get() == first);
+    CHECK(pool.statistics().hits == 1);
+    CHECK(pool.statistics().misses == 1);
+
+    // 不同档位不复用
+    std::shared_ptr<uint8_t> other = pool.acquire(300000);
+    CHECK(other.get() != first);
+    CHECK(pool.statistics().misses == 2);
+
+    pool.resetStatistics();
+    CHECK(pool.statistics().hits == 0);
+    CHECK(pool.statistics().buffersInUse == 2);
+    CHECK(pool.acquire(0) == nullptr);
+}
+
+void testFreeLimit()
+{
+    FramePool pool(1);
+    {
+        std::vector<std::shared_ptr<uint8_t>> buffers;
+        for (int i = 0; i < 3; ++i) {
+            buffers.push_back(pool.acquire(50000));
+        }
+    }
+    FramePool::Statistics statistics = pool.statistics();
+    CHECK(statistics.recycled == 1);
+    CHECK(statistics.discarded == 2);
+    CHECK(statistics.freeBuffers == 1);
+    CHECK(statistics.buffersInUse == 0);
+
+    pool.setMaxFreePerClass(0);
+    CHECK(pool.statistics().freeBuffers == 0);
+    CHECK(pool.statistics().freeBytes == 0);
+}
+
+// 池销毁后仍在使用的缓冲区可以继续读写，释放时直接归还给系统
+void testBufferOutlivesPool()
+{
+    std::shared_ptr<uint8_t> buffer;
+    {
+        FramePool pool;
+        buffer = pool.acquire(8192);
+    }
+    std::fill_n(buffer.get(), 8192, static_cast<uint8_t>(0x5A));
+    CHECK(buffer.get()[8191] == 0x5A);
+    buffer.reset();
+}
+
+// ========== 截图循环 ==========
+
+// 分析端保留上一帧时，稳定后每帧都由空闲缓冲区满足；尺寸在同一档位内变化时不重新分配
+void testCaptureLoop()
+{
+    FakeCaptureSource source(QSize(640, 480));
+    CHECK(source.start());
+
+    Frame previous;
+    for (int i = 0; i < 100; ++i) {
+        Frame frame = source.nextFrame();
+        CHECK(!frame.isNull());
+        CHECK(frame.format() == Frame::PixelFormat::Bgrx32);
+        if (!previous.isNull()) {
+            CHECK(frameIntact(previous));
+        }
+        previous = frame;
+    }
+    FramePool::Statistics statistics = source.framePoolStatistics();
+    CHECK(statistics.misses == 2);
+    CHECK(statistics.hits == 98);
+    CHECK(statistics.buffersInUse == 1);
+
+    source.resize(QSize(636, 478));
+    for (int i = 0; i < 10; ++i) {
+        previous = source.nextFrame();
+    }
+    CHECK(source.framePoolStatistics().misses == 2);
+    CHECK(previous.size() == QSize(636, 478));
+
+    // image()引用帧缓冲区：帧释放后缓冲区仍被QImage持有，QImage释放后才归还
+    QImage view = previous.image();
+    previous = Frame();
+    CHECK(source.framePoolStatistics().buffersInUse == 1);
+    CHECK(view.pixel(10, 10) == (0xFF000000u | static_cast<uint32_t>(110)));
+    view = QImage();
+    CHECK(source.framePoolStatistics().buffersInUse == 0);
+
+    source.stop();
+    CHECK(source.nextFrame().isNull());
+}
+
+// 截图线程取帧、分析线程读取并释放：缓冲区在两个线程之间归还，不会被覆盖
+void testCrossThreadRelease()
+{
+    FakeCaptureSource source(QSize(320, 240));
+    source.start();
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<Frame> queue;
+    bool finished = false;
+    int intactFrames = 0;
+
+    std::thread analysis([&]() {
+        for (;;) {
+            Frame frame;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [&]() { return finished || !queue.empty(); });
+                if (queue.empty()) {
+                    return;
+                }
+                frame = std::move(queue.front());
+                queue.pop_front();
+            }
+            if (frameIntact(frame)) {
+                ++intactFrames;
+            }
+        }
+    });
+
+    const int frames = 200;
+    for (int i = 0; i < frames; ++i) {
+        Frame frame = source.nextFrame();
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(frame));
+        ready.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+        ready.notify_one();
+    }
+    analysis.join();
+
+    const FramePool::Statistics statistics = source.framePoolStatistics();
+    CHECK(intactFrames == frames);
+    CHECK(statistics.buffersInUse == 0);
+    CHECK(statistics.hits + statistics.misses == static_cast<uint64_t>(frames));
+    CHECK(statistics.recycled + statistics.discarded == static_cast<uint64_t>(frames));
+}
+
+}
+
+int main()
+{
+    testSizeClasses();
+    testReuse();
+    testFreeLimit();
+    testBufferOutlivesPool();
+    testCaptureLoop();
+    testCrossThreadRelease();
+    return TestSupport::finish("test_frame_pool");
+}
@@ -0,0 +1,577 @@
+#include "TestSupport.h"
+#include "core/FilterPipeline.h"
+#include "core/ImageFilters.h"
+#include "core/ImageProcessor.h"
+#include "core/PixelKernels.h"
+#include "core/TemplateMatcher.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// 逐通道读取ARGB32像素
+int channel(QRgb pixel, int shift)
+{
+    return static_cast<int>((pixel >> shift) & 0xFF);
+}
+
+// 与gaussianBlur相同的定点运算：先水平后垂直，每次一维卷积后四舍五入到8位，边界像素向外延伸
+QImage referenceGaussian(const QImage& image, const std::vector<int16_t>& kernel)
+{
+    const int radius = static_cast<int>(kernel.size()) / 2;
+    const int w = image.width();
+    const int h = image.height();
+    const int one = 1 << PixelKernels::ConvolutionShift;
+    auto convolve = [&](auto sample, int count, int index) {
+        uint32_t result = 0;
+        for (int shift = 0; shift <= 24; shift += 8) {
+            int64_t sum = 0;
+            for (int k = -radius; k <= radius; ++k) {
+                sum += static_cast<int64_t>(kernel[k + radius]) * channel(sample(std::clamp(index + k, 0, count - 1)), shift);
+            }
+            result |= static_cast<uint32_t>(std::clamp(static_cast<int>((sum + one / 2) >> PixelKernels::ConvolutionShift),
+                                                       0, 255)) << shift;
+        }
+        return result;
+    };
+
+    std::vector<uint32_t> horizontal(static_cast<size_t>(w) * h);
+    for (int y = 0; y < h; ++y) {
+        const QRgb* row = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+        for (int x = 0; x < w; ++x) {
+            horizontal[static_cast<size_t>(y) * w + x] = convolve([row](int i) { return row[i]; }, w, x);
+        }
+    }
+    QImage result(w, h, image.format());
+    for (int x = 0; x < w; ++x) {
+        for (int y = 0; y < h; ++y) {
+            reinterpret_cast<QRgb*>(result.scanLine(y))[x] =
+                convolve([&horizontal, w, x](int i) { return horizontal[static_cast<size_t>(i) * w + x]; }, h, y);
+        }
+    }
+    return result;
+}
+
+// 浮点高斯模糊（sigma与gaussianBlur的默认值相同），用于检查定点误差与盒式近似误差
+QImage floatGaussian(const QImage& image, int radius, double sigma)
+{
+    std::vector<double> weights(2 * radius + 1);
+    double total = 0.0;
+    for (int k = -radius; k <= radius; ++k) {
+        weights[k + radius] = std::exp(-0.5 * k * k / (sigma * sigma));
+        total += weights[k + radius];
+    }
+    for (double& weight : weights) {
+        weight /= total;
+    }
+
+    const int w = image.width();
+    const int h = image.height();
+    std::vector<double> horizontal(static_cast<size_t>(w) * h * 3);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            for (int c = 0; c < 3; ++c) {
+                double sum = 0.0;
+                for (int k = -radius; k <= radius; ++k) {
+                    sum += weights[k + radius] * channel(image.pixel(std::clamp(x + k, 0, w - 1), y), 16 - 8 * c);
+                }
+                horizontal[(static_cast<size_t>(y) * w + x) * 3 + c] = sum;
+            }
+        }
+    }
+    QImage result(w, h, QImage::Format_RGB32);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            int rgb[3];
+            for (int c = 0; c < 3; ++c) {
+                double sum = 0.0;
+                for (int k = -radius; k <= radius; ++k) {
+                    sum += weights[k + radius] * horizontal[(static_cast<size_t>(std::clamp(y + k, 0, h - 1)) * w + x) * 3 + c];
+                }
+                rgb[c] = std::clamp(static_cast<int>(std::lround(sum)), 0, 255);
+            }
+            result.setPixel(x, y, qRgb(rgb[0], rgb[1], rgb[2]));
+        }
+    }
+    return result;
+}
+
+// 各颜色通道（不含alpha）的最大差值
+int maxColorDifference(const QImage& first, const QImage& second)
+{
+    int difference = 0;
+    for (int y = 0; y < first.height(); ++y) {
+        for (int x = 0; x < first.width(); ++x) {
+            for (int shift = 0; shift <= 16; shift += 8) {
+                difference = std::max(difference, std::abs(channel(first.pixel(x, y), shift) -
+                                                           channel(second.pixel(x, y), shift)));
+            }
+        }
+    }
+    return difference;
+}
+
+bool sameImage(const QImage& first, const QImage& second)
+{
+    if (first.size() != second.size() || first.format() != second.format()) {
+        return false;
+    }
+    for (int y = 0; y < first.height(); ++y) {
+        if (!std::equal(first.constScanLine(y), first.constScanLine(y) + first.width() * 4, second.constScanLine(y))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 尺寸、格式与每行的像素字节都相同（不比较行尾的填充）
+bool sameBytes(const QImage& first, const QImage& second)
+{
+    if (first.size() != second.size() || first.format() != second.format()) {
+        return false;
+    }
+    const size_t rowBytes = static_cast<size_t>(first.width()) * (first.depth() / 8);
+    for (int y = 0; y < first.height(); ++y) {
+        if (std::memcmp(first.constScanLine(y), second.constScanLine(y), rowBytes) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 带alpha变化的纹理，检查各操作对alpha的处理
+QImage translucentTexture(int width, int height, uint32_t seed)
+{
+    QImage image = TestSupport::makeTexture(width, height, seed);
+    for (int y = 0; y < height; ++y) {
+        QRgb* row = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            row[x] = (row[x] & 0x00FFFFFFu) | (static_cast<uint32_t>((x * 7 + y * 13) % 256) << 24);
+        }
+    }
+    return image;
+}
+
+// ========== 高斯核 ==========
+
+void testGaussianKernel()
+{
+    for (int radius : {1, 2, 5, 12, 24}) {
+        const std::vector<int16_t> kernel = ImageFilters::gaussianKernel(radius);
+        CHECK(kernel.size() == static_cast<size_t>(2 * radius + 1));
+        int sum = 0;
+        for (int16_t weight : kernel) {
+            sum += weight;
+        }
+        CHECK(sum == 1 << PixelKernels::ConvolutionShift);
+        // 对称且从中心向两侧不增
+        for (int k = 1; k <= radius; ++k) {
+            CHECK(kernel[radius - k] == kernel[radius + k]);
+            CHECK(kernel[radius + k] <= kernel[radius + k - 1]);
+        }
+    }
+}
+
+// ========== 高斯模糊 ==========
+
+// 与逐像素定点参考实现完全一致，且与SIMD后端和线程数无关
+void testGaussianBlurExact()
+{
+    QImage image = TestSupport::makeTexture(97, 61, 31);
+    // alpha通道同样参与卷积
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            const QRgb pixel = image.pixel(x, y);
+            image.setPixel(x, y, qRgba(qRed(pixel), qGreen(pixel), qBlue(pixel), (x * 5 + y * 3) % 256));
+        }
+    }
+
+    for (int radius : {1, 3, 8}) {
+        const QImage expected = referenceGaussian(image, ImageFilters::gaussianKernel(radius));
+        for (PixelKernels::Backend backend : {PixelKernels::Backend::Scalar, PixelKernels::Backend::SSE41,
+                                              PixelKernels::Backend::AVX2}) {
+            if (!PixelKernels::setBackend(backend)) {
+                continue;
+            }
+            for (int threads : {1, 3}) {
+                const QImage blurred = ImageFilters::gaussianBlur(image, radius, threads);
+                CHECK(blurred.format() == QImage::Format_ARGB32);
+                CHECK(sameImage(blurred, expected));
+            }
+        }
+        PixelKernels::setBackend(PixelKernels::detectBackend());
+
+        // 定点权重与浮点高斯相差不超过舍入误差
+        const QImage reference = floatGaussian(image, radius, 0.3 * (radius - 1) + 0.8);
+        CHECK(maxColorDifference(ImageFilters::gaussianBlur(image, radius), reference) <= 1);
+    }
+}
+
+// 纯色图像不变；radius≤0返回原图；灰度输入得到32位结果
+void testGaussianBlurEdgeCases()
+{
+    QImage flat(40, 30, QImage::Format_RGB32);
+    flat.fill(qRgb(12, 200, 77));
+    for (int radius : {2, 30}) {
+        const QImage blurred = ImageFilters::gaussianBlur(flat, radius, 2);
+        CHECK(maxColorDifference(blurred, flat) == 0);
+    }
+
+    const QImage texture = TestSupport::makeTexture(20, 20, 2);
+    CHECK(sameImage(ImageFilters::gaussianBlur(texture, 0), texture));
+    CHECK(ImageFilters::gaussianBlur(QImage(), 3).isNull());
+
+    QImage gray(16, 16, QImage::Format_Grayscale8);
+    for (int y = 0; y < gray.height(); ++y) {
+        for (int x = 0; x < gray.width(); ++x) {
+            gray.scanLine(y)[x] = static_cast<uchar>(x * 16);
+        }
+    }
+    const QImage blurred = ImageFilters::gaussianBlur(gray, 2);
+    CHECK(blurred.format() == QImage::Format_ARGB32 || blurred.format() == QImage::Format_RGB32);
+    CHECK(qRed(blurred.pixel(8, 8)) == qGreen(blurred.pixel(8, 8)));
+}
+
+// 调用方持有的转置缓冲跨帧复用：缓冲中上一帧（尺寸可能不同）的数据不影响结果
+void testBlurTransposeBuffer()
+{
+    std::vector<uint32_t> buffer;
+    for (const QSize& size : {QSize(97, 61), QSize(40, 150), QSize(97, 61)}) {
+        const QImage image = translucentTexture(size.width(), size.height(), 26);
+        for (int radius : {3, ImageFilters::BoxApproximationRadius + 4}) {
+            CHECK(sameBytes(ImageFilters::gaussianBlur(image, radius, 2, &buffer), ImageFilters::gaussianBlur(image, radius, 2)));
+            CHECK(buffer.size() == static_cast<size_t>(size.width()) * size.height());
+        }
+        CHECK(sameBytes(ImageFilters::boxBlur(image, 5, 1, &buffer), ImageFilters::boxBlur(image, 5, 1)));
+    }
+}
+
+// 大半径使用三次盒式模糊近似：与浮点高斯的差别在几个灰度级以内
+void testGaussianBoxApproximation()
+{
+    QImage image(160, 120, QImage::Format_RGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            const bool inside = x >= 50 && x < 110 && y >= 30 && y < 90;
+            image.setPixel(x, y, inside ? qRgb(240, 60, 120) : qRgb(20, 180, 40));
+        }
+    }
+
+    const int radius = ImageFilters::BoxApproximationRadius + 6;
+    const QImage approximate = ImageFilters::gaussianBlur(image, radius, 2);
+    const QImage reference = floatGaussian(image, radius, 0.3 * (radius - 1) + 0.8);
+    CHECK(maxColorDifference(approximate, reference) <= 6);
+    CHECK(sameImage(approximate, ImageFilters::gaussianBlur(image, radius, 1)));
+}
+
+// ========== 扫描线滤镜 ==========
+
+// 文档中的定点锐化：权重为intensity*256取整，各颜色通道(256c + 权重*拉普拉斯) >> 8，边框与alpha不变
+QImage referenceSharpen(const QImage& image, double intensity)
+{
+    const int weight = static_cast<int>(std::lround(intensity * 256.0));
+    const bool gray = image.format() == QImage::Format_Grayscale8;
+    QImage result = image.copy();
+    for (int y = 1; y < image.height() - 1; ++y) {
+        for (int x = 1; x < image.width() - 1; ++x) {
+            auto sharpened = [&](auto sample) {
+                const int center = sample(x, y);
+                const int laplacian = 4 * center - sample(x - 1, y) - sample(x + 1, y) - sample(x, y - 1) - sample(x, y + 1);
+                return std::clamp((256 * center + weight * laplacian) >> 8, 0, 255);
+            };
+            if (gray) {
+                result.scanLine(y)[x] = static_cast<uchar>(sharpened([&image](int px, int py) {
+                    return static_cast<int>(image.constScanLine(py)[px]);
+                }));
+                continue;
+            }
+            QRgb pixel = image.pixel(x, y) & 0xFF000000u;
+            for (int shift = 0; shift <= 16; shift += 8) {
+                pixel |= static_cast<QRgb>(sharpened([&image, shift](int px, int py) {
+                    return channel(image.pixel(px, py), shift);
+                })) << shift;
+            }
+            result.setPixel(x, y, pixel);
+        }
+    }
+    return result;
+}
+
+// 与原逐像素实现相同的运算，用于检查扫描线实现在带alpha的输入上也逐位一致
+QImage referenceEdgeDetection(const QImage& image, double intensity)
+{
+    const QImage gray = image.convertToFormat(QImage::Format_Grayscale8);
+    QImage result(gray.size(), QImage::Format_RGB32);
+    result.fill(Qt::black);
+    auto at = [&gray](int x, int y) { return static_cast<int>(gray.constScanLine(y)[x]); };
+    for (int y = 1; y < gray.height() - 1; ++y) {
+        for (int x = 1; x < gray.width() - 1; ++x) {
+            const int gx = -at(x - 1, y - 1) + at(x + 1, y - 1) - 2 * at(x - 1, y) + 2 * at(x + 1, y) -
+                           at(x - 1, y + 1) + at(x + 1, y + 1);
+            const int gy = -at(x - 1, y - 1) - 2 * at(x, y - 1) - at(x + 1, y - 1) + at(x - 1, y + 1) +
+                           2 * at(x, y + 1) + at(x + 1, y + 1);
+            const int magnitude = std::clamp(static_cast<int>(std::sqrt(gx * gx + gy * gy) * intensity), 0, 255);
+            result.setPixel(x, y, qRgb(magnitude, magnitude, magnitude));
+        }
+    }
+    return result;
+}
+
+QImage referenceSepia(const QImage& image)
+{
+    QImage result = TemplateMatcher::toColorBuffer(image).copy();
+    for (int y = 0; y < result.height(); ++y) {
+        for (int x = 0; x < result.width(); ++x) {
+            const QRgb pixel = result.pixel(x, y);
+            const int r = qRed(pixel);
+            const int g = qGreen(pixel);
+            const int b = qBlue(pixel);
+            result.setPixel(x, y, qRgba(std::min(static_cast<int>(0.393 * r + 0.769 * g + 0.189 * b), 255),
+                                        std::min(static_cast<int>(0.349 * r + 0.686 * g + 0.168 * b), 255),
+                                        std::min(static_cast<int>(0.272 * r + 0.534 * g + 0.131 * b), 255), qAlpha(pixel)));
+        }
+    }
+    return result;
+}
+
+QImage referenceNegative(const QImage& image)
+{
+    QImage result = image.format() == QImage::Format_Grayscale8 ? image.copy() : TemplateMatcher::toColorBuffer(image).copy();
+    for (int y = 0; y < result.height(); ++y) {
+        uchar* row = result.scanLine(y);
+        for (int x = 0; x < result.width(); ++x) {
+            if (result.format() == QImage::Format_Grayscale8) {
+                row[x] = static_cast<uchar>(255 - row[x]);
+            } else {
+                reinterpret_cast<QRgb*>(row)[x] ^= 0x00FFFFFFu;
+            }
+        }
+    }
+    return result;
+}
+
+// 边缘检测、怀旧、反色与原逐像素实现的最大通道差为0（锐化按1/256量化强度，与原实现不同）
+void testFiltersMatchLegacy()
+{
+    for (const QSize& size : {QSize(97, 61), QSize(333, 210)}) {
+        for (int threads : {1, 4}) {
+            const std::vector<ImageFilters::FilterBenchmark> benchmarks = ImageFilters::benchmarkFilters(size, threads, 1);
+            CHECK(benchmarks.size() == 4);
+            for (const ImageFilters::FilterBenchmark& benchmark : benchmarks) {
+                if (benchmark.filter != "Sharpen") {
+                    CHECK(benchmark.maxDifference == 0);
+                }
+            }
+        }
+    }
+
+    // 基准测试只用不透明图像与固定强度，这里再用带alpha的图像与多个强度逐位比较
+    const QImage color = translucentTexture(203, 141, 21);
+    const QImage gray = ImageFilters::grayscale(TestSupport::makeTexture(203, 141, 22));
+    for (double intensity : {0.25, 0.5, 1.7}) {
+        CHECK(sameBytes(ImageFilters::edgeDetection(color, intensity, 2), referenceEdgeDetection(color, intensity)));
+        CHECK(sameBytes(ImageFilters::sharpen(color, intensity, 2), referenceSharpen(color, intensity)));
+        CHECK(sameBytes(ImageFilters::sharpen(gray, intensity, 2), referenceSharpen(gray, intensity)));
+    }
+    CHECK(sameBytes(ImageFilters::sepia(color, 2), referenceSepia(color)));
+    CHECK(sameBytes(ImageFilters::negative(color, 2), referenceNegative(color)));
+    CHECK(sameBytes(ImageFilters::negative(gray, 2), referenceNegative(gray)));
+}
+
+// 各SIMD后端与线程数的结果逐位一致；宽度不是向量宽度的倍数，覆盖每行的尾部像素
+void testFiltersAcrossBackends()
+{
+    const QImage color = translucentTexture(203, 270, 23);
+    const QImage gray = ImageFilters::grayscale(TestSupport::makeTexture(203, 270, 24));
+    auto runAll = [&](int threads) {
+        return std::vector<QImage>{
+            ImageFilters::sharpen(color, 0.7, threads),
+            ImageFilters::sharpen(gray, 1.3, threads),
+            ImageFilters::edgeDetection(color, 0.8, threads),
+            ImageFilters::sepia(color, threads),
+            ImageFilters::negative(color, threads),
+            ImageFilters::negative(gray, threads),
+            ImageFilters::grayscale(color, threads),
+        };
+    };
+
+    CHECK(PixelKernels::setBackend(PixelKernels::Backend::Scalar));
+    const std::vector<QImage> expected = runAll(1);
+    for (PixelKernels::Backend backend : {PixelKernels::Backend::Scalar, PixelKernels::Backend::SSE41,
+                                          PixelKernels::Backend::AVX2}) {
+        if (!PixelKernels::setBackend(backend)) {
+            continue;
+        }
+        for (int threads : {1, 3}) {
+            const std::vector<QImage> results = runAll(threads);
+            for (size_t i = 0; i < results.size(); ++i) {
+                const bool same = sameBytes(results[i], expected[i]);
+                CHECK(same);
+                if (!same) {
+                    std::printf("     filter %zu, backend %s, %d threads\n", i,
+                                qPrintable(PixelKernels::backendName(backend)), threads);
+                }
+            }
+        }
+    }
+    PixelKernels::setBackend(PixelKernels::detectBackend());
+}
+
+// 负强度（柔化）明确拒绝，而不是静默按0处理；强度上限为128
+void testSharpenIntensityRange()
+{
+    const QImage image = TestSupport::makeTexture(40, 30, 25);
+    CHECK(ImageFilters::sharpenWeight(-0.5) == -1);
+    CHECK(ImageFilters::sharpenWeight(0.0) == 0);
+    CHECK(ImageFilters::sharpenWeight(1.0) == 256);
+    CHECK(ImageFilters::sharpenWeight(1000.0) == 32767);
+    CHECK(ImageFilters::sharpen(image, -0.5).isNull());
+    CHECK(sameBytes(ImageFilters::sharpen(image, 0.0), TemplateMatcher::toColorBuffer(image)));
+
+    FilterPipeline pipeline;
+    pipeline.grayscale().sharpen(-1.0);
+    QImage output;
+    CHECK(!pipeline.run(image, output));
+
+    ImageProcessor processor;
+    CHECK(processor.applyFilter(image, output, ImageProcessor::FilterType::Sharpen, -0.5) ==
+          ImageProcessor::ProcessResult::InvalidInput);
+    CHECK(processor.applyFilter(image, output, ImageProcessor::FilterType::Sharpen, 0.5) ==
+          ImageProcessor::ProcessResult::Success);
+}
+
+
+// ========== 融合流水线 ==========
+
+/**
+ * PipelineStep - 流水线中的一步，同时描述FilterPipeline的调用与对应的ImageFilters函数
+ */
+struct PipelineStep {
+    enum Kind { Gray, Sharpen, Threshold, Negative } kind;
+    double value = 0.0;
+};
+
+using Chain = std::vector<PipelineStep>;
+
+FilterPipeline makePipeline(const QRect& crop, const Chain& chain)
+{
+    FilterPipeline pipeline;
+    pipeline.crop(crop);
+    for (const PipelineStep& step : chain) {
+        switch (step.kind) {
+        case PipelineStep::Gray: pipeline.grayscale(); break;
+        case PipelineStep::Sharpen: pipeline.sharpen(step.value); break;
+        case PipelineStep::Threshold: pipeline.threshold(static_cast<int>(step.value)); break;
+        case PipelineStep::Negative: pipeline.negative(); break;
+        }
+    }
+    return pipeline;
+}
+
+// 先用QImage::copy裁剪，再依次调用ImageFilters中的函数
+QImage applySequence(const QImage& input, const QRect& crop, const Chain& chain)
+{
+    QImage image = crop.isNull() ? input : input.copy(crop);
+    for (const PipelineStep& step : chain) {
+        switch (step.kind) {
+        case PipelineStep::Gray: image = ImageFilters::grayscale(image); break;
+        case PipelineStep::Sharpen: image = ImageFilters::sharpen(image, step.value); break;
+        case PipelineStep::Threshold: image = ImageFilters::threshold(image, static_cast<int>(step.value)); break;
+        case PipelineStep::Negative: image = ImageFilters::negative(image); break;
+        }
+    }
+    return image;
+}
+
+// 各操作链的结果与逐个调用滤镜逐位一致：多次锐化（多段与边缘行）、灰度前后的反色（段内格式切换）、
+// 裁剪边缘按图像边界处理；图像高于块行数，多线程时还有条带接缝
+void testFilterPipelineMatchesSequence()
+{
+    const PipelineStep gray{PipelineStep::Gray};
+    const PipelineStep negative{PipelineStep::Negative};
+    auto sharpen = [](double intensity) { return PipelineStep{PipelineStep::Sharpen, intensity}; };
+    auto threshold = [](int level) { return PipelineStep{PipelineStep::Threshold, static_cast<double>(level)}; };
+
+    const std::vector<Chain> chains = {
+        {},
+        {gray, sharpen(0.5), threshold(128)},
+        {sharpen(0.3), sharpen(0.8), negative},
+        {negative, gray, sharpen(1.0), negative},
+        {sharpen(0.6), negative, gray, sharpen(0.4), threshold(100)},
+        {negative, sharpen(0.5), negative, sharpen(0.5), gray, sharpen(0.25), negative},
+        {threshold(90), sharpen(2.0)},
+    };
+    // 600像素宽的彩色图像在有锐化时每块约100行，小于图像高度
+    const QImage color = translucentTexture(600, 330, 5);
+    const QImage grayInput = ImageFilters::grayscale(TestSupport::makeTexture(600, 330, 6));
+    const std::vector<QRect> crops = {QRect(), QRect(37, 11, 501, 307), QRect(0, 200, 600, 130), QRect(5, 5, 2, 300)};
+
+    for (const QImage& input : {color, grayInput}) {
+        for (const QRect& crop : crops) {
+            for (size_t c = 0; c < chains.size(); ++c) {
+                const QImage expected = applySequence(input, crop, chains[c]);
+                FilterPipeline pipeline = makePipeline(crop, chains[c]);
+                for (int threads : {1, 2, 4}) {
+                    QImage output;
+                    CHECK(pipeline.run(input, output, threads));
+                    const bool same = sameBytes(output, expected);
+                    CHECK(same);
+                    if (!same) {
+                        std::printf("     chain %zu, crop %d,%d %dx%d, %d threads, %s input\n", c, crop.x(), crop.y(),
+                                    crop.width(), crop.height(), threads, input.depth() == 8 ? "gray" : "color");
+                    }
+                }
+            }
+        }
+    }
+}
+
+// 同一流水线与输出图像跨帧复用：输出缓冲与块缓冲中的上一帧数据不影响结果
+void testFilterPipelineReuse()
+{
+    FilterPipeline pipeline;
+    pipeline.sharpen(0.7).negative().grayscale().sharpen(0.3);
+    const Chain chain = {{PipelineStep::Sharpen, 0.7}, {PipelineStep::Negative}, {PipelineStep::Gray},
+                         {PipelineStep::Sharpen, 0.3}};
+
+    QImage output;
+    for (int frame = 0; frame < 4; ++frame) {
+        const QImage input = TestSupport::makeTexture(480, 300 - frame * 40, 40 + frame);
+        const int threads = frame % 2 == 0 ? 4 : 2;
+        CHECK(pipeline.run(input, output, threads));
+        CHECK(sameBytes(output, applySequence(input, QRect(), chain)));
+        // 同一帧第二次执行：输出已有内容，尺寸相同时直接复用其像素缓冲
+        const uchar* previousBits = output.constBits();
+        CHECK(pipeline.run(input, output, 1));
+        CHECK(output.constBits() == previousBits);
+        CHECK(sameBytes(output, applySequence(input, QRect(), chain)));
+    }
+
+    // 裁剪区域不在图像内时失败；清空后只复制
+    pipeline.crop(QRect(400, 0, 200, 10));
+    CHECK(!pipeline.run(TestSupport::makeTexture(480, 100, 1), output));
+    CHECK(!pipeline.run(QImage(), output));
+    pipeline.clear();
+    CHECK(pipeline.isEmpty());
+    const QImage input = TestSupport::makeTexture(50, 40, 9);
+    CHECK(pipeline.run(input, output));
+    CHECK(sameBytes(output, TemplateMatcher::toColorBuffer(input)));
+}
+
+}
+
+int main()
+{
+    testGaussianKernel();
+    testGaussianBlurExact();
+    testGaussianBlurEdgeCases();
+    testBlurTransposeBuffer();
+    testGaussianBoxApproximation();
+    testFiltersMatchLegacy();
+    testFiltersAcrossBackends();
+    testSharpenIntensityRange();
+    testFilterPipelineMatchesSequence();
+    testFilterPipelineReuse();
+    return TestSupport::finish("test_image_filters");
+}
@@ -0,0 +1,234 @@
+#include "TestSupport.h"
+#include "core/ImageProcessor.h"
+#include "core/ImageSimilarity.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+using ImageSimilarity::Metric;
+
+const Metric AllMetrics[] = {Metric::ColorDifference, Metric::PeakSignalToNoise, Metric::StructuralSimilarity,
+                             Metric::HistogramIntersection};
+
+QImage solid(int width, int height, QRgb color)
+{
+    QImage image(width, height, QImage::Format_RGB32);
+    image.fill(color);
+    return image;
+}
+
+// 逐窗口直接计算的SSIM：取样网格按window×window分块，边缘不足一个窗口的块按实际像素数计算
+double referenceSsim(const QImage& first, const QImage& second, const QRect& area, int step, int window)
+{
+    const int columns = (area.width() + step - 1) / step;
+    const int rows = (area.height() + step - 1) / step;
+    const double c1 = (0.01 * 255.0) * (0.01 * 255.0);
+    const double c2 = (0.03 * 255.0) * (0.03 * 255.0);
+    double total = 0.0;
+    int windows = 0;
+    for (int top = 0; top < rows; top += window) {
+        for (int left = 0; left < columns; left += window) {
+            std::vector<double> xs, ys;
+            for (int r = top; r < std::min(rows, top + window); ++r) {
+                for (int c = left; c < std::min(columns, left + window); ++c) {
+                    const QPoint p(area.left() + c * step, area.top() + r * step);
+                    xs.push_back(qGray(first.pixel(p)));
+                    ys.push_back(qGray(second.pixel(p)));
+                }
+            }
+            const double n = static_cast<double>(xs.size());
+            double meanX = 0.0, meanY = 0.0;
+            for (size_t i = 0; i < xs.size(); ++i) {
+                meanX += xs[i] / n;
+                meanY += ys[i] / n;
+            }
+            double varianceX = 0.0, varianceY = 0.0, covariance = 0.0;
+            for (size_t i = 0; i < xs.size(); ++i) {
+                varianceX += (xs[i] - meanX) * (xs[i] - meanX) / n;
+                varianceY += (ys[i] - meanY) * (ys[i] - meanY) / n;
+                covariance += (xs[i] - meanX) * (ys[i] - meanY) / n;
+            }
+            total += ((2.0 * meanX * meanY + c1) * (2.0 * covariance + c2)) /
+                     ((meanX * meanX + meanY * meanY + c1) * (varianceX + varianceY + c2));
+            ++windows;
+        }
+    }
+    return total / windows;
+}
+
+// 只取每step行、列的像素组成的降采样图像
+QImage decimate(const QImage& image, const QRect& area, int step)
+{
+    QImage result((area.width() + step - 1) / step, (area.height() + step - 1) / step, QImage::Format_ARGB32);
+    for (int y = 0; y < result.height(); ++y) {
+        for (int x = 0; x < result.width(); ++x) {
+            result.setPixel(x, y, image.pixel(area.left() + x * step, area.top() + y * step));
+        }
+    }
+    return result;
+}
+
+// ========== 已知值 ==========
+
+// 相同图像的各项度量均为1，MSE为0，PSNR为无穷大
+void testIdenticalImages()
+{
+    const QImage image = TestSupport::makeTexture(123, 77, 1);
+    const QImage copy = image.copy();
+    for (Metric metric : AllMetrics) {
+        for (int step : {1, 3}) {
+            ImageSimilarity::Parameters parameters;
+            parameters.metric = metric;
+            parameters.proxyStep = step;
+            CHECK_NEAR(ImageSimilarity::compare(image, copy, image.rect(), parameters), 1.0, 1e-12);
+        }
+    }
+    CHECK(ImageSimilarity::meanSquaredError(image, copy, image.rect()) == 0.0);
+    CHECK(std::isinf(ImageSimilarity::peakSignalToNoise(0.0)));
+    CHECK_NEAR(ImageSimilarity::structuralSimilarity(image, copy, image.rect()), 1.0, 1e-12);
+
+    ImageProcessor processor;
+    CHECK_NEAR(processor.calculateSimilarity(image, copy), 1.0, 1e-12);
+}
+
+// 纯色图像与半幅差异图像的MSE、PSNR、颜色差与直方图交集
+void testKnownValues()
+{
+    // 每个像素的差为(3, -4, 0)：MSE = (9 + 16 + 0) / 3
+    const QImage first = solid(40, 30, qRgb(10, 20, 30));
+    const QImage second = solid(40, 30, qRgb(13, 16, 30));
+    const double mse = 25.0 / 3.0;
+    CHECK_NEAR(ImageSimilarity::meanSquaredError(first, second, first.rect()), mse, 1e-12);
+    CHECK_NEAR(ImageSimilarity::peakSignalToNoise(mse), 10.0 * std::log10(255.0 * 255.0 / mse), 1e-12);
+    CHECK_NEAR(ImageSimilarity::peakSignalToNoise(255.0 * 255.0), 0.0, 1e-12);
+    CHECK_NEAR(ImageSimilarity::colorDifference(first, second, first.rect()), 1.0 - 7.0 / (3.0 * 255.0), 1e-12);
+
+    ImageSimilarity::Parameters psnr;
+    psnr.metric = Metric::PeakSignalToNoise;
+    psnr.maxPsnr = 60.0;
+    CHECK_NEAR(ImageSimilarity::compare(first, second, first.rect(), psnr),
+               ImageSimilarity::peakSignalToNoise(mse) / 60.0, 1e-12);
+
+    // 右半幅红色通道相差100：MSE = 100² × 1/2 / 3；右半幅落入另一个直方图格
+    QImage half = first.copy();
+    for (int y = 0; y < half.height(); ++y) {
+        for (int x = 20; x < half.width(); ++x) {
+            half.setPixel(x, y, qRgb(110, 20, 30));
+        }
+    }
+    CHECK_NEAR(ImageSimilarity::meanSquaredError(first, half, first.rect()), 10000.0 / 6.0, 1e-9);
+    CHECK_NEAR(ImageSimilarity::histogramIntersection(first, half, first.rect()), 0.5, 1e-12);
+    // 只比较左半幅
+    CHECK(ImageSimilarity::meanSquaredError(first, half, QRect(0, 0, 20, 30)) == 0.0);
+    // 超出图像的区域只比较交集部分
+    CHECK_NEAR(ImageSimilarity::meanSquaredError(first, half, QRect(10, -5, 100, 100)), 10000.0 * 2.0 / 3.0 / 3.0, 1e-9);
+
+    // 整体亮度相差3级：SSIM几乎不变，归一化PSNR明显下降
+    const QImage texture = TestSupport::makeTexture(96, 64, 2);
+    QImage brighter = texture.copy();
+    for (int y = 0; y < brighter.height(); ++y) {
+        for (int x = 0; x < brighter.width(); ++x) {
+            const QRgb p = texture.pixel(x, y);
+            brighter.setPixel(x, y, qRgb(std::min(qRed(p) + 3, 255), std::min(qGreen(p) + 3, 255),
+                                         std::min(qBlue(p) + 3, 255)));
+        }
+    }
+    ImageSimilarity::Parameters defaults;
+    CHECK(defaults.metric == Metric::StructuralSimilarity);
+    CHECK(ImageSimilarity::compare(texture, brighter, texture.rect(), defaults) > 0.99);
+    CHECK(ImageSimilarity::compare(texture, brighter, texture.rect(), psnr) < 0.7);
+}
+
+// 尺寸不同、区域为空或参数无效时按完全不同处理
+void testInvalidInputs()
+{
+    const QImage image = TestSupport::makeTexture(32, 32, 3);
+    ImageSimilarity::Parameters parameters;
+    for (Metric metric : AllMetrics) {
+        parameters.metric = metric;
+        CHECK(ImageSimilarity::compare(image, solid(32, 31, 0), image.rect(), parameters) == 0.0);
+        CHECK(ImageSimilarity::compare(image, image, QRect(40, 40, 5, 5), parameters) == 0.0);
+        CHECK(ImageSimilarity::compare(image, image, image.rect(), ImageSimilarity::Parameters{metric, 0, 8, 50.0}) == 0.0);
+    }
+    CHECK(ImageSimilarity::meanSquaredError(image, QImage(), image.rect()) == 255.0 * 255.0);
+    CHECK(ImageSimilarity::structuralSimilarity(image, image, image.rect(), 1, 0) == 0.0);
+}
+
+// ========== 降采样代理与SSIM窗口 ==========
+
+// proxyStep > 1的结果与在逐个取出的降采样图像上逐像素计算相同；只在跳过的行列上不同的图像视为相同
+void testProxyStep()
+{
+    const QImage first = TestSupport::makeTexture(157, 95, 4);
+    const QImage second = TestSupport::makeTexture(157, 95, 5);
+    const QRect region(3, 7, 131, 80);
+    for (int step : {2, 3, 5}) {
+        const QImage proxyFirst = decimate(first, region, step);
+        const QImage proxySecond = decimate(second, region, step);
+        for (Metric metric : AllMetrics) {
+            ImageSimilarity::Parameters proxy;
+            proxy.metric = metric;
+            proxy.proxyStep = step;
+            proxy.ssimWindow = 6;
+            ImageSimilarity::Parameters full = proxy;
+            full.proxyStep = 1;
+            CHECK_NEAR(ImageSimilarity::compare(first, second, region, proxy),
+                       ImageSimilarity::compare(proxyFirst, proxySecond, proxyFirst.rect(), full), 1e-12);
+        }
+    }
+
+    QImage oddChanged = first.copy();
+    for (int y = 0; y < oddChanged.height(); ++y) {
+        for (int x = 0; x < oddChanged.width(); ++x) {
+            if (x % 2 == 1 || y % 2 == 1) {
+                oddChanged.setPixel(x, y, qRgb(255, 0, 255));
+            }
+        }
+    }
+    CHECK(ImageSimilarity::meanSquaredError(first, oddChanged, first.rect(), 2) == 0.0);
+    CHECK(ImageSimilarity::meanSquaredError(first, oddChanged, first.rect(), 1) > 1000.0);
+    CHECK_NEAR(ImageSimilarity::structuralSimilarity(first, oddChanged, first.rect(), 2), 1.0, 1e-12);
+}
+
+// 窗口边长不整除取样尺寸时，边缘窗口按实际像素数计算
+void testSsimPartialWindows()
+{
+    const QImage first = TestSupport::makeTexture(37, 29, 6);
+    QImage second = TestSupport::makeTexture(37, 29, 7);
+    // 右下角的边缘窗口与其余部分明显不同
+    for (int y = 24; y < 29; ++y) {
+        for (int x = 32; x < 37; ++x) {
+            second.setPixel(x, y, qRgb(0, 0, 0));
+        }
+    }
+    struct Case { QRect region; int step; int window; };
+    const Case cases[] = {
+        {first.rect(), 1, 8},            // 37×29：边缘窗口5列、5行
+        {first.rect(), 1, 5},
+        {first.rect(), 2, 5},            // 取样后19×15
+        {QRect(1, 2, 30, 26), 3, 4},     // 取样后10×9
+        {first.rect(), 1, 64},           // 窗口大于图像：只有一个窗口
+        {first.rect(), 1, 1},
+    };
+    for (const Case& c : cases) {
+        const double expected = referenceSsim(first, second, c.region, c.step, c.window);
+        CHECK_NEAR(ImageSimilarity::structuralSimilarity(first, second, c.region, c.step, c.window), expected, 1e-9);
+    }
+    // 与自身比较时每个窗口（包括边缘窗口）都是1
+    CHECK_NEAR(ImageSimilarity::structuralSimilarity(second, second, second.rect(), 1, 8), 1.0, 1e-12);
+}
+
+}
+
+int main()
+{
+    testIdenticalImages();
+    testKnownValues();
+    testInvalidInputs();
+    testProxyStep();
+    testSsimPartialWindows();
+    return TestSupport::finish("test_image_similarity");
+}
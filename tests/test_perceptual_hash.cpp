@@ -0,0 +1,211 @@
+#include "TestSupport.h"
+#include "core/ImageProcessor.h"
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace {
+
+using ImageProcessorUtils::PerceptualHashIndex;
+using ImageProcessorUtils::PerceptualHashType;
+
+uint64_t randomHash(TestSupport::Random& random)
+{
+    return (static_cast<uint64_t>(random.next()) << 40) ^ (static_cast<uint64_t>(random.next()) << 20) ^ random.next();
+}
+
+// 随机翻转flips个不同的位
+uint64_t flipBits(uint64_t hash, int flips, TestSupport::Random& random)
+{
+    uint64_t mask = 0;
+    while (std::popcount(mask) < flips) {
+        mask |= uint64_t(1) << random.range(0, 63);
+    }
+    return hash ^ mask;
+}
+
+// 逐个比较所有条目：距离不超过maxDistance的条目按距离升序、距离相同时按插入顺序
+std::vector<PerceptualHashIndex::Match> bruteForce(const std::vector<uint64_t>& hashes, uint64_t query, int maxDistance)
+{
+    std::vector<PerceptualHashIndex::Match> matches;
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        const int distance = ImageProcessorUtils::hammingDistance(query, hashes[i]);
+        if (distance <= maxDistance) {
+            matches.push_back(PerceptualHashIndex::Match{QString::number(static_cast<int>(i)), hashes[i], distance, static_cast<int>(i)});
+        }
+    }
+    std::stable_sort(matches.begin(), matches.end(), [](const PerceptualHashIndex::Match& a,
+                                                        const PerceptualHashIndex::Match& b) {
+        return a.distance < b.distance;
+    });
+    return matches;
+}
+
+bool sameMatches(const std::vector<PerceptualHashIndex::Match>& actual,
+                 const std::vector<PerceptualHashIndex::Match>& expected)
+{
+    if (actual.size() != expected.size()) {
+        std::printf("     %zu matches, expected %zu\n", actual.size(), expected.size());
+        return false;
+    }
+    for (size_t i = 0; i < actual.size(); ++i) {
+        if (actual[i].index != expected[i].index || actual[i].distance != expected[i].distance ||
+            actual[i].hash != expected[i].hash || actual[i].id != expected[i].id) {
+            std::printf("     match %zu differs\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// ========== 哈希索引 ==========
+
+// search与nearest的结果与逐个比较一致。条目包括随机哈希与它们翻转少数位后的近似重复（含完全相同的哈希），
+// maxDistance覆盖逐段查找（每段距离0~2）与超过4*2之后的线性扫描
+void testIndexMatchesBruteForce()
+{
+    TestSupport::Random random(7);
+    std::vector<uint64_t> hashes;
+    PerceptualHashIndex index;
+    for (int i = 0; i < 3000; ++i) {
+        uint64_t hash = randomHash(random);
+        if (i >= 100 && i % 3 == 0) {
+            hash = flipBits(hashes[random.range(0, i - 1)], random.range(0, 16), random);
+        }
+        hashes.push_back(hash);
+        CHECK(index.insert(hash, QString::number(i)) == i);
+    }
+    CHECK(index.size() == 3000);
+
+    std::vector<uint64_t> queries;
+    for (int i = 0; i < 120; ++i) {
+        queries.push_back(i % 4 == 0 ? randomHash(random)
+                                     : flipBits(hashes[random.range(0, 2999)], random.range(0, 24), random));
+    }
+
+    for (int maxDistance : {0, 1, 3, 4, 5, 8, 11, 12, 13, 16, 24, 40, 64}) {
+        for (uint64_t query : queries) {
+            const std::vector<PerceptualHashIndex::Match> expected = bruteForce(hashes, query, maxDistance);
+            const bool same = sameMatches(index.search(query, maxDistance), expected);
+            CHECK(same);
+            if (!same) {
+                std::printf("     search %016llx, maxDistance %d\n", static_cast<unsigned long long>(query), maxDistance);
+            }
+
+            PerceptualHashIndex::Match nearest;
+            const bool found = index.nearest(query, maxDistance, nearest);
+            CHECK(found == !expected.empty());
+            if (found && !expected.empty()) {
+                CHECK(nearest.index == expected.front().index && nearest.distance == expected.front().distance);
+                CHECK(nearest.id == expected.front().id);
+            }
+        }
+    }
+
+    CHECK(index.search(hashes[0], -1).empty());
+    index.clear();
+    CHECK(index.isEmpty());
+    PerceptualHashIndex::Match none;
+    CHECK(index.search(hashes[0], 64).empty());
+    CHECK(!index.nearest(hashes[0], 64, none));
+}
+
+// nearest逐级查找时的提前结束：更近的条目只在后一级才能找到，或与已找到的条目距离相同但插入更早
+void testNearestProbeLevels()
+{
+    const uint64_t query = 0;
+    PerceptualHashIndex index;
+    // 每段都差2位（距离8）：第0、1级都找不到，第2级才找到
+    index.insert(0x0003000300030003ull, "eight");
+    // 只有一段差5位（距离5）：第0级即找到
+    index.insert(0x000000000000001Full, "five");
+    PerceptualHashIndex::Match match;
+    CHECK(index.nearest(query, 64, match) && match.id == "five" && match.distance == 5);
+    CHECK(index.nearest(query, 8, match) && match.id == "five");
+    CHECK(!index.nearest(query, 4, match));
+
+    // 距离4、每段差1位：第1级才找到，比第0级找到的距离5更近
+    index.insert(0x0001000100010001ull, "four");
+    CHECK(index.nearest(query, 64, match) && match.id == "four" && match.distance == 4);
+
+    // 距离相同时取先插入的条目，即使它在更后一级才被访问
+    PerceptualHashIndex ties;
+    ties.insert(0x0003000300030003ull, "spread");
+    ties.insert(0x00000000000000FFull, "packed");
+    CHECK(ties.nearest(query, 64, match) && match.id == "spread" && match.distance == 8);
+    CHECK(ties.search(query, 8).size() == 2);
+}
+
+// ========== 感知哈希 ==========
+
+QImage adjustBrightness(const QImage& image, int delta)
+{
+    QImage result = image.convertToFormat(QImage::Format_RGB32);
+    for (int y = 0; y < result.height(); ++y) {
+        for (int x = 0; x < result.width(); ++x) {
+            const QRgb p = result.pixel(x, y);
+            result.setPixel(x, y, qRgb(std::clamp(qRed(p) + delta, 0, 255), std::clamp(qGreen(p) + delta, 0, 255),
+                                       std::clamp(qBlue(p) + delta, 0, 255)));
+        }
+    }
+    return result;
+}
+
+// 界面风格的画面：渐变背景上的几个面板
+QImage panelScreen(int width, int height, int variant)
+{
+    QImage image(width, height, QImage::Format_RGB32);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            image.setPixel(x, y, qRgb(40 + y * 100 / height, 60, 90 + x * 60 / width));
+        }
+    }
+    for (int panel = 0; panel < 3; ++panel) {
+        const int left = (panel * 97 + variant * 41) % (width - 80);
+        const int top = (panel * 53 + variant * 29) % (height - 50);
+        for (int y = top; y < top + 50; ++y) {
+            for (int x = left; x < left + 80; ++x) {
+                image.setPixel(x, y, qRgb(200 - panel * 40, 180, 60 + panel * 70));
+            }
+        }
+    }
+    return image;
+}
+
+// 亮度变化一级时各种哈希只改变极少的位，不同画面的哈希相差很多位
+void testHashBrightnessStability()
+{
+    const std::vector<QImage> images = {TestSupport::makeTexture(320, 180, 11), TestSupport::makeTexture(200, 150, 12),
+                                        panelScreen(320, 180, 0), panelScreen(320, 180, 1), panelScreen(640, 360, 2)};
+    for (PerceptualHashType type : {PerceptualHashType::Average, PerceptualHashType::Difference,
+                                    PerceptualHashType::Dct}) {
+        for (const QImage& image : images) {
+            const uint64_t hash = ImageProcessorUtils::perceptualHash(image, type);
+            for (int delta : {-1, 1}) {
+                const int distance = ImageProcessorUtils::hammingDistance(
+                    hash, ImageProcessorUtils::perceptualHash(adjustBrightness(image, delta), type));
+                CHECK(distance <= 2);
+                if (distance > 2) {
+                    std::printf("     hash type %d, %dx%d, brightness %+d: distance %d\n", static_cast<int>(type),
+                                image.width(), image.height(), delta, distance);
+                }
+            }
+        }
+        // 面板位置不同的画面
+        CHECK(ImageProcessorUtils::hammingDistance(ImageProcessorUtils::perceptualHash(images[2], type),
+                                                   ImageProcessorUtils::perceptualHash(images[3], type)) >= 8);
+    }
+
+    CHECK(ImageProcessorUtils::hammingDistance(0, ~uint64_t(0)) == 64);
+    CHECK(ImageProcessorUtils::hammingDistance(0x0F, 0xF0) == 8);
+}
+
+}
+
+int main()
+{
+    testIndexMatchesBruteForce();
+    testNearestProbeLevels();
+    testHashBrightnessStability();
+    return TestSupport::finish("test_perceptual_hash");
+}
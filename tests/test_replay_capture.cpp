@@ -0,0 +1,234 @@
+#include "TestSupport.h"
+#include "core/ReplayCaptureSource.h"
+#include <QDir>
+#include <QTemporaryDir>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+// 灰度渐变图像，宽度为奇数时每行末尾有对齐填充
+QImage makeGray(int width, int height, int seed)
+{
+    QImage image(width, height, QImage::Format_Grayscale8);
+    for (int y = 0; y < height; ++y) {
+        uint8_t* line = image.scanLine(y);
+        for (int x = 0; x < width; ++x) {
+            line[x] = static_cast<uint8_t>((x * 7 + y * 3 + seed * 40) & 0xFF);
+        }
+    }
+    return image;
+}
+
+// 逐行比较有效像素，不比较行尾填充
+bool samePixels(const Frame& frame, const QImage& image)
+{
+    const Frame expected = Frame::fromImage(image);
+    if (frame.isNull() || frame.size() != expected.size() || frame.format() != expected.format()) {
+        return false;
+    }
+    const size_t rowBytes = static_cast<size_t>(frame.width()) * Frame::bytesPerPixel(frame.format());
+    for (int y = 0; y < frame.height(); ++y) {
+        if (std::memcmp(frame.constScanLine(y), expected.constScanLine(y), rowBytes) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ========== 帧文件 ==========
+
+void testRecordingRoundTrip()
+{
+    QTemporaryDir directory;
+    CHECK(directory.isValid());
+    const QString path = directory.filePath("capture.qdframe");
+
+    // 三种像素格式与不同尺寸混合
+    QImage opaque = TestSupport::makeTexture(40, 30, 1).convertToFormat(QImage::Format_RGB32);
+    const QImage images[] = {TestSupport::makeTexture(40, 30, 2), opaque, makeGray(13, 9, 3)};
+
+    FrameRecorder recorder;
+    CHECK(recorder.open(path));
+    for (const QImage& image : images) {
+        CHECK(recorder.write(Frame::fromImage(image)));
+    }
+    CHECK(!recorder.write(Frame()));
+    CHECK(recorder.frameCount() == 3);
+    recorder.close();
+
+    ReplayCaptureSource replay(30.0, ReplayCaptureSource::Pacing::Stepped);
+    CHECK(replay.openRecording(path) == 3);
+    CHECK(replay.frameSize() == QSize(40, 30));
+    CHECK(replay.pixelFormat() == Frame::PixelFormat::Bgra32);
+    CHECK(replay.nextFrame().isNull());   // 未start
+
+    CHECK(replay.start());
+    for (int i = 0; i < 3; ++i) {
+        const Frame frame = replay.nextFrame();
+        CHECK(frame.sequence() == static_cast<quint64>(i + 1));
+        CHECK(samePixels(frame, images[i]));
+        CHECK(replay.frameSize() == images[i].size());
+    }
+    CHECK(replay.pixelFormat() == Frame::PixelFormat::Gray8);
+    CHECK(replay.atEnd());
+    CHECK(replay.nextFrame().isNull());
+
+    // 跳转后从指定帧继续，循环回放时帧序号继续递增
+    replay.seek(1);
+    CHECK(!replay.atEnd());
+    CHECK(replay.nextFrame().sequence() == 2);
+    replay.setLoop(true);
+    replay.nextFrame();
+    const Frame wrapped = replay.nextFrame();
+    CHECK(wrapped.sequence() == 4);
+    CHECK(samePixels(wrapped, images[0]));
+    CHECK(!replay.atEnd());
+
+    // 帧缓冲池复用已释放的缓冲区，只有仍被持有的wrapped占用缓冲区
+    for (int i = 0; i < 9; ++i) {
+        replay.nextFrame();
+    }
+    CHECK(replay.framePoolStatistics().buffersInUse == 1);
+    CHECK(replay.framePoolStatistics().hits > 0);
+}
+
+// 末尾不完整的帧被忽略，标识错误的文件无法打开
+void testRecordingDamaged()
+{
+    QTemporaryDir directory;
+    const QString path = directory.filePath("truncated.qdframe");
+    const QImage image = TestSupport::makeTexture(16, 8, 4);
+    {
+        FrameRecorder recorder;
+        CHECK(recorder.open(path));
+        CHECK(recorder.write(Frame::fromImage(image)));
+        CHECK(recorder.write(Frame::fromImage(image)));
+    }
+    const qint64 completeSize = [&]() {
+        QFile file(path);
+        file.open(QIODevice::ReadOnly);
+        return file.size();
+    }();
+    {
+        // 截掉最后一帧的最后一行
+        std::vector<char> bytes(static_cast<size_t>(completeSize - 16 * 4));
+        QFile file(path);
+        CHECK(file.open(QIODevice::ReadOnly));
+        CHECK(file.read(bytes.data(), static_cast<qint64>(bytes.size())) == static_cast<qint64>(bytes.size()));
+        file.close();
+        CHECK(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(bytes.data(), static_cast<qint64>(bytes.size()));
+    }
+
+    ReplayCaptureSource replay(30.0, ReplayCaptureSource::Pacing::Stepped);
+    CHECK(replay.openRecording(path) == 1);
+
+    const QString badPath = directory.filePath("bad.qdframe");
+    {
+        QFile file(badPath);
+        CHECK(file.open(QIODevice::WriteOnly));
+        file.write("QDFRAME0", 8);
+    }
+    CHECK(replay.openRecording(badPath) == -1);
+    CHECK(replay.frameCount() == 0);
+    CHECK(!replay.start());
+    CHECK(replay.openRecording(directory.filePath("missing.qdframe")) == -1);
+}
+
+// ========== 图像序列 ==========
+
+void testImageSequence()
+{
+    QTemporaryDir directory;
+    QImage images[3];
+    for (int i = 0; i < 3; ++i) {
+        images[i] = TestSupport::makeTexture(24, 18, 10 + i).convertToFormat(QImage::Format_RGB32);
+        CHECK(images[i].save(directory.filePath(QString("frame_%1.png").arg(i))));
+    }
+    {
+        QFile notes(directory.filePath("notes.txt"));
+        CHECK(notes.open(QIODevice::WriteOnly));
+        notes.write("not an image", 12);
+    }
+
+    for (bool preload : {false, true}) {
+        ReplayCaptureSource replay(30.0, ReplayCaptureSource::Pacing::Stepped);
+        CHECK(replay.openImageSequence(directory.path(), preload) == 3);
+        CHECK(replay.frameSize() == QSize(24, 18));
+        CHECK(replay.start());
+        for (int i = 0; i < 3; ++i) {
+            const Frame frame = replay.nextFrame();
+            CHECK(frame.sequence() == static_cast<quint64>(i + 1));
+            CHECK(samePixels(frame, images[i]));
+        }
+        CHECK(replay.atEnd());
+    }
+
+    ReplayCaptureSource replay;
+    CHECK(replay.openImageSequence(directory.filePath("missing")) == -1);
+    CHECK(replay.openImageFiles(QStringList()) == -1);
+}
+
+// 灰度PNG按Gray8回放，像素与原图相同
+void testGraySequence()
+{
+    QTemporaryDir directory;
+    QImage images[2];
+    for (int i = 0; i < 2; ++i) {
+        images[i] = makeGray(21, 11, i);
+        CHECK(images[i].save(directory.filePath(QString("gray_%1.png").arg(i))));
+    }
+
+    for (bool preload : {false, true}) {
+        ReplayCaptureSource replay(30.0, ReplayCaptureSource::Pacing::Stepped);
+        CHECK(replay.openImageSequence(directory.path(), preload) == 2);
+        CHECK(replay.pixelFormat() == Frame::PixelFormat::Gray8);
+        CHECK(replay.start());
+        for (int i = 0; i < 2; ++i) {
+            const Frame frame = replay.nextFrame();
+            CHECK(frame.format() == Frame::PixelFormat::Gray8);
+            CHECK(samePixels(frame, images[i]));
+        }
+    }
+}
+
+// ========== 实时回放 ==========
+
+// 同一帧不会返回两次，跟不上帧率时跳过中间的帧
+void testRealTimePacing()
+{
+    QTemporaryDir directory;
+    FrameRecorder recorder;
+    CHECK(recorder.open(directory.filePath("realtime.qdframe")));
+    for (int i = 0; i < 10; ++i) {
+        recorder.write(Frame::fromImage(makeGray(8, 8, i)));
+    }
+    recorder.close();
+
+    ReplayCaptureSource replay(10.0, ReplayCaptureSource::Pacing::RealTime);
+    CHECK(replay.openRecording(directory.filePath("realtime.qdframe")) == 10);
+    CHECK(replay.start());
+    CHECK(replay.nextFrame().sequence() == 1);
+    CHECK(replay.nextFrame().isNull());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(350));
+    const Frame later = replay.nextFrame();
+    CHECK(later.sequence() >= 4);
+    CHECK(samePixels(later, makeGray(8, 8, static_cast<int>(later.sequence()) - 1)));
+    replay.stop();
+    CHECK(replay.position() == static_cast<int>(later.sequence()));
+}
+
+}
+
+int main()
+{
+    testRecordingRoundTrip();
+    testRecordingDamaged();
+    testImageSequence();
+    testGraySequence();
+    testRealTimePacing();
+    return TestSupport::finish("test_replay_capture");
+}
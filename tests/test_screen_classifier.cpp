@@ -0,0 +1,110 @@
+#include "TestSupport.h"
+#include "core/ScreenStateClassifier.h"
+#include <QDir>
+#include <QFileInfo>
+
+/**
+ * 合成语料（tests/data）：
+ *   screens/                参考截图，320x180；battle子目录下有两种布局
+ *   screens_queries/        待识别画面：<标签>_<n>.png，分辨率、亮度、噪声或局部控件与参考图不同；
+ *                           unknown_<n>.png 为语料中不存在的画面，不应给出标签
+ */
+namespace {
+
+const QString ReferenceDirectory = QString(QTDEMO_TEST_DATA "/screens");
+const QString QueryDirectory = QString(QTDEMO_TEST_DATA "/screens_queries");
+
+// ========== 哈希索引 ==========
+
+// 条目序号按插入顺序分配，search与nearest都返回序号
+void testHashIndexEntries()
+{
+    ImageProcessorUtils::PerceptualHashIndex index;
+    CHECK(index.insert(0x0000000000000000ull, "zero") == 0);
+    CHECK(index.insert(0xFFFFFFFF00000000ull, "high") == 1);
+    CHECK(index.insert(0x0000000000000003ull, "low") == 2);
+
+    const std::vector<ImageProcessorUtils::PerceptualHashIndex::Match> matches = index.search(0x1ull, 4);
+    CHECK(matches.size() == 2);
+    if (matches.size() == 2) {
+        CHECK(matches[0].index == 0 && matches[0].id == "zero" && matches[0].distance == 1);
+        CHECK(matches[1].index == 2 && matches[1].id == "low" && matches[1].distance == 1);
+    }
+
+    ImageProcessorUtils::PerceptualHashIndex::Match nearest;
+    CHECK(index.nearest(0xFFFFFFFF00000001ull, 8, nearest));
+    CHECK(nearest.index == 1 && nearest.distance == 1);
+}
+
+// ========== 参考图加载 ==========
+
+void testLoadDirectory()
+{
+    ScreenStateClassifier classifier;
+    CHECK(classifier.loadDirectory(ReferenceDirectory) == 6);
+    CHECK(classifier.size() == 6);
+
+    const QStringList labels = classifier.labels();
+    CHECK(labels.size() == 5);
+    for (const char* label : {"battle", "inventory", "loading", "main_menu", "settings"}) {
+        CHECK(labels.contains(QString(label)));
+    }
+
+    // 参考图自身得到完全相同的描述子
+    const QString path = QDir(ReferenceDirectory).filePath("battle/002.png");
+    QImage image;
+    CHECK(image.load(path));
+    const ScreenStateClassifier::Classification result = classifier.classify(image);
+    CHECK(result.label == "battle");
+    CHECK(result.reference == path);
+    CHECK(result.hashDistance == 0);
+    CHECK_NEAR(result.confidence, 1.0, 1e-12);
+
+    CHECK(classifier.loadDirectory(QDir(ReferenceDirectory).filePath("missing")) == -1);
+    CHECK(!classifier.addReference(QString(), image));
+    CHECK(!classifier.addReference("empty", QImage()));
+    classifier.clear();
+    CHECK(classifier.isEmpty());
+    CHECK(!classifier.classify(image).isValid());
+}
+
+// ========== 识别 ==========
+
+void testClassifyQueries()
+{
+    ScreenStateClassifier classifier;
+    classifier.loadDirectory(ReferenceDirectory);
+
+    const QDir queries(QueryDirectory);
+    const QStringList files = queries.entryList(QStringList{"*.png"}, QDir::Files, QDir::Name);
+    CHECK(files.size() == 16);
+
+    for (const QString& fileName : files) {
+        const QString baseName = QFileInfo(fileName).completeBaseName();
+        const QString expected = baseName.left(baseName.lastIndexOf('_'));
+
+        QImage frame;
+        CHECK(frame.load(queries.filePath(fileName)));
+        const ScreenStateClassifier::Classification result = classifier.classify(frame);
+        if (expected == "unknown") {
+            CHECK(!result.isValid());
+        } else {
+            CHECK(result.label == expected);
+            CHECK(result.confidence >= classifier.getParameters().minConfidence);
+        }
+        if (result.label != (expected == "unknown" ? QString() : expected)) {
+            std::printf("     %s -> '%s' (%.3f, distance %d)\n", qPrintable(fileName), qPrintable(result.label),
+                        result.confidence, result.hashDistance);
+        }
+    }
+}
+
+}
+
+int main()
+{
+    testHashIndexEntries();
+    testLoadDirectory();
+    testClassifyQueries();
+    return TestSupport::finish("test_screen_classifier");
+}
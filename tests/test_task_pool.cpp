@@ -0,0 +1,340 @@
+#include "TestSupport.h"
+#include "core/ImageFilters.h"
+#include "core/ImageProcessor.h"
+#include "core/IntegralImage.h"
+#include "core/TaskPool.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 执行body的线程集合
+std::set<std::thread::id> bandThreads(int threadCount, int* bandCount)
+{
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    *bandCount = TaskPool::forEachBand(1024, threadCount, 32, [&](int, int, int) {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+    });
+    return threads;
+}
+
+// 等待条件满足，期间处理本线程的事件（异步结果的送达）
+template <typename Predicate>
+bool processEventsUntil(Predicate predicate, int timeoutMs = 5000)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!predicate()) {
+        if (timer.elapsed() > timeoutMs) {
+            return false;
+        }
+        QCoreApplication::processEvents();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// 占住线程池的一个线程，直到release
+struct Blocker {
+    std::atomic<bool> started{false};
+    std::atomic<bool> released{false};
+
+    TaskPool::Task task()
+    {
+        return [this]() {
+            started = true;
+            while (!released.load()) {
+                std::this_thread::yield();
+            }
+        };
+    }
+};
+
+// ========== 任务执行 ==========
+
+// 单线程时排队的任务按优先级执行，同一优先级按提交顺序
+void testPriorityOrder()
+{
+    TaskPool pool(1);
+    Blocker blocker;
+    pool.submit(blocker.task());
+    while (!blocker.started.load()) {
+        std::this_thread::yield();
+    }
+
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int value) {
+        return [&, value]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(value);
+        };
+    };
+    pool.submit(record(1), TaskPriority::Low);
+    pool.submit(record(2), TaskPriority::Normal);
+    pool.submit(record(3), TaskPriority::High);
+    pool.submit(record(4), TaskPriority::Low);
+    pool.submit(record(5), TaskPriority::High);
+    CHECK(pool.pendingCount() == 5);
+
+    blocker.released = true;
+    pool.waitForIdle();
+    CHECK(order == std::vector<int>({3, 5, 2, 1, 4}));
+    CHECK(pool.pendingCount() == 0);
+}
+
+// 提交前或排队期间取消的任务不执行；已开始的任务由任务自己检查标记
+void testCancellation()
+{
+    TaskPool pool(1);
+    Blocker blocker;
+    pool.submit(blocker.task());
+    while (!blocker.started.load()) {
+        std::this_thread::yield();
+    }
+
+    std::atomic<int> ran{0};
+    CancellationToken before;
+    before.cancel();
+    pool.submit([&ran]() { ran += 1; }, TaskPriority::High, before);
+
+    CancellationToken queued;
+    pool.submit([&ran]() { ran += 10; }, TaskPriority::Normal, queued);
+    pool.submit([&ran]() { ran += 100; }, TaskPriority::Normal, queued);
+    pool.submit([&ran]() { ran += 1000; });
+    queued.cancel();
+    CHECK(queued.isCancelled());
+
+    blocker.released = true;
+    pool.waitForIdle();
+    CHECK(ran.load() == 1000);
+    CHECK(pool.pendingCount() == 0);
+
+    // 复制的标记共享状态
+    CancellationToken copy = before;
+    CHECK(copy.isCancelled());
+    CHECK(!CancellationToken().isCancelled());
+}
+
+// 工作线程内提交的任务进入本线程的队列；本线程忙时由其他线程窃取
+void testWorkStealing()
+{
+    TaskPool pool(2);
+    const int taskCount = 32;
+    std::atomic<int> finished{0};
+    std::mutex mutex;
+    std::set<std::thread::id> runners;
+    std::thread::id producer;
+
+    pool.submit([&]() {
+        producer = std::this_thread::get_id();
+        for (int i = 0; i < taskCount; ++i) {
+            pool.submit([&]() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    runners.insert(std::this_thread::get_id());
+                }
+                ++finished;
+            });
+        }
+        // 提交线程一直忙到所有任务完成，任务只能被另一个线程窃取
+        while (finished.load() < taskCount) {
+            std::this_thread::yield();
+        }
+    });
+    pool.waitForIdle();
+
+    CHECK(finished.load() == taskCount);
+    CHECK(runners.size() == 1);
+    CHECK(runners.count(producer) == 0);
+}
+
+// 线程数可随时调整，减少后多余的线程退出，任务照常完成
+void testThreadCount()
+{
+    TaskPool pool(4);
+    CHECK(pool.threadCount() == 4);
+    pool.setThreadCount(0);
+    CHECK(pool.threadCount() == 1);
+    pool.setThreadCount(TaskPool::MaxThreads + 10);
+    CHECK(pool.threadCount() == TaskPool::MaxThreads);
+    pool.setThreadCount(2);
+
+    std::atomic<int> count{0};
+    for (int i = 0; i < 200; ++i) {
+        pool.submit([&count]() { ++count; });
+    }
+    pool.waitForIdle();
+    CHECK(count.load() == 200);
+}
+
+// ========== 异步送达 ==========
+
+// submitAsync的结果在调用线程（或context所在线程）处理事件时送达；context销毁或标记取消后不再送达
+void testSubmitAsyncDelivery()
+{
+    ImageProcessor processor;
+    processor.setProcessingThreads(2);
+    const std::thread::id mainThread = std::this_thread::get_id();
+
+    std::thread::id workThread;
+    std::thread::id deliveryThread;
+    std::atomic<bool> worked{false};
+    bool delivered = false;
+    processor.submitAsync(ImageProcessor::AsyncOptions(), [&]() -> std::function<void()> {
+        workThread = std::this_thread::get_id();
+        worked = true;
+        return [&]() {
+            deliveryThread = std::this_thread::get_id();
+            delivered = true;
+        };
+    });
+    // 不处理事件时不会送达
+    while (!worked.load()) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(!delivered);
+    CHECK(processEventsUntil([&] { return delivered; }));
+    CHECK(workThread != mainThread);
+    CHECK(deliveryThread == mainThread);
+
+    // context在送达前销毁
+    auto* context = new QObject;
+    ImageProcessor::AsyncOptions options;
+    options.context = context;
+    std::atomic<bool> contextWorked{false};
+    bool contextDelivered = false;
+    processor.submitAsync(options, [&]() -> std::function<void()> {
+        contextWorked = true;
+        return [&contextDelivered]() { contextDelivered = true; };
+    });
+    while (!contextWorked.load()) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    delete context;
+    QCoreApplication::processEvents();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    QCoreApplication::processEvents();
+    CHECK(!contextDelivered);
+
+    // 分析结束后、送达前取消
+    ImageProcessor::AsyncOptions cancelOptions;
+    std::atomic<bool> cancelWorked{false};
+    bool cancelDelivered = false;
+    const CancellationToken token = processor.submitAsync(cancelOptions, [&]() -> std::function<void()> {
+        cancelWorked = true;
+        return [&cancelDelivered]() { cancelDelivered = true; };
+    });
+    while (!cancelWorked.load()) {
+        std::this_thread::yield();
+    }
+    token.cancel();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    QCoreApplication::processEvents();
+    CHECK(!cancelDelivered);
+
+    // 取消只影响对应的任务
+    bool later = false;
+    processor.submitAsync(ImageProcessor::AsyncOptions(), [&later]() -> std::function<void()> {
+        return [&later]() { later = true; };
+    });
+    CHECK(processEventsUntil([&] { return later; }));
+}
+
+// ========== 行条带 ==========
+
+// 每行恰好处理一次；多次调用只使用共享线程池中的线程与调用线程，不再每次创建线程
+void testForEachBandOnSharedPool()
+{
+    for (int height : {0, 1, 31, 64, 1000}) {
+        for (int threadCount : {1, 2, 4, 7}) {
+            std::vector<int> visits(height, 0);
+            const int bands = TaskPool::forEachBand(height, threadCount, 16, [&](int, int first, int last) {
+                for (int y = first; y < last; ++y) {
+                    ++visits[y];
+                }
+            });
+            CHECK(bands >= 1 && bands <= threadCount);
+            CHECK(std::count(visits.begin(), visits.end(), 1) == height);
+        }
+    }
+
+    std::set<std::thread::id> threads;
+    for (int call = 0; call < 50; ++call) {
+        int bands = 0;
+        const std::set<std::thread::id> used = bandThreads(4, &bands);
+        threads.insert(used.begin(), used.end());
+    }
+    CHECK(static_cast<int>(threads.size()) <= TaskPool::shared().threadCount() + 1);
+
+    // parallelFor的下标多于线程数时调用线程补足
+    std::vector<std::atomic<int>> counts(100);
+    TaskPool::shared().parallelFor(100, [&](int index) { ++counts[index]; });
+    CHECK(std::all_of(counts.begin(), counts.end(), [](const std::atomic<int>& count) { return count.load() == 1; }));
+}
+
+// ========== 嵌套并行 ==========
+
+// 工作线程中的行条带与积分图不再创建线程，结果与多线程计算相同
+void testNestedWorkStaysOnWorker()
+{
+    CHECK(!TaskPool::isWorkerThread());
+    CHECK(TaskPool::nestedThreadCount(4) == 4);
+
+    int outsideBands = 0;
+    bandThreads(4, &outsideBands);
+    CHECK(outsideBands == 4);
+
+    const QImage image = TestSupport::makeTexture(200, 300, 17);
+    const IntegralImage::Tables expectedTables = IntegralImage::build(image, IntegralImage::Channel::Gray, 4);
+    const QImage expectedBlur = ImageFilters::gaussianBlur(image, 3, 4);
+
+    TaskPool pool(2);
+    std::atomic<int> failures{0};
+    for (int task = 0; task < 4; ++task) {
+        pool.submit([&]() {
+            int bands = 0;
+            const std::set<std::thread::id> threads = bandThreads(4, &bands);
+            if (!TaskPool::isWorkerThread() || TaskPool::nestedThreadCount(4) != 1 || bands != 1 ||
+                threads != std::set<std::thread::id>{std::this_thread::get_id()}) {
+                ++failures;
+            }
+
+            const IntegralImage::Tables tables = IntegralImage::build(image, IntegralImage::Channel::Gray, 4);
+            if (tables.sum != expectedTables.sum || tables.squaredSum != expectedTables.squaredSum) {
+                ++failures;
+            }
+            if (ImageFilters::gaussianBlur(image, 3, 4) != expectedBlur) {
+                ++failures;
+            }
+        });
+    }
+    pool.waitForIdle();
+    CHECK(failures.load() == 0);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    testPriorityOrder();
+    testCancellation();
+    testWorkStealing();
+    testThreadCount();
+    testSubmitAsyncDelivery();
+    testForEachBandOnSharedPool();
+    testNestedWorkStaysOnWorker();
+    return TestSupport::finish("test_task_pool");
+}
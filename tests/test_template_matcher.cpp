@@ -0,0 +1,247 @@
+#include "TestSupport.h"
+#include "core/ImageProcessor.h"
+#include "core/PixelKernels.h"
+#include "core/TemplateMatcher.h"
+#include <algorithm>
+
+using TemplateMatcher::MatchMethod;
+
+namespace {
+
+// 原有实现的逐像素颜色差评分（calculateTemplateScore）
+double legacyScore(const QImage& source, const QImage& templ, int x, int y)
+{
+    double score = 0.0;
+    for (int ty = 0; ty < templ.height(); ++ty) {
+        for (int tx = 0; tx < templ.width(); ++tx) {
+            const QRgb s = source.pixel(x + tx, y + ty);
+            const QRgb t = templ.pixel(tx, ty);
+            const double rDiff = qAbs(qRed(s) - qRed(t)) / 255.0;
+            const double gDiff = qAbs(qGreen(s) - qGreen(t)) / 255.0;
+            const double bDiff = qAbs(qBlue(s) - qBlue(t)) / 255.0;
+            score += 1.0 - (rDiff + gDiff + bDiff) / 3.0;
+        }
+    }
+    return score / (templ.width() * templ.height());
+}
+
+// 原有实现的全图搜索：颜色差评分最高且扫描顺序最靠前的位置
+QPoint legacyArgmax(const QImage& source, const QImage& templ, double& bestScore)
+{
+    QPoint best;
+    bestScore = -1.0;
+    for (int y = 0; y <= source.height() - templ.height(); ++y) {
+        for (int x = 0; x <= source.width() - templ.width(); ++x) {
+            const double score = legacyScore(source, templ, x, y);
+            if (score > bestScore) {
+                bestScore = score;
+                best = QPoint(x, y);
+            }
+        }
+    }
+    return best;
+}
+
+// ========== 精确匹配 ==========
+
+void testExactMatch()
+{
+    ImageProcessor processor;
+    const QImage scene = TestSupport::makeTexture(320, 200, 3);
+    const QRect placements[] = {QRect(10, 20, 32, 24), QRect(0, 0, 16, 16), QRect(100, 60, 64, 64),
+                                QRect(281, 171, 39, 29)};
+
+    for (const QRect& placement : placements) {
+        const QImage templ = scene.copy(placement);
+        for (int levels : {0, 2}) {
+            ImageProcessor::TemplateMatchOptions options;
+            options.pyramidLevels = levels;
+            QPoint location;
+            double confidence = 0.0;
+            CHECK(processor.templateMatch(scene, templ, location, confidence, options) ==
+                  ImageProcessor::ProcessResult::Success);
+            CHECK(location == placement.topLeft());
+            CHECK_NEAR(confidence, 1.0, 1e-12);
+        }
+    }
+}
+
+// ========== 与原有颜色差搜索一致 ==========
+
+void testLegacyArgmax()
+{
+    // 模板取自(120,90)，原位置叠加噪声；扫描顺序更靠前处放两个干扰项：
+    // 亮度相同的灰色副本（灰度平面与模板完全相同）和对比度缩放的副本（相关系数不变）
+    QImage scene = TestSupport::makeTexture(200, 150, 9);
+    const QImage templ = scene.copy(120, 90, 24, 20);
+    TestSupport::Random random(7);
+    for (int y = 0; y < templ.height(); ++y) {
+        for (int x = 0; x < templ.width(); ++x) {
+            const QRgb pixel = templ.pixel(x, y);
+            const int noise = random.range(-12, 12);
+            scene.setPixel(120 + x, 90 + y, qRgb(qBound(0, qRed(pixel) + noise, 255),
+                                                 qBound(0, qGreen(pixel) - noise, 255),
+                                                 qBound(0, qBlue(pixel) + noise / 2, 255)));
+            const int gray = qGray(pixel);
+            scene.setPixel(20 + x, 10 + y, qRgb(gray, gray, gray));
+            scene.setPixel(60 + x, 40 + y, qRgb(qRed(pixel) * 3 / 4 + 30, qGreen(pixel) * 3 / 4 + 30,
+                                                qBlue(pixel) * 3 / 4 + 30));
+        }
+    }
+
+    double legacyConfidence = 0.0;
+    const QPoint legacyLocation = legacyArgmax(scene, templ, legacyConfidence);
+    CHECK(legacyLocation == QPoint(120, 90));
+
+    // 场景确实包含灰度度量无法区分的干扰项
+    const TemplateMatcher::PreparedSource source = TemplateMatcher::prepareSource(scene);
+    const TemplateMatcher::PreparedTemplate prepared = TemplateMatcher::prepareTemplate(templ);
+    CHECK(TemplateMatcher::findBestMatch(source, prepared).location != legacyLocation);
+
+    ImageProcessor processor;
+    for (int levels : {0, 1, 2}) {
+        for (MatchMethod method : {MatchMethod::CorrelationCoefficient, MatchMethod::SquaredDifference}) {
+            ImageProcessor::TemplateMatchOptions options;
+            options.pyramidLevels = levels;
+            options.method = method;
+            QPoint location;
+            double confidence = 0.0;
+            processor.templateMatch(scene, templ, location, confidence, options);
+            CHECK(location == legacyLocation);
+            CHECK_NEAR(confidence, legacyConfidence, 1e-9);
+        }
+    }
+}
+
+// ========== 计算方式一致性 ==========
+
+void testCorrelationBackendsAgree()
+{
+    const QImage scene = TestSupport::makeTexture(160, 120, 5);
+    const TemplateMatcher::PreparedSource source = TemplateMatcher::prepareSource(scene);
+    TemplateMatcher::MultiMatchParameters parameters;
+    parameters.candidateThreshold = 0.3;
+    parameters.minConfidence = 0.0;
+
+    // 奇数宽度的模板使最后一个像素对的高16位为0
+    for (const QRect& placement : {QRect(40, 30, 7, 5), QRect(12, 50, 33, 17)}) {
+        const TemplateMatcher::PreparedTemplate templ = TemplateMatcher::prepareTemplate(scene.copy(placement));
+
+        TemplateMatcher::setCorrelationBackend(TemplateMatcher::CorrelationBackend::Frequency);
+        const std::vector<TemplateMatcher::MatchCandidate> reference =
+            TemplateMatcher::findAllMatches(source, templ, parameters);
+        TemplateMatcher::setCorrelationBackend(TemplateMatcher::CorrelationBackend::Spatial);
+
+        for (PixelKernels::Backend backend : {PixelKernels::Backend::Scalar, PixelKernels::Backend::SSE41,
+                                              PixelKernels::Backend::AVX2}) {
+            if (!PixelKernels::setBackend(backend)) {
+                continue;
+            }
+            const std::vector<TemplateMatcher::MatchCandidate> matches =
+                TemplateMatcher::findAllMatches(source, templ, parameters);
+            CHECK(matches.size() == reference.size());
+            for (size_t i = 0; i < std::min(matches.size(), reference.size()); ++i) {
+                CHECK(matches[i].location == reference[i].location);
+                CHECK(matches[i].score == reference[i].score);
+            }
+
+            const TemplateMatcher::MatchCandidate best = TemplateMatcher::findBestMatch(source, templ);
+            CHECK(best.location == placement.topLeft());
+            CHECK(best.score == TemplateMatcher::scoreAt(source, templ, best.location.x(), best.location.y()));
+        }
+        PixelKernels::setBackend(PixelKernels::detectBackend());
+    }
+    TemplateMatcher::setCorrelationBackend(TemplateMatcher::CorrelationBackend::Automatic);
+}
+
+// 搜索范围高于一块频域变换时按条带分块，条带边界两侧的结果与空间域一致
+void testFrequencyBands()
+{
+    const QImage scene = TestSupport::makeTexture(1400, 1000, 21);
+    const TemplateMatcher::PreparedSource source = TemplateMatcher::prepareSource(scene);
+    const QRect placement(1100, 950, 45, 31);
+    const TemplateMatcher::PreparedTemplate templ = TemplateMatcher::prepareTemplate(scene.copy(placement));
+    TemplateMatcher::MultiMatchParameters parameters;
+    parameters.candidateThreshold = 0.5;
+    parameters.minConfidence = 0.0;
+
+    TemplateMatcher::setCorrelationBackend(TemplateMatcher::CorrelationBackend::Frequency);
+    CHECK(TemplateMatcher::usesFrequencyDomain(templ, TemplateMatcher::validPositions(source, templ)));
+    const std::vector<TemplateMatcher::MatchCandidate> frequencyMatches =
+        TemplateMatcher::findAllMatches(source, templ, parameters);
+    TemplateMatcher::setCorrelationBackend(TemplateMatcher::CorrelationBackend::Spatial);
+    const std::vector<TemplateMatcher::MatchCandidate> spatialMatches =
+        TemplateMatcher::findAllMatches(source, templ, parameters);
+    TemplateMatcher::setCorrelationBackend(TemplateMatcher::CorrelationBackend::Automatic);
+
+    CHECK(frequencyMatches.size() == spatialMatches.size());
+    CHECK(frequencyMatches.size() > 1);
+    CHECK(!frequencyMatches.empty() && frequencyMatches.front().location == placement.topLeft());
+    for (size_t i = 0; i < std::min(frequencyMatches.size(), spatialMatches.size()); ++i) {
+        CHECK(frequencyMatches[i].location == spatialMatches[i].location);
+        CHECK(frequencyMatches[i].score == spatialMatches[i].score);
+    }
+}
+
+// ========== 多目标搜索上限 ==========
+
+// 扫描顺序靠前的副本噪声更大：达到maxResults后仍须保留全图得分最高的结果
+void testFindAllMatchesBestN()
+{
+    QImage scene = TestSupport::makeTexture(240, 160, 11);
+    // 模板为纯随机噪声，与背景纹理的相关系数接近0
+    TestSupport::Random random(13);
+    QImage templ(20, 16, QImage::Format_ARGB32);
+    for (int y = 0; y < templ.height(); ++y) {
+        for (int x = 0; x < templ.width(); ++x) {
+            templ.setPixel(x, y, qRgb(random.range(0, 255), random.range(0, 255), random.range(0, 255)));
+        }
+    }
+    const QPoint placements[] = {QPoint(10, 5), QPoint(80, 30), QPoint(150, 70), QPoint(40, 110), QPoint(200, 130)};
+    int noise = 40;
+    for (const QPoint& placement : placements) {
+        for (int y = 0; y < templ.height(); ++y) {
+            for (int x = 0; x < templ.width(); ++x) {
+                const QRgb pixel = templ.pixel(x, y);
+                const int offset = random.range(-noise, noise);
+                scene.setPixel(placement.x() + x, placement.y() + y,
+                               qRgb(qBound(0, qRed(pixel) + offset, 255), qBound(0, qGreen(pixel) + offset, 255),
+                                    qBound(0, qBlue(pixel) + offset, 255)));
+            }
+        }
+        noise -= 10;
+    }
+
+    const TemplateMatcher::PreparedSource source = TemplateMatcher::prepareSource(scene);
+    const TemplateMatcher::PreparedTemplate prepared = TemplateMatcher::prepareTemplate(templ);
+    TemplateMatcher::MultiMatchParameters parameters;
+    parameters.candidateThreshold = 0.5;
+    parameters.minConfidence = 0.0;
+    const std::vector<TemplateMatcher::MatchCandidate> all =
+        TemplateMatcher::findAllMatches(source, prepared, parameters);
+    CHECK(all.size() == 5);
+
+    for (int limit : {1, 2, 4}) {
+        parameters.maxResults = limit;
+        const std::vector<TemplateMatcher::MatchCandidate> best =
+            TemplateMatcher::findAllMatches(source, prepared, parameters);
+        CHECK(best.size() == static_cast<size_t>(limit));
+        for (size_t i = 0; i < std::min(best.size(), all.size()); ++i) {
+            CHECK(best[i].location == all[i].location);
+            CHECK(best[i].score == all[i].score);
+        }
+    }
+    CHECK(all.front().location == placements[4]);
+}
+
+}
+
+int main()
+{
+    testExactMatch();
+    testLegacyArgmax();
+    testCorrelationBackendsAgree();
+    testFrequencyBands();
+    testFindAllMatchesBestN();
+    return TestSupport::finish("test_template_matcher");
+}